@@ -0,0 +1,1790 @@
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <glm.hpp>
+#include <gtc/matrix_transform.hpp>
+
+#include "ClusteredLights.h"
+#include "Image.h"
+#include "LightVolumes.h"
+#include "MaterialFeatures.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "TextureBaker.h"
+#include "ThreadPool.h"
+#include "VertexFormat.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h>
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+
+// vΏۂ̏iterationssčő̎(ms)Ԃ
+template <typename Func>
+double measureBestMilliseconds(int iterations, Func&& func)
+{
+	double best = 1e30;
+	for (int i = 0; i < iterations; i++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		const auto end = std::chrono::steady_clock::now();
+		best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+	}
+	return best;
+}
+
+template <typename T>
+bool isSameBytes(const std::vector<T>& a, const std::vector<T>& b)
+{
+	return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+
+// ##################
+// OBJ Loader
+// ##################
+
+// ȑOsplitStringx[XloadOBJ (rp)
+std::vector<std::string> splitString(const std::string& s, char delim)
+{
+	std::vector<std::string> elems(0);
+	std::stringstream ss;
+	ss.str(s);
+	std::string item;
+	while (std::getline(ss, item, delim)) {
+		elems.push_back(item);
+	}
+	return elems;
+}
+
+bool legacyLoadOBJ(std::string path, std::vector<glm::vec3>& outVertices, std::vector<glm::vec2>& outUVs, std::vector<glm::vec3>& outNormals, std::vector<glm::vec3>& outTangents)
+{
+	std::vector<unsigned int> vertexIndices, uvIndices, normalIndices;
+	std::vector<glm::vec3> tmpVertices;
+	std::vector<glm::vec2> tmpUVs;
+	std::vector<glm::vec3> tmpNormals;
+
+	std::ifstream ifs(path);
+	std::string line;
+	if (ifs.fail())
+	{
+		std::cerr << "Can't open obj file: " << path << std::endl;
+		return false;
+	}
+	while (getline(ifs, line))
+	{
+		auto col = splitString(line, ' ');
+
+		if (col[0] == "v")
+		{
+			tmpVertices.emplace_back(std::stof(col[1]), std::stof(col[2]), std::stof(col[3]));
+		}
+		else if (col[0] == "vt")
+		{
+			tmpUVs.emplace_back(std::stof(col[1]), std::stof(col[2]));
+		}
+		else if (col[0] == "vn")
+		{
+			tmpNormals.emplace_back(std::stof(col[1]), std::stof(col[2]), std::stof(col[3]));
+		}
+		else if (col[0] == "f")
+		{
+			auto v1 = splitString(col[1], '/');
+			auto v2 = splitString(col[2], '/');
+			auto v3 = splitString(col[3], '/');
+			vertexIndices.emplace_back(std::stoi(v1[0]));
+			vertexIndices.emplace_back(std::stoi(v2[0]));
+			vertexIndices.emplace_back(std::stoi(v3[0]));
+			uvIndices.emplace_back(std::stoi(v1[1]));
+			uvIndices.emplace_back(std::stoi(v2[1]));
+			uvIndices.emplace_back(std::stoi(v3[1]));
+			normalIndices.emplace_back(std::stoi(v1[2]));
+			normalIndices.emplace_back(std::stoi(v2[2]));
+			normalIndices.emplace_back(std::stoi(v3[2]));
+		}
+	}
+
+	for (unsigned int i = 0; i < vertexIndices.size(); i++)
+	{
+		unsigned int vertexIndex = vertexIndices[i];
+		outVertices.emplace_back(tmpVertices[vertexIndex - 1]);
+	}
+	for (unsigned int i = 0; i < uvIndices.size(); i++)
+	{
+		unsigned int uvIndex = uvIndices[i];
+		outUVs.emplace_back(tmpUVs[uvIndex - 1]);
+	}
+	for (unsigned int i = 0; i < normalIndices.size(); i++)
+	{
+		unsigned int normalIndex = normalIndices[i];
+		outNormals.emplace_back(tmpNormals[normalIndex - 1]);
+	}
+
+	for (int i = 0; i < outVertices.size(); i += 3)
+	{
+		auto& v0 = outVertices[i + 0];
+		auto& v1 = outVertices[i + 1];
+		auto& v2 = outVertices[i + 2];
+
+		auto& uv0 = outUVs[i + 0];
+		auto& uv1 = outUVs[i + 1];
+		auto& uv2 = outUVs[i + 2];
+
+		auto deltaPos1 = v1 - v0;
+		auto deltaPos2 = v2 - v0;
+
+		auto deltaUV1 = uv1 - uv0;
+		auto deltaUV2 = uv2 - uv0;
+
+		float r = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x);
+		auto tangent = (deltaPos1 * deltaUV2.y - deltaPos2 * deltaUV1.y) * r;
+
+		outTangents.emplace_back(tangent);
+		outTangents.emplace_back(tangent);
+		outTangents.emplace_back(tangent);
+	}
+
+	return true;
+}
+
+// OBJt@C̒gscale񕡐傫OBJt@C
+// ʂ̃CfbNX͕Ƃɂ炷
+bool generateScaledOBJ(const std::string& srcPath, const std::string& dstPath, int scale)
+{
+	std::ifstream ifs(srcPath);
+	if (ifs.fail())
+	{
+		std::cerr << "Can't open obj file: " << srcPath << std::endl;
+		return false;
+	}
+	std::vector<std::string> vertexLines;
+	std::vector<std::array<unsigned int, 9>> faces;
+	unsigned int vertexCount = 0, uvCount = 0, normalCount = 0;
+	std::string line;
+	while (std::getline(ifs, line))
+	{
+		if (line.rfind("v ", 0) == 0) vertexCount++;
+		else if (line.rfind("vt ", 0) == 0) uvCount++;
+		else if (line.rfind("vn ", 0) == 0) normalCount++;
+
+		if (line.rfind("v", 0) == 0)
+		{
+			vertexLines.push_back(line);
+		}
+		else if (line.rfind("f ", 0) == 0)
+		{
+			std::array<unsigned int, 9> f;
+			if (std::sscanf(line.c_str(), "f %u/%u/%u %u/%u/%u %u/%u/%u", &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], &f[6], &f[7], &f[8]) != 9)
+			{
+				std::cerr << "Unsupported face: " << line << std::endl;
+				return false;
+			}
+			faces.push_back(f);
+		}
+	}
+
+	std::ofstream ofs(dstPath, std::ios::binary);
+	if (ofs.fail())
+	{
+		std::cerr << "Can't create obj file: " << dstPath << std::endl;
+		return false;
+	}
+	for (int n = 0; n < scale; n++)
+	{
+		for (const auto& v : vertexLines)
+		{
+			ofs << v << '\n';
+		}
+		const unsigned int offsets[3] = { vertexCount * n, uvCount * n, normalCount * n };
+		for (const auto& f : faces)
+		{
+			ofs << "f";
+			for (int i = 0; i < 3; i++)
+			{
+				ofs << ' ' << f[i * 3 + 0] + offsets[0] << '/' << f[i * 3 + 1] + offsets[1] << '/' << f[i * 3 + 2] + offsets[2];
+			}
+			ofs << '\n';
+		}
+	}
+	return !ofs.fail();
+}
+
+bool benchmarkObjLoader()
+{
+	const std::string scaledPath = "testMonkey100x.obj";
+	if (!generateScaledOBJ("../PBR-Deferred-Shadow/testMonkey.obj", scaledPath, 100))
+	{
+		return false;
+	}
+
+	std::vector<glm::vec3> legacyVertices, vertices;
+	std::vector<glm::vec2> legacyUVs, uvs;
+	std::vector<glm::vec3> legacyNormals, normals;
+	std::vector<glm::vec3> legacyTangents, tangents;
+
+	const int iterations = 5;
+	bool ok = true;
+	const double legacyTime = measureBestMilliseconds(iterations, [&]() {
+		legacyVertices.clear(); legacyUVs.clear(); legacyNormals.clear(); legacyTangents.clear();
+		ok &= legacyLoadOBJ(scaledPath, legacyVertices, legacyUVs, legacyNormals, legacyTangents);
+	});
+	const double time = measureBestMilliseconds(iterations, [&]() {
+		vertices.clear(); uvs.clear(); normals.clear(); tangents.clear();
+		ok &= loadOBJ(scaledPath, vertices, uvs, normals, tangents);
+	});
+	if (!ok)
+	{
+		return false;
+	}
+
+	const bool identical = isSameBytes(legacyVertices, vertices) && isSameBytes(legacyUVs, uvs)
+		&& isSameBytes(legacyNormals, normals) && isSameBytes(legacyTangents, tangents);
+
+	std::cout << "[obj] testMonkey.obj x100 (" << vertices.size() << " vertices)" << std::endl;
+	std::cout << "  legacy loadOBJ    : " << legacyTime << " ms" << std::endl;
+	std::cout << "  streaming loadOBJ : " << time << " ms (x" << legacyTime / time << ")" << std::endl;
+	std::cout << "  output identical  : " << (identical ? "yes" : "NO") << std::endl;
+
+	std::remove(scaledPath.c_str());
+	return identical;
+}
+
+bool isSameObjData(const ObjData& a, const ObjData& b)
+{
+	return isSameBytes(a.vertices, b.vertices) && isSameBytes(a.uvs, b.uvs)
+		&& isSameBytes(a.normals, b.normals) && isSameBytes(a.indices, b.indices);
+}
+
+// Xbh1n[hEFAXbh܂ŕςparseOBJParallelv
+// RAȂłʂ̌؂ł悤Œ4Xbh܂ł͉
+bool benchmarkObjParallel()
+{
+	const unsigned int maxThreads = std::max(4u, std::thread::hardware_concurrency());
+	std::vector<unsigned int> threadCounts;
+	for (unsigned int t = 1; t < maxThreads; t *= 2)
+	{
+		threadCounts.push_back(t);
+	}
+	threadCounts.push_back(maxThreads);
+
+	bool ok = true;
+	for (const int scale : { 100, 400 })
+	{
+		const std::string scaledPath = "testMonkey" + std::to_string(scale) + "x.obj";
+		std::vector<char> buffer;
+		if (!generateScaledOBJ("../PBR-Deferred-Shadow/testMonkey.obj", scaledPath, scale) || !readFileToBuffer(scaledPath, buffer))
+		{
+			return false;
+		}
+		std::remove(scaledPath.c_str());
+
+		std::cout << "[obj-parallel] testMonkey.obj x" << scale << " (" << buffer.size() / (1024 * 1024) << " MB)" << std::endl;
+		ObjData serial;
+		double serialTime = 0.0;
+		for (const auto threadCount : threadCounts)
+		{
+			ObjData obj;
+			const double time = measureBestMilliseconds(5, [&]() {
+				obj = ObjData();
+				ok &= parseOBJParallel(buffer.data(), buffer.data() + buffer.size(), threadCount, obj);
+			});
+			if (threadCount == 1)
+			{
+				serial = std::move(obj);
+				serialTime = time;
+				std::cout << "  threads " << threadCount << " : " << time << " ms" << std::endl;
+				continue;
+			}
+			const bool identical = isSameObjData(serial, obj);
+			ok &= identical;
+			std::cout << "  threads " << threadCount << " : " << time << " ms (x" << serialTime / time << ")"
+				<< (identical ? "" : " output differs from serial parse!") << std::endl;
+		}
+	}
+	return ok;
+}
+
+// CfbNXɂ钸_ƃ̍팸
+bool benchmarkObjIndexed()
+{
+	for (const char* path : { "../PBR-Deferred-Shadow/testMonkey.obj", "../PBR-Deferred-Shadow/floor.obj" })
+	{
+		std::vector<glm::vec3> vertices, normals, tangents;
+		std::vector<glm::vec2> uvs;
+		ObjMesh mesh;
+		bool ok = true;
+		const double flatTime = measureBestMilliseconds(10, [&]() {
+			vertices.clear(); uvs.clear(); normals.clear(); tangents.clear();
+			ok &= loadOBJ(path, vertices, uvs, normals, tangents);
+		});
+		const double indexedTime = measureBestMilliseconds(10, [&]() {
+			mesh = ObjMesh();
+			ok &= loadOBJ(path, mesh);
+		});
+		if (!ok)
+		{
+			return false;
+		}
+
+		const size_t vertexSize = sizeof(glm::vec3) * 3 + sizeof(glm::vec2);
+		const size_t indexSize = mesh.vertices.size() <= 0xFFFF ? 2 : 4;
+		const size_t flatBytes = vertices.size() * vertexSize;
+		const size_t indexedBytes = mesh.vertices.size() * vertexSize + mesh.indices.size() * indexSize;
+		std::cout << "[obj-indexed] " << path << std::endl;
+		std::cout << "  vertices : " << vertices.size() << " -> " << mesh.vertices.size() << " (+ " << mesh.indices.size() << " x " << indexSize * 8 << "bit indices)" << std::endl;
+		std::cout << "  memory   : " << flatBytes << " bytes -> " << indexedBytes << " bytes (" << 100.0 * indexedBytes / flatBytes << "%)" << std::endl;
+		std::cout << "  load     : " << flatTime << " ms -> " << indexedTime << " ms" << std::endl;
+	}
+	return true;
+}
+
+// bVLbVꍇ(cold)Ƃꍇ(warm)̓ǂݍݎ
+// SXg[1񂸂ǂglBufferDataւ̃Abv[h̓ǂݏo܂߂
+bool benchmarkMeshCache()
+{
+	const std::string scaledPath = "testMonkey100x.obj";
+	if (!generateScaledOBJ("../PBR-Deferred-Shadow/testMonkey.obj", scaledPath, 100))
+	{
+		return false;
+	}
+
+	bool ok = true;
+	for (const std::string& path : { std::string("../PBR-Deferred-Shadow/testMonkey.obj"), scaledPath })
+	{
+		const std::string cachePath = path + ".meshcache";
+		uint64_t checksum = 0;
+		const auto touchStreams = [&](const MeshCache& cache) {
+			for (uint32_t stream = 0; stream < MeshStreamCount; stream++)
+			{
+				const auto data = static_cast<const char*>(cache.stream(static_cast<MeshStream>(stream)));
+				checksum += hashBytes(data, cache.streamSize(static_cast<MeshStream>(stream)));
+			}
+		};
+
+		bool hit = false;
+		const double coldTime = measureBestMilliseconds(3, [&]() {
+			std::remove(cachePath.c_str());
+			MeshCache cache;
+			ok &= loadOBJCached(path, cache, &hit) && !hit;
+			touchStreams(cache);
+		});
+		const double warmTime = measureBestMilliseconds(3, [&]() {
+			MeshCache cache;
+			ok &= loadOBJCached(path, cache, &hit) && hit;
+			touchStreams(cache);
+		});
+		std::remove(cachePath.c_str());
+
+		std::cout << "[mesh-cache] " << path << std::endl;
+		std::cout << "  cold (parse + write cache) : " << coldTime << " ms" << std::endl;
+		std::cout << "  warm (map cache)           : " << warmTime << " ms (x" << coldTime / warmTime << ")" << std::endl;
+	}
+	std::remove(scaledPath.c_str());
+	return ok;
+}
+
+
+
+// ##################
+// Vertex Format
+// ##################
+
+// k_tH[}bg1_̃oCgƗʎq덷
+bool benchmarkVertexFormat()
+{
+	for (const char* path : { "../PBR-Deferred-Shadow/testMonkey.obj", "../PBR-Deferred-Shadow/floor.obj" })
+	{
+		ObjMesh mesh;
+		if (!loadOBJ(path, mesh))
+		{
+			return false;
+		}
+
+		std::vector<char> buffer;
+		const double packTime = measureBestMilliseconds(10, [&]() {
+			buffer = serializeMeshCache(mesh, 0, 0, MeshPositionUnorm16);
+		});
+		const auto header = reinterpret_cast<const MeshCacheHeader*>(buffer.data());
+		const auto positions = reinterpret_cast<const QuantizedPosition*>(buffer.data() + header->streams[MeshStreamPositions].offset);
+		const auto attributes = reinterpret_cast<const PackedVertexAttributes*>(buffer.data() + header->streams[MeshStreamAttributes].offset);
+		const PositionQuantization quantization = computePositionQuantization(mesh.vertices);
+
+		float positionError = 0.0f, uvError = 0.0f, normalError = 0.0f, tangentError = 0.0f;
+		for (size_t i = 0; i < mesh.vertices.size(); i++)
+		{
+			positionError = std::max(positionError, glm::length(dequantizePosition(positions[i], quantization) - mesh.vertices[i]));
+			uvError = std::max(uvError, glm::length(glm::unpackHalf2x16(attributes[i].uv) - mesh.uvs[i]));
+
+			glm::vec3 normal, tangent;
+			float bitangentSign;
+			unpackTangentFrame(attributes[i].tangentFrame, normal, tangent, bitangentSign);
+			const glm::vec3 sourceNormal = glm::normalize(mesh.normals[i]);
+			// ڐ͖@ɒ̂Ɣׂ
+			const glm::vec3 tangentXYZ(mesh.tangents[i]);
+			const glm::vec3 sourceTangent = glm::normalize(tangentXYZ - sourceNormal * glm::dot(sourceNormal, tangentXYZ));
+			normalError = std::max(normalError, std::acos(std::min(1.0f, glm::dot(normal, sourceNormal))));
+			if (bitangentSign != mesh.tangents[i].w)
+			{
+				return false;
+			}
+			if (std::isfinite(sourceTangent.x))
+			{
+				tangentError = std::max(tangentError, std::acos(std::min(1.0f, glm::dot(tangent, sourceTangent))));
+			}
+		}
+
+		const size_t floatSize = sizeof(glm::vec3) * 3 + sizeof(glm::vec2);
+		const size_t packedSize = sizeof(QuantizedPosition) + sizeof(PackedVertexAttributes);
+		const glm::vec3 extent = quantization.scale;
+		std::cout << "[vertex-format] " << path << std::endl;
+		std::cout << "  geometry pass : " << floatSize << " -> " << packedSize << " bytes/vertex" << std::endl;
+		std::cout << "  shadow passes : " << floatSize << " -> " << sizeof(QuantizedPosition) << " bytes/vertex" << std::endl;
+		std::cout << "  max error     : position " << positionError << " (extent " << std::max({ extent.x, extent.y, extent.z }) << "), uv " << uvError
+			<< ", normal " << glm::degrees(normalError) << " deg, tangent " << glm::degrees(tangentError) << " deg" << std::endl;
+		std::cout << "  pack          : " << packTime << " ms for " << mesh.vertices.size() << " vertices" << std::endl;
+	}
+	return true;
+}
+
+
+
+// ##################
+// Mesh Optimizer
+// ##################
+
+// _LbVœKƃI[o[h[œK̑OACMR/ATVR/I[o[h[
+// œKACMR舫Ȃꍇ͎sƂ
+bool benchmarkVertexCache()
+{
+	bool ok = true;
+	for (const char* path : { "../PBR-Deferred-Shadow/testMonkey.obj", "../PBR-Deferred-Shadow/floor.obj" })
+	{
+		ObjMesh source;
+		if (!loadOBJ(path, source))
+		{
+			return false;
+		}
+
+		ObjMesh mesh;
+		const double optimizeTime = measureBestMilliseconds(10, [&]() {
+			mesh = source;
+			optimizeMesh(mesh);
+		});
+
+		ObjMesh cacheOnly = source;
+		optimizeVertexCache(cacheOnly.indices, cacheOnly.vertices.size());
+
+		const auto print = [&](const char* label, const ObjMesh& m) {
+			const auto cache16 = analyzeVertexCache(m.indices, m.vertices.size(), 16);
+			const auto cache32 = analyzeVertexCache(m.indices, m.vertices.size(), 32);
+			const auto overdraw = analyzeOverdraw(m.indices, m.vertices);
+			std::cout << "  " << label << " ACMR " << cache16.acmr << " / " << cache32.acmr
+				<< ", ATVR " << cache16.atvr << " / " << cache32.atvr
+				<< ", overdraw " << overdraw.overdraw << std::endl;
+		};
+		std::cout << "[vertex-cache] " << path << " (FIFO 16 / 32)" << std::endl;
+		print("original         :", source);
+		print("vertex cache     :", cacheOnly);
+		print("+ overdraw/fetch :", mesh);
+		std::cout << "  optimize         : " << optimizeTime << " ms for " << mesh.indices.size() / 3 << " triangles" << std::endl;
+
+		ok &= mesh.indices.size() == source.indices.size();
+		ok &= analyzeVertexCache(mesh.indices, mesh.vertices.size()).acmr <= analyzeVertexCache(source.indices, source.vertices.size()).acmr;
+	}
+	return ok;
+}
+
+
+
+// ##################
+// Tangent Space
+// ##################
+
+// MikkTSpace̎̂܂܏XJ[̎QƎ
+// eR[i[ (_, ) ̃^WFgԂ (UVkނʂ w = 0)
+std::vector<glm::vec4> referenceCornerTangents(const ObjMesh& mesh)
+{
+	const size_t triangleCount = mesh.indices.size() / 3;
+	std::vector<glm::vec3> sums(mesh.vertices.size() * 2, glm::vec3(0.0f));
+	std::vector<float> orientations(triangleCount, 0.0f);
+	const auto normalizeOrZero = [](const glm::vec3& v) {
+		const float length = glm::length(v);
+		return length > FLT_MIN ? v / length : v;
+	};
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		const unsigned int* index = &mesh.indices[t * 3];
+		const glm::vec3 d1 = mesh.vertices[index[1]] - mesh.vertices[index[0]];
+		const glm::vec3 d2 = mesh.vertices[index[2]] - mesh.vertices[index[0]];
+		const glm::vec2 t21 = mesh.uvs[index[1]] - mesh.uvs[index[0]];
+		const glm::vec2 t31 = mesh.uvs[index[2]] - mesh.uvs[index[0]];
+		const float area = t21.x * t31.y - t21.y * t31.x;
+		if (std::abs(area) <= FLT_MIN)
+		{
+			continue;
+		}
+		const float sign = area > 0.0f ? 1.0f : -1.0f;
+		const glm::vec3 os = normalizeOrZero(t31.y * d1 - t21.y * d2) * sign;
+		orientations[t] = sign;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			const glm::vec3 n = glm::normalize(mesh.normals[index[corner]]);
+			const glm::vec3 p = mesh.vertices[index[corner]];
+			const glm::vec3 v1 = normalizeOrZero(glm::vec3(mesh.vertices[index[(corner + 2) % 3]] - p) - n * glm::dot(n, mesh.vertices[index[(corner + 2) % 3]] - p));
+			const glm::vec3 v2 = normalizeOrZero(glm::vec3(mesh.vertices[index[(corner + 1) % 3]] - p) - n * glm::dot(n, mesh.vertices[index[(corner + 1) % 3]] - p));
+			const float angle = std::acos(std::clamp(glm::dot(v1, v2), -1.0f, 1.0f));
+			sums[index[corner] * 2 + (sign > 0.0f ? 0 : 1)] += normalizeOrZero(os - n * glm::dot(n, os)) * angle;
+		}
+	}
+
+	std::vector<glm::vec4> result(mesh.indices.size(), glm::vec4(0.0f));
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		if (orientations[t] == 0.0f)
+		{
+			continue;
+		}
+		for (int corner = 0; corner < 3; corner++)
+		{
+			const glm::vec3 sum = sums[mesh.indices[t * 3 + corner] * 2 + (orientations[t] > 0.0f ? 0 : 1)];
+			result[t * 3 + corner] = glm::vec4(normalizeOrZero(sum), orientations[t]);
+		}
+	}
+	return result;
+}
+
+// QƎƂ̍ASIMDƃXJ[̑xAUVkނʂłL̒lɂȂ邩
+bool benchmarkTangents()
+{
+	const std::string scaledPath = "testMonkey100x.obj";
+	if (!generateScaledOBJ("../PBR-Deferred-Shadow/testMonkey.obj", scaledPath, 100))
+	{
+		return false;
+	}
+
+	bool ok = true;
+	for (const std::string& path : { std::string("../PBR-Deferred-Shadow/testMonkey.obj"), scaledPath })
+	{
+		ObjMesh source;
+		if (!loadOBJ(path, source))
+		{
+			return false;
+		}
+		const auto reference = referenceCornerTangents(source);
+
+		ObjMesh mesh;
+		const auto generate = [&](bool useSimd) {
+			return measureBestMilliseconds(5, [&]() {
+				mesh.vertices = source.vertices;
+				mesh.uvs = source.uvs;
+				mesh.normals = source.normals;
+				mesh.indices = source.indices;
+				generateTangents(mesh.vertices, mesh.uvs, mesh.normals, mesh.indices, mesh.tangents, useSimd);
+			});
+		};
+		const double scalarTime = generate(false);
+		const double simdTime = generate(true);
+
+		float maxError = 0.0f, maxOrthogonality = 0.0f;
+		for (size_t i = 0; i < mesh.indices.size(); i++)
+		{
+			const glm::vec4 tangent = mesh.tangents[mesh.indices[i]];
+			const glm::vec3 normal = glm::normalize(mesh.normals[mesh.indices[i]]);
+			ok &= std::isfinite(tangent.x) && std::isfinite(tangent.y) && std::isfinite(tangent.z);
+			maxOrthogonality = std::max(maxOrthogonality, std::abs(glm::dot(glm::vec3(tangent), normal)));
+			if (reference[i].w != 0.0f)
+			{
+				ok &= tangent.w == reference[i].w;
+				maxError = std::max(maxError, glm::length(glm::vec3(tangent) - glm::vec3(reference[i])));
+			}
+		}
+		ok &= maxError < 1e-4f;
+
+		std::cout << "[tangents] " << path << " (" << mesh.indices.size() / 3 << " triangles)" << std::endl;
+		std::cout << "  vertices        : " << source.vertices.size() << " -> " << mesh.vertices.size() << " (split at mirrored UVs)" << std::endl;
+		std::cout << "  max |T - ref|   : " << maxError << ", max |dot(T, N)| : " << maxOrthogonality << std::endl;
+		std::cout << "  scalar          : " << scalarTime << " ms" << std::endl;
+		std::cout << "  SIMD            : " << simdTime << " ms (x" << scalarTime / simdTime << ")" << std::endl;
+	}
+	std::remove(scaledPath.c_str());
+
+	// UVkނOp` (1/r  inf ɂȂ) ܂ރbV
+	ObjMesh degenerate;
+	degenerate.vertices = { glm::vec3(0, 0, 0), glm::vec3(1, 0, 0), glm::vec3(0, 1, 0), glm::vec3(1, 1, 0) };
+	degenerate.uvs = { glm::vec2(0.5f), glm::vec2(0.5f), glm::vec2(0.5f), glm::vec2(1, 1) };
+	degenerate.normals = std::vector<glm::vec3>(4, glm::vec3(0, 0, 1));
+	degenerate.indices = { 0, 1, 2, 1, 3, 2 };
+	generateTangents(degenerate.vertices, degenerate.uvs, degenerate.normals, degenerate.indices, degenerate.tangents);
+	for (const auto& tangent : degenerate.tangents)
+	{
+		ok &= std::isfinite(tangent.x) && std::isfinite(tangent.y) && std::isfinite(tangent.z) && std::abs(glm::length(glm::vec3(tangent)) - 1.0f) < 1e-4f;
+	}
+	std::cout << "[tangents] degenerate UVs : " << (ok ? "finite" : "NOT finite") << std::endl;
+	return ok;
+}
+
+
+
+// ##################
+// Texture Loading
+// ##################
+
+// PBR-Deferred-ShadowƓ1024x1024 RGB̔񈳏kTGAcount
+std::vector<std::string> generateTestTextures(int count, int size = 1024)
+{
+	std::vector<std::string> paths;
+	std::vector<unsigned char> pixels(size_t(size) * size * 3);
+	stbi_write_tga_with_rle = 0;
+	for (int i = 0; i < count; i++)
+	{
+		for (int y = 0; y < size; y++)
+		{
+			for (int x = 0; x < size; x++)
+			{
+				unsigned char* p = &pixels[(size_t(y) * size + x) * 3];
+				p[0] = static_cast<unsigned char>(x + i * 16);
+				p[1] = static_cast<unsigned char>(y ^ x);
+				p[2] = static_cast<unsigned char>((x * y + i) >> 4);
+			}
+		}
+		const std::string path = "benchmarkTexture" + std::to_string(i) + ".tga";
+		if (!stbi_write_tga(path.c_str(), size, size, 3, pixels.data()))
+		{
+			return {};
+		}
+		paths.push_back(path);
+	}
+	return paths;
+}
+
+// 12̃eNX`ɃfR[hꍇƁAThreadPoolŃfR[hꍇ
+// CXbh҂鎞Ԃload()Ń^XNςނɂȂ
+bool benchmarkTextureDecode()
+{
+	const auto paths = generateTestTextures(12);
+	if (paths.empty())
+	{
+		return false;
+	}
+
+	bool ok = true;
+	// ǂfR[hʂ̓Abv[h܂ŕێĂ
+	const double sequentialTime = measureBestMilliseconds(3, [&]() {
+		std::vector<DecodedImage> images(paths.size());
+		for (size_t i = 0; i < paths.size(); i++)
+		{
+			ok &= decodeImage(paths[i], images[i]);
+		}
+	});
+
+	std::cout << "[texture-decode] " << paths.size() << " x 1024x1024 RGB TGA" << std::endl;
+	std::cout << "  sequential          : " << sequentialTime << " ms" << std::endl;
+	std::vector<unsigned int> threadCounts = { 1u, ThreadPool::defaultThreadCount(), std::max(1u, std::thread::hardware_concurrency()) };
+	threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+	for (const unsigned int threads : threadCounts)
+	{
+		ThreadPool pool(threads);
+		double enqueueTime = 0.0;
+		const double poolTime = measureBestMilliseconds(3, [&]() {
+			std::vector<DecodedImage> images(paths.size());
+			std::vector<char> results(paths.size(), 0);
+			const auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < paths.size(); i++)
+			{
+				pool.push([&, i]() { results[i] = decodeImage(paths[i], images[i]); });
+			}
+			enqueueTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			pool.wait();
+			for (const auto result : results)
+			{
+				ok &= result != 0;
+			}
+		});
+		std::cout << "  thread pool (" << threads << ")     : " << poolTime << " ms, main thread blocked " << enqueueTime << " ms" << std::endl;
+	}
+
+	for (const auto& path : paths)
+	{
+		std::remove(path.c_str());
+	}
+	return ok;
+}
+
+// BC1̃ubNRGBA8ɓWJ (掿̊mFp)
+void decodeBC1Block(const unsigned char* block, unsigned char* out)
+{
+	const uint16_t c0 = block[0] | block[1] << 8;
+	const uint16_t c1 = block[2] | block[3] << 8;
+	int palette[4][3];
+	const auto expand = [](uint16_t c, int* rgb) {
+		rgb[0] = ((c >> 11) & 31) * 255 / 31;
+		rgb[1] = ((c >> 5) & 63) * 255 / 63;
+		rgb[2] = (c & 31) * 255 / 31;
+	};
+	expand(c0, palette[0]);
+	expand(c1, palette[1]);
+	for (int i = 0; i < 3; i++)
+	{
+		if (c0 > c1)
+		{
+			palette[2][i] = (2 * palette[0][i] + palette[1][i]) / 3;
+			palette[3][i] = (palette[0][i] + 2 * palette[1][i]) / 3;
+		}
+		else
+		{
+			palette[2][i] = (palette[0][i] + palette[1][i]) / 2;
+			palette[3][i] = 0;
+		}
+	}
+	const uint32_t indices = block[4] | block[5] << 8 | block[6] << 16 | uint32_t(block[7]) << 24;
+	for (int i = 0; i < 16; i++)
+	{
+		const int index = (indices >> (i * 2)) & 3;
+		for (int c = 0; c < 3; c++)
+		{
+			out[i * 4 + c] = static_cast<unsigned char>(palette[index][c]);
+		}
+		out[i * 4 + 3] = 255;
+	}
+}
+
+void decodeBC4Block(const unsigned char* block, unsigned char* out)
+{
+	int palette[8] = { block[0], block[1] };
+	for (int i = 1; i < 7; i++)
+	{
+		if (block[0] > block[1])
+		{
+			palette[i + 1] = ((7 - i) * block[0] + i * block[1]) / 7;
+		}
+		else if (i < 5)
+		{
+			palette[i + 1] = ((5 - i) * block[0] + i * block[1]) / 5;
+		}
+	}
+	if (block[0] <= block[1])
+	{
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		indices |= uint64_t(block[2 + i]) << (i * 8);
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		out[i] = static_cast<unsigned char>(palette[(indices >> (i * 3)) & 7]);
+	}
+}
+
+void decodeBC5Block(const unsigned char* block, unsigned char* out)
+{
+	unsigned char red[16];
+	unsigned char green[16];
+	decodeBC4Block(block, red);
+	decodeBC4Block(block + 8, green);
+	for (int i = 0; i < 16; i++)
+	{
+		out[i * 2 + 0] = red[i];
+		out[i * 2 + 1] = green[i];
+	}
+}
+
+// ĂeNX`̃x0BakeImageƓтɓWJ
+BakeImage decodeBakedLevel0(const BakedTexture& baked, uint32_t components)
+{
+	const auto& level = baked.levels[0];
+	BakeImage out;
+	out.width = level.width;
+	out.height = level.height;
+	out.components = components;
+	out.pixels.resize(size_t(level.width) * level.height * components);
+	const uint32_t blocksX = (level.width + 3) / 4;
+	const uint32_t blocksY = (level.height + 3) / 4;
+	const size_t blockSize = bakedLevelSize(baked.format, 4, 4);
+	unsigned char decoded[64];
+	for (uint32_t by = 0; by < blocksY; by++)
+	{
+		for (uint32_t bx = 0; bx < blocksX; bx++)
+		{
+			const auto block = reinterpret_cast<const unsigned char*>(baked.level(0) + (size_t(by) * blocksX + bx) * blockSize);
+			switch (baked.format)
+			{
+			case BakedTextureBC4: decodeBC4Block(block, decoded); break;
+			case BakedTextureBC5: decodeBC5Block(block, decoded); break;
+			case BakedTextureBC3: decodeBC1Block(block + 8, decoded); break;
+			default: decodeBC1Block(block, decoded); break;
+			}
+			const uint32_t stride = baked.format == BakedTextureBC4 ? 1 : baked.format == BakedTextureBC5 ? 2 : 4;
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				const uint32_t x = bx * 4 + i % 4;
+				const uint32_t y = by * 4 + i / 4;
+				if (x < level.width && y < level.height)
+				{
+					std::memcpy(&out.pixels[(size_t(y) * level.width + x) * components], &decoded[i * stride], std::min(stride, components));
+				}
+			}
+		}
+	}
+	return out;
+}
+
+// channelPSNR߂BAt@͔rȂ
+double channelPSNR(const BakeImage& decoded, const BakeImage& reference, uint32_t channel)
+{
+	double squaredError = 0.0;
+	const size_t pixelCount = size_t(reference.width) * reference.height;
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const double d = double(decoded.pixels[i * decoded.components + channel]) - reference.pixels[i * reference.components + channel];
+		squaredError += d * d;
+	}
+	const double mse = squaredError / std::max<size_t>(1, pixelCount);
+	return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+// ĂeNX`̃x0WJČ̉摜ƂPSNR߂
+double bakedPSNR(const BakedTexture& baked, const BakeImage& reference)
+{
+	const BakeImage decoded = decodeBakedLevel0(baked, reference.components);
+	double psnr = 0.0;
+	const uint32_t channels = std::min(reference.components, 3u);
+	for (uint32_t c = 0; c < channels; c++)
+	{
+		psnr += channelPSNR(decoded, reference, c) / channels;
+	}
+	return psnr;
+}
+
+// eNX`BC1/BC4ɏĂԂƁAĂʂǂގԂTGÃfR[hƔׂ
+// RGBA8 (~bv}bv) Ƃ̔r
+bool benchmarkTextureBake()
+{
+	const auto paths = generateTestTextures(4);
+	if (paths.empty())
+	{
+		return false;
+	}
+
+	bool ok = true;
+	std::cout << "[texture-bake] " << paths.size() << " x 1024x1024 RGB TGA" << std::endl;
+	ThreadPool pool;
+	for (const TextureBakeKind kind : { TextureBakeColor, TextureBakeScalar })
+	{
+		const bool sRGB = kind == TextureBakeColor;
+		double sequentialTime = 0.0;
+		double poolTime = 0.0;
+		double decodeTime = 0.0;
+		double loadTime = 0.0;
+		double psnr = 0.0;
+		size_t bakedSize = 0;
+		size_t uncompressedSize = 0;
+		for (const auto& path : paths)
+		{
+			std::ifstream ifs(path, std::ios::binary);
+			const std::string source((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+			const uint64_t hash = hashBytes(source.data(), source.size());
+			DecodedImage image;
+			ok &= decodeImageFromMemory(source.data(), source.size(), image);
+
+			std::vector<char> sequential;
+			std::vector<char> parallel;
+			sequentialTime += measureBestMilliseconds(1, [&]() { sequential = bakeTexture(image, kind, sRGB, hash, source.size(), nullptr); });
+			poolTime += measureBestMilliseconds(1, [&]() { parallel = bakeTexture(image, kind, sRGB, hash, source.size(), &pool); });
+			ok &= sequential == parallel;
+
+			// 1ڂŏĂDDSoAȍ~̓}bv邾
+			BakedTexture baked;
+			ok &= loadBakedTexture(path, kind, sRGB, &pool, baked);
+			decodeTime += measureBestMilliseconds(3, [&]() {
+				DecodedImage decoded;
+				ok &= decodeImage(path, decoded);
+			});
+			loadTime += measureBestMilliseconds(3, [&]() {
+				BakedTexture cached;
+				bool cacheHit = false;
+				ok &= loadBakedTexture(path, kind, sRGB, nullptr, cached, &cacheHit) && cacheHit;
+				// }bvł̓y[Wǂ܂ĂȂ̂őSĐGĂ
+				volatile char sum = 0;
+				for (size_t i = 0; i < cached.size(); i += 4096)
+				{
+					sum += cached.data()[i];
+				}
+			});
+			bakedSize += baked.size();
+			uncompressedSize += baked.uncompressedSize();
+			psnr += bakedPSNR(baked, toBakeImage(image, kind, sRGB)) / paths.size();
+			std::remove((path + ".dds").c_str());
+		}
+		std::cout << "  " << (kind == TextureBakeColor ? "color -> BC1 (sRGB)" : "scalar -> BC4      ") << std::endl;
+		std::cout << "    bake (1 thread)     : " << sequentialTime << " ms" << std::endl;
+		std::cout << "    bake (pool " << pool.size() << " + main) : " << poolTime << " ms" << std::endl;
+		std::cout << "    TGA decode          : " << decodeTime << " ms" << std::endl;
+		std::cout << "    DDS load (hash+map) : " << loadTime << " ms" << std::endl;
+		std::cout << "    memory              : " << uncompressedSize / 1048576.0 << " MiB RGBA8 -> " << bakedSize / 1048576.0 << " MiB" << std::endl;
+		std::cout << "    PSNR (level 0)      : " << psnr << " dB" << std::endl;
+	}
+
+	for (const auto& path : paths)
+	{
+		std::remove(path.c_str());
+	}
+	return ok;
+}
+
+
+// func(x, y, c)Ŗ߂eXg摜 (stbỉ摜ƓmallocŊmۂ)
+template <typename Func>
+DecodedImage makeTestImage(int size, int channels, Func&& func)
+{
+	DecodedImage image;
+	image.width = size;
+	image.height = size;
+	image.channels = channels;
+	image.pixels.reset(static_cast<stbi_uc*>(std::malloc(image.size())));
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			for (int c = 0; c < channels; c++)
+			{
+				image.pixels.get()[(size_t(y) * size + x) * channels + c] = static_cast<stbi_uc>(func(x, y, c));
+			}
+		}
+	}
+	return image;
+}
+
+BakedTexture bakeInMemory(const BakeImage& image, TextureBakeKind kind, bool sRGB, ThreadPool& pool)
+{
+	BakedTexture baked;
+	baked.memory = bakeTexture(image, kind, sRGB, 0, 0, &pool);
+	readBakedTextureHeader(baked.memory.data(), baked.memory.size(), 0, 0, kind, sRGB, baked);
+	return baked;
+}
+
+// AOEtlXE^bNʁXBC4ɂꍇORM (BC1) 1ɋl߂ꍇA
+// @}bvRGBA8ɂꍇBC5 (XŶ) ɂꍇ̃ƌ덷
+bool benchmarkMaterialPack()
+{
+	const int size = 1024;
+	const float pi = 3.14159265358979f;
+	// AO͊炩ȉAAtlXׂ͍͗lA^bN0/1̃}XN
+	const auto ao = makeTestImage(size, 3, [&](int x, int y, int) {
+		return 255.0f * (0.6f + 0.4f * std::sin(x * 0.02f) * std::cos(y * 0.015f));
+	});
+	const auto roughness = makeTestImage(size, 3, [&](int x, int y, int) {
+		return 128.0f + 90.0f * std::sin(x * 0.3f + std::sin(y * 0.11f) * 4.0f) + ((x * 7 + y * 13) & 15);
+	});
+	const auto metallic = makeTestImage(size, 3, [&](int x, int y, int) {
+		return ((x / 96 + y / 128) & 1) ? 255 : 0;
+	});
+	//  h = A sin(fx) cos(fy) ̖@
+	const float frequency = 2.0f * pi / 64.0f;
+	const float amplitude = 12.0f;
+	const auto normalAt = [&](int x, int y) {
+		const float dx = amplitude * frequency * std::cos(x * frequency) * std::cos(y * frequency);
+		const float dy = -amplitude * frequency * std::sin(x * frequency) * std::sin(y * frequency);
+		return glm::normalize(glm::vec3(-dx, -dy, 1.0f));
+	};
+	const auto normal = makeTestImage(size, 3, [&](int x, int y, int c) {
+		return std::round((normalAt(x, y)[c] * 0.5f + 0.5f) * 255.0f);
+	});
+
+	bool ok = true;
+	ThreadPool pool;
+	std::cout << "[material-pack] " << size << "x" << size << " synthetic maps, geometry pass samples 6 -> 4" << std::endl;
+
+	const BakeImage scalarImages[3] = {
+		toBakeImage(ao, TextureBakeScalar, true),
+		toBakeImage(roughness, TextureBakeScalar, false),
+		toBakeImage(metallic, TextureBakeScalar, false),
+	};
+	const char* scalarNames[3] = { "ao       ", "roughness", "metallic " };
+	BakeImage ormImage;
+	ok &= packORMImage(ao, roughness, metallic, true, ormImage);
+	const BakedTexture orm = bakeInMemory(ormImage, TextureBakeORM, true, pool);
+	const BakeImage ormDecoded = decodeBakedLevel0(orm, 4);
+	size_t separateSize = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		const BakedTexture scalar = bakeInMemory(scalarImages[i], TextureBakeScalar, i == 0, pool);
+		separateSize += scalar.size();
+		const double separatePSNR = channelPSNR(decodeBakedLevel0(scalar, 1), scalarImages[i], 0);
+		const double packedPSNR = channelPSNR(ormDecoded, ormImage, i);
+		std::cout << "  " << scalarNames[i] << " PSNR   : BC4 " << separatePSNR << " dB, ORM " << packedPSNR << " dB" << std::endl;
+	}
+	std::cout << "  scalar memory    : 3 x BC4 " << separateSize / 1048576.0 << " MiB -> ORM BC1 " << orm.size() / 1048576.0 << " MiB" << std::endl;
+	ok &= orm.format == BakedTextureBC1 && orm.size() * 3 == separateSize;
+
+	// @Z𕜌Ă猳̖@Ƃ̊px𑪂
+	BakeImage rgbaNormal = toBakeImage(normal, TextureBakeColor, false);
+	const BakedTexture bc5 = bakeInMemory(toBakeImage(normal, TextureBakeNormal, false), TextureBakeNormal, false, pool);
+	const BakeImage bc5Decoded = decodeBakedLevel0(bc5, 2);
+	double rgbaError = 0.0, rgbaMax = 0.0, bc5Error = 0.0, bc5Max = 0.0;
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			const glm::vec3 reference = normalAt(x, y);
+			const size_t i = size_t(y) * size + x;
+			const glm::vec3 fromRGBA = glm::normalize(glm::vec3(rgbaNormal.pixels[i * 4], rgbaNormal.pixels[i * 4 + 1], rgbaNormal.pixels[i * 4 + 2]) / 255.0f * 2.0f - 1.0f);
+			const glm::vec2 xy = glm::vec2(bc5Decoded.pixels[i * 2], bc5Decoded.pixels[i * 2 + 1]) / 255.0f * 2.0f - 1.0f;
+			const glm::vec3 fromBC5 = glm::normalize(glm::vec3(xy, std::sqrt(std::max(1.0f - glm::dot(xy, xy), 0.0f))));
+			const double a = std::acos(std::min(1.0f, glm::dot(reference, fromRGBA))) * 180.0 / pi;
+			const double b = std::acos(std::min(1.0f, glm::dot(reference, fromBC5))) * 180.0 / pi;
+			rgbaError += a;
+			bc5Error += b;
+			rgbaMax = std::max(rgbaMax, a);
+			bc5Max = std::max(bc5Max, b);
+		}
+	}
+	const double pixelCount = double(size) * size;
+	std::cout << "  normal error     : RGBA8 mean " << rgbaError / pixelCount << " deg (max " << rgbaMax << "), BC5 mean " << bc5Error / pixelCount << " deg (max " << bc5Max << ")" << std::endl;
+	std::cout << "  normal memory    : RGBA8 " << bc5.uncompressedSize() / 1048576.0 << " MiB -> BC5 " << bc5.size() / 1048576.0 << " MiB" << std::endl;
+	ok &= bc5.format == BakedTextureBC5;
+	return ok;
+}
+
+
+// ȑOTextureBakerƓA8bit̂܂2x2𕽋ς~bv}bv (sRGBK}Ԃŕς)
+std::vector<BakeImage> referenceBoxMips(const BakeImage& image)
+{
+	std::vector<BakeImage> levels = { image };
+	while (levels.back().width > 1 || levels.back().height > 1)
+	{
+		const BakeImage& src = levels.back();
+		BakeImage dst;
+		dst.width = std::max(1u, src.width / 2);
+		dst.height = std::max(1u, src.height / 2);
+		dst.components = src.components;
+		dst.pixels.resize(size_t(dst.width) * dst.height * dst.components);
+		const uint32_t c = src.components;
+		for (uint32_t y = 0; y < dst.height; y++)
+		{
+			const uint32_t y0 = std::min(y * 2, src.height - 1);
+			const uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+			for (uint32_t x = 0; x < dst.width; x++)
+			{
+				const uint32_t x0 = std::min(x * 2, src.width - 1);
+				const uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+				for (uint32_t i = 0; i < c; i++)
+				{
+					const int sum = src.pixels[(size_t(y0) * src.width + x0) * c + i] + src.pixels[(size_t(y0) * src.width + x1) * c + i]
+						+ src.pixels[(size_t(y1) * src.width + x0) * c + i] + src.pixels[(size_t(y1) * src.width + x1) * c + i];
+					dst.pixels[(size_t(y) * dst.width + x) * c + i] = static_cast<uint8_t>((sum + 2) / 4);
+				}
+			}
+		}
+		levels.push_back(std::move(dst));
+	}
+	return levels;
+}
+
+double alphaCoverage(const BakeImage& image, uint8_t cutoff)
+{
+	size_t covered = 0;
+	for (size_t i = 3; i < image.pixels.size(); i += 4)
+	{
+		covered += image.pixels[i] >= cutoff ? 1 : 0;
+	}
+	return double(covered) / (image.pixels.size() / 4);
+}
+
+// XJ[ESSEEAVX2̃J[lThreadPoolł̕񉻂̔r
+// sRGB̕ρAAt@̃JobWA@̒mF
+bool benchmarkMipmap()
+{
+	const int size = 2048;
+	// At@eXgŔt̂悤Ȗ͗l (ׂ0.5܂)
+	const auto albedo = makeTestImage(size, 4, [&](int x, int y, int c) {
+		if (c < 3)
+		{
+			return 40.0f + 200.0f * (0.5f + 0.5f * std::sin(x * 0.05f + c + std::cos(y * 0.03f) * 3.0f));
+		}
+		const float leaf = std::sin(x * 0.09f) * std::sin(y * 0.07f) + 0.35f * std::sin((x + y) * 0.31f);
+		return std::min(255.0f, std::max(0.0f, 128.0f + leaf * 300.0f));
+	});
+	const BakeImage image = toBakeImage(albedo, TextureBakeColor, true);
+
+	bool ok = true;
+	ThreadPool pool;
+	MipOptions options;
+	options.filter = MipFilterSRGB;
+	options.preserveAlphaCoverage = true;
+	std::cout << "[mipmap] " << size << "x" << size << " RGBA8 sRGB, alpha coverage preserved" << std::endl;
+
+	std::vector<BakeImage> reference;
+	const double boxTime = measureBestMilliseconds(3, [&]() { reference = referenceBoxMips(image); });
+	std::cout << "  8bit box (old)       : " << boxTime << " ms" << std::endl;
+
+	std::vector<std::pair<MipKernel, const char*>> kernels = { { MipKernelScalar, "scalar" } };
+#ifdef MIP_GENERATOR_SSE
+	kernels.push_back({ MipKernelSse, "SSE   " });
+#endif
+	if (bestMipKernel() == MipKernelAvx2)
+	{
+		kernels.push_back({ MipKernelAvx2, "AVX2  " });
+	}
+	std::vector<BakeImage> scalarLevels;
+	std::vector<BakeImage> levels;
+	for (const auto& kernel : kernels)
+	{
+		options.kernel = kernel.first;
+		for (const bool parallel : { false, true })
+		{
+			const double time = measureBestMilliseconds(3, [&]() { levels = generateMipChain(image, options, parallel ? &pool : nullptr); });
+			std::cout << "  " << kernel.second << (parallel ? " + pool" : "       ") << "        : " << time << " ms" << std::endl;
+			if (kernel.first == MipKernelScalar && !parallel)
+			{
+				scalarLevels = levels;
+			}
+			bool same = levels.size() == scalarLevels.size();
+			for (size_t i = 0; same && i < levels.size(); i++)
+			{
+				same = levels[i].pixels == scalarLevels[i].pixels;
+			}
+			ok &= same;
+		}
+	}
+	std::cout << "  identical to scalar  : " << (ok ? "yes" : "no") << std::endl;
+
+	std::cout << "  alpha coverage       : level0 " << alphaCoverage(image, 128) << std::endl;
+	for (size_t i = 2; i < levels.size() && levels[i].width >= 8; i += 2)
+	{
+		std::cout << "    level " << i << " (" << levels[i].width << ")  : box " << alphaCoverage(reference[i], 128) << ", preserved " << alphaCoverage(levels[i], 128) << std::endl;
+		ok &= std::abs(alphaCoverage(levels[i], 128) - alphaCoverage(image, 128)) < 0.02;
+	}
+
+	// ̎s͗l1iڂ͐`ŕς(sRGB)188AK}Ԃŕς128ɂȂ
+	BakeImage checker;
+	checker.width = 2;
+	checker.height = 2;
+	checker.components = 4;
+	checker.pixels = { 255, 255, 255, 255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255, 255 };
+	options.preserveAlphaCoverage = false;
+	const auto checkerLevels = generateMipChain(checker, options);
+	std::cout << "  sRGB checker level 1 : " << int(checkerLevels[1].pixels[0]) << " (8bit box " << int(referenceBoxMips(checker)[1].pixels[0]) << ")" << std::endl;
+	ok &= checkerLevels[1].pixels[0] == 188;
+
+	// @͕ςƒZȂBKꍇƔׂ
+	const auto normal = makeTestImage(512, 2, [&](int x, int y, int c) {
+		const float angle = (x + y) * 0.15f;
+		const float tilt = 0.8f;
+		const float v = c == 0 ? std::cos(angle) * tilt : std::sin(angle) * tilt;
+		return std::round((v * 0.5f + 0.5f) * 255.0f);
+	});
+	const BakeImage normalImage = toBakeImage(normal, TextureBakeNormal, false);
+	MipOptions normalOptions;
+	normalOptions.filter = MipFilterNormal;
+	const auto normalLevels = generateMipChain(normalImage, normalOptions, &pool);
+	const auto boxNormalLevels = referenceBoxMips(normalImage);
+	// XY̒1𒴂ĂȂZ𕜌łA̕ςقǌ̌XĂ
+	const auto meanXYLength = [](const BakeImage& level) {
+		double sum = 0.0;
+		for (size_t i = 0; i < level.pixels.size(); i += 2)
+		{
+			const double x = level.pixels[i] / 255.0 * 2.0 - 1.0;
+			const double y = level.pixels[i + 1] / 255.0 * 2.0 - 1.0;
+			sum += std::sqrt(x * x + y * y);
+		}
+		return sum / (level.pixels.size() / 2);
+	};
+	std::cout << "  normal |xy| level 3  : box " << meanXYLength(boxNormalLevels[3]) << ", renormalized " << meanXYLength(normalLevels[3]) << " (level0 " << meanXYLength(normalImage) << ")" << std::endl;
+	return ok;
+}
+
+// ##################
+// Disney BRDF Permutations
+// ##################
+
+// ZƂ̉ (VF[_ALUߐ̖ڈ)
+struct ShaderOpCounts
+{
+	size_t add = 0;
+	size_t mul = 0;
+	size_t div = 0;
+	size_t sqrt = 0;
+	size_t transcendental = 0; // pow, log
+	size_t select = 0;         // r, min, max, clamp
+
+	size_t total() const { return add + mul + div + sqrt + transcendental + select; }
+};
+
+ShaderOpCounts shaderOpCounts;
+
+// Z̉񐔂𐔂float
+struct CountedFloat
+{
+	float v;
+	CountedFloat(float v = 0.0f) : v(v) {}
+};
+
+CountedFloat operator+(CountedFloat a, CountedFloat b) { shaderOpCounts.add++; return a.v + b.v; }
+CountedFloat operator-(CountedFloat a, CountedFloat b) { shaderOpCounts.add++; return a.v - b.v; }
+CountedFloat operator*(CountedFloat a, CountedFloat b) { shaderOpCounts.mul++; return a.v * b.v; }
+CountedFloat operator/(CountedFloat a, CountedFloat b) { shaderOpCounts.div++; return a.v / b.v; }
+bool operator<(CountedFloat a, CountedFloat b) { shaderOpCounts.select++; return a.v < b.v; }
+bool operator>(CountedFloat a, CountedFloat b) { shaderOpCounts.select++; return a.v > b.v; }
+CountedFloat sqrt(CountedFloat a) { shaderOpCounts.sqrt++; return std::sqrt(a.v); }
+CountedFloat pow(CountedFloat a, CountedFloat b) { shaderOpCounts.transcendental++; return std::pow(a.v, b.v); }
+CountedFloat log(CountedFloat a) { shaderOpCounts.transcendental++; return std::log(a.v); }
+CountedFloat max(CountedFloat a, CountedFloat b) { shaderOpCounts.select++; return std::max(a.v, b.v); }
+CountedFloat clamp(CountedFloat a, CountedFloat lo, CountedFloat hi) { shaderOpCounts.select += 2; return std::min(std::max(a.v, lo.v), hi.v); }
+
+float max(float a, float b) { return std::max(a, b); }
+float clamp(float a, float lo, float hi) { return std::min(std::max(a, lo), hi); }
+
+// GLSLvec3̑ (Z̓XJ[̉ZƂĐ)
+template <typename T>
+struct BrdfVec3
+{
+	T x, y, z;
+};
+
+template <typename T> BrdfVec3<T> operator+(const BrdfVec3<T>& a, const BrdfVec3<T>& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+template <typename T> BrdfVec3<T> operator-(const BrdfVec3<T>& a, const BrdfVec3<T>& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+template <typename T> BrdfVec3<T> operator*(const BrdfVec3<T>& a, const BrdfVec3<T>& b) { return { a.x * b.x, a.y * b.y, a.z * b.z }; }
+template <typename T> BrdfVec3<T> operator*(const BrdfVec3<T>& a, T s) { return { a.x * s, a.y * s, a.z * s }; }
+template <typename T> BrdfVec3<T> operator*(T s, const BrdfVec3<T>& a) { return a * s; }
+template <typename T> BrdfVec3<T> operator/(const BrdfVec3<T>& a, T s) { return { a.x / s, a.y / s, a.z / s }; }
+template <typename T> T dot(const BrdfVec3<T>& a, const BrdfVec3<T>& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+template <typename T> T mix(T a, T b, T t) { return a + (b - a) * t; }
+template <typename T> BrdfVec3<T> mix(const BrdfVec3<T>& a, const BrdfVec3<T>& b, T t) { return { mix(a.x, b.x, t), mix(a.y, b.y, t), mix(a.z, b.z, t) }; }
+template <typename T> BrdfVec3<T> splat(T v) { return { v, v, v }; }
+
+// Shaders/DisneyBRDF.glslsʂ (Features̓VF[_BRDF_FEATURES)
+template <uint32_t Features, typename T>
+BrdfVec3<T> evaluateDisneyBRDF(const BrdfVec3<T>& L, const BrdfVec3<T>& V, const BrdfVec3<T>& N, const BrdfVec3<T>& H, const BrdfVec3<T>& X, const BrdfVec3<T>& Y,
+	const BrdfVec3<T>& baseColor, T metallic, T roughness, const DisneyMaterial& material)
+{
+	const T PI = 3.14159265358979323846f;
+	const T subsurface = material.subsurface, specular = material.specular, specularTint = material.specularTint, anisotropic = material.anisotropic;
+	const T sheen = material.sheen, sheenTint = material.sheenTint, clearcoat = material.clearcoat, clearcoatGloss = material.clearcoatGloss;
+	const T one = 1.0f;
+	const auto SchlickFresnel = [&](T cosTheta) { return pow(clamp(one - cosTheta, T(0.0f), one), T(5.0f)); };
+	const auto G_GGX = [&](T NdotV, T a) {
+		T a2 = a * a;
+		return one / (NdotV + sqrt(a2 + NdotV * NdotV - a2 * NdotV * NdotV));
+	};
+
+	T NdotL = dot(N, L);
+	T NdotV = dot(N, V);
+	if (NdotL < T(0.0f) || NdotV < T(0.0f)) return splat(T(0.0f));
+
+	T NdotH = dot(N, H);
+	T LdotH = dot(L, H);
+
+	BrdfVec3<T> C_tint = splat(one);
+	if constexpr ((Features & (MaterialFeatureSheen | MaterialFeatureSpecularTint)) != 0)
+	{
+		T luminance = T(0.3f) * baseColor.x + T(0.6f) * baseColor.y + T(0.1f) * baseColor.z;
+		C_tint = luminance > T(0.0f) ? baseColor / luminance : splat(one);
+	}
+	BrdfVec3<T> C_spec;
+	if constexpr ((Features & MaterialFeatureSpecularTint) != 0)
+	{
+		C_spec = mix(specular * T(0.08f) * mix(splat(one), C_tint, specularTint), baseColor, metallic);
+	}
+	else
+	{
+		C_spec = mix(splat(specular * T(0.08f)), baseColor, metallic);
+	}
+
+	T F_i = SchlickFresnel(NdotL);
+	T F_o = SchlickFresnel(NdotV);
+	T F_d90 = T(0.5f) + T(2.0f) * LdotH * LdotH * roughness;
+	T F_d = mix(one, F_d90, F_i) * mix(one, F_d90, F_o);
+	T diffuse = F_d;
+	if constexpr ((Features & MaterialFeatureSubsurface) != 0)
+	{
+		T F_ss90 = LdotH * LdotH * roughness;
+		T F_ss = mix(one, F_ss90, F_i) * mix(one, F_ss90, F_o);
+		T ss = T(1.25f) * (F_ss * (one / (NdotL + NdotV) - T(0.5f)) + T(0.5f));
+		diffuse = mix(F_d, ss, subsurface);
+	}
+
+	T FH = SchlickFresnel(LdotH);
+	BrdfVec3<T> BRDFdiffuse;
+	if constexpr ((Features & MaterialFeatureSheen) != 0)
+	{
+		BrdfVec3<T> C_sheen = mix(splat(one), C_tint, sheenTint);
+		BrdfVec3<T> F_sheen = FH * sheen * C_sheen;
+		BRDFdiffuse = ((one / PI) * diffuse * baseColor + F_sheen) * (one - metallic);
+	}
+	else
+	{
+		BRDFdiffuse = (one / PI) * diffuse * baseColor * (one - metallic);
+	}
+
+	T D_s, G_s;
+	if constexpr ((Features & MaterialFeatureAnisotropic) != 0)
+	{
+		const auto G_GGXaniso = [&](T NdotV, T VdotX, T VdotY, T ax, T ay) {
+			T tmp = VdotX * VdotX * ax * ax + VdotY * VdotY * ay * ay + NdotV * NdotV;
+			return one / (NdotV + sqrt(tmp));
+		};
+		T aspect = sqrt(one - anisotropic * T(0.9f));
+		T roughness2 = roughness * roughness;
+		T a_x = max(T(0.001f), roughness2 / aspect);
+		T a_y = max(T(0.001f), roughness2 * aspect);
+		T HdotX = dot(H, X), HdotY = dot(H, Y);
+		T tmp = (HdotX * HdotX) / (a_x * a_x) + (HdotY * HdotY) / (a_y * a_y) + NdotH * NdotH;
+		D_s = one / (PI * a_x * a_y * tmp * tmp);
+		G_s = G_GGXaniso(NdotL, dot(L, X), dot(L, Y), a_x, a_y) * G_GGXaniso(NdotV, dot(V, X), dot(V, Y), a_x, a_y);
+	}
+	else
+	{
+		T a = max(T(0.001f), roughness * roughness);
+		T a2 = a * a;
+		T tmp = one + (a2 - one) * NdotH * NdotH;
+		D_s = a2 / (PI * tmp * tmp);
+		G_s = G_GGX(NdotL, a) * G_GGX(NdotV, a);
+	}
+	BrdfVec3<T> F_s = mix(C_spec, splat(one), FH);
+	BrdfVec3<T> BRDFspecular = G_s * F_s * D_s;
+
+	if constexpr ((Features & MaterialFeatureClearcoat) != 0)
+	{
+		T a = mix(T(0.1f), T(0.001f), clearcoatGloss);
+		T a2 = a * a;
+		T D_r = (a2 - one) / (PI * log(a2) * (one + (a2 - one) * NdotH * NdotH));
+		T F_r = mix(T(0.04f), one, FH);
+		T G_r = G_GGX(NdotL, T(0.25f)) * G_GGX(NdotV, T(0.25f));
+		BrdfVec3<T> BRDFclearcoat = splat(T(0.25f) * clearcoat * G_r * F_r * D_r);
+		return BRDFdiffuse + BRDFspecular + BRDFclearcoat;
+	}
+	return BRDFdiffuse + BRDFspecular;
+}
+
+struct BrdfSample
+{
+	glm::vec3 L, V, N, H, X, Y, baseColor;
+	float metallic, roughness;
+};
+
+// L, V͖@̔AX, YNƒPʃxNg
+std::vector<BrdfSample> makeBrdfSamples(size_t count)
+{
+	std::vector<BrdfSample> samples(count);
+	uint32_t state = 12345;
+	const auto random = [&]() {
+		state = state * 1664525u + 1013904223u;
+		return (state >> 8) * (1.0f / 16777216.0f);
+	};
+	const auto hemisphere = [&](const glm::vec3& n) {
+		for (;;)
+		{
+			const glm::vec3 v(random() * 2 - 1, random() * 2 - 1, random() * 2 - 1);
+			const float length2 = glm::dot(v, v);
+			if (length2 > 0.01f && length2 <= 1.0f && glm::dot(v, n) > 0.05f * std::sqrt(length2))
+			{
+				return v / std::sqrt(length2);
+			}
+		}
+	};
+	for (auto& sample : samples)
+	{
+		sample.N = glm::normalize(glm::vec3(random() - 0.5f, 1.0f, random() - 0.5f));
+		sample.X = glm::normalize(glm::cross(sample.N, glm::vec3(0, 0, 1)));
+		sample.Y = glm::cross(sample.N, sample.X);
+		sample.L = hemisphere(sample.N);
+		sample.V = hemisphere(sample.N);
+		sample.H = glm::normalize(sample.L + sample.V);
+		sample.baseColor = glm::vec3(random(), random(), random());
+		sample.metallic = random();
+		sample.roughness = 0.05f + random() * 0.95f;
+	}
+	return samples;
+}
+
+template <uint32_t Features, typename T>
+BrdfVec3<T> evaluateDisneyBRDF(const BrdfSample& sample, const DisneyMaterial& material)
+{
+	const auto v = [](const glm::vec3& v) { return BrdfVec3<T>{ T(v.x), T(v.y), T(v.z) }; };
+	return evaluateDisneyBRDF<Features, T>(v(sample.L), v(sample.V), v(sample.N), v(sample.H), v(sample.X), v(sample.Y), v(sample.baseColor), T(sample.metallic), T(sample.roughness), material);
+}
+
+// 1̕]̉Z (NdotL, NdotṼTvȂ̂œrŕԂȂ)
+template <uint32_t Features>
+ShaderOpCounts countBrdfOps(const BrdfSample& sample, const DisneyMaterial& material)
+{
+	shaderOpCounts = ShaderOpCounts();
+	evaluateDisneyBRDF<Features, CountedFloat>(sample, material);
+	return shaderOpCounts;
+}
+
+template <uint32_t Features>
+void reportBrdfPermutation(const std::vector<BrdfSample>& samples, const DisneyMaterial& material, size_t fullTotal, std::vector<BrdfVec3<float>>& results)
+{
+	const ShaderOpCounts counts = countBrdfOps<Features>(samples[0], material);
+	results.resize(samples.size());
+	const double time = measureBestMilliseconds(5, [&]() {
+		for (size_t i = 0; i < samples.size(); i++)
+		{
+			results[i] = evaluateDisneyBRDF<Features, float>(samples[i], material);
+		}
+	});
+
+	char line[192];
+	std::snprintf(line, sizeof(line), "  %-52s %4u %5zu %5zu %5zu %5zu %5zu %5zu %6zu %5.0f%% %8.2f",
+		materialFeatureName(Features).c_str(), Features, counts.add, counts.mul, counts.div, counts.sqrt, counts.transcendental, counts.select, counts.total(),
+		100.0 * counts.total() / fullTotal, time * 1e6 / samples.size());
+	std::cout << line << std::endl;
+}
+
+template <uint32_t... Features>
+bool reportBrdfPermutations(std::integer_sequence<uint32_t, Features...>)
+{
+	const auto samples = makeBrdfSamples(1 << 16);
+	const DisneyMaterial material;
+	const size_t fullTotal = countBrdfOps<MaterialFeatureAll>(samples[0], material).total();
+
+	std::cout << "  permutation                                          mask   add   mul   div  sqrt   pow   sel  total  ratio  ns/eval" << std::endl;
+	std::vector<BrdfVec3<float>> full, permutation;
+	reportBrdfPermutation<MaterialFeatureAll>(samples, material, fullTotal, full);
+	(reportBrdfPermutation<Features>(samples, material, fullTotal, permutation), ...);
+
+	// ̃}eA͑SĂ̋@\0Ȃ̂ŁA{̔ (GGX + BurleẙgU) ƑS@\ł͓ʂɂȂ͂
+	reportBrdfPermutation<0>(samples, material, fullTotal, permutation);
+	double maxError = 0.0;
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		const float scale = std::max({ 1e-3f, full[i].x, full[i].y, full[i].z });
+		const float error = std::max({ std::abs(full[i].x - permutation[i].x), std::abs(full[i].y - permutation[i].y), std::abs(full[i].z - permutation[i].z) });
+		maxError = std::max<double>(maxError, error / scale);
+	}
+	// eƈٕ̎a^2Ŋ̂float̊ۂߌ덷o
+	std::cout << "  base vs all with default material: max relative error " << maxError << std::endl;
+	return maxError < 1e-2;
+}
+
+// BRDF_FEATURES̃p[~e[VƂ̉Z (GLSLʂC++Ő) CPUł̕]
+bool benchmarkBrdfPermutations()
+{
+	std::cout << "[brdf-permutations] Disney BRDF op counts per BRDF_FEATURES permutation" << std::endl;
+	return reportBrdfPermutations(std::integer_sequence<uint32_t,
+		MaterialFeatureSubsurface, MaterialFeatureSheen, MaterialFeatureClearcoat, MaterialFeatureAnisotropic, MaterialFeatureSpecularTint,
+		MaterialFeatureSheen | MaterialFeatureSpecularTint, MaterialFeatureClearcoat | MaterialFeatureAnisotropic>());
+}
+
+// ##################
+// Clustered Light Assignment
+// ##################
+
+// XJ[AVX2̃J[lAThreadPoolł̃XCX̕񉻂̔r
+// Cg̋Ɋ܂܂_̃NX^ɂ́AK̃CgĂ邱ƂmF
+bool benchmarkClusterLights()
+{
+	const uint32_t countX = 16, countY = 12, countZ = 24;
+	const float width = 640.0f, height = 480.0f, nearPlane = 1.0f, farPlane = 50.0f;
+	const glm::mat4 Projection = glm::perspective(glm::radians(45.0f), width / height, nearPlane, farPlane);
+	const size_t lightCount = 10000;
+
+	// ̎ɂ΂܂r[Ԃ̋E
+	uint32_t seed = 1;
+	const auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / float(1 << 24);
+	};
+	std::vector<glm::vec4> spheres(lightCount);
+	for (auto& sphere : spheres)
+	{
+		const float distance = nearPlane + random() * (farPlane - nearPlane);
+		sphere = glm::vec4((random() * 2.0f - 1.0f) * distance * 0.6f, (random() * 2.0f - 1.0f) * distance * 0.45f, -distance, 0.5f + random() * 3.0f);
+	}
+
+	bool ok = true;
+	ThreadPool pool;
+	ClusteredLights clusters(countX, countY, countZ);
+	clusters.setProjection(Projection, nearPlane, farPlane, width, height);
+	std::cout << "[cluster-lights] " << lightCount << " lights, " << countX << "x" << countY << "x" << countZ << " clusters" << std::endl;
+
+	std::vector<std::pair<ClusterKernel, const char*>> kernels = { { ClusterKernelScalar, "scalar" } };
+	if (bestClusterKernel() == ClusterKernelAvx2)
+	{
+		kernels.push_back({ ClusterKernelAvx2, "AVX2  " });
+	}
+	// XCX̕񉻂Ōʂ͕ςȂ
+	// J[lḿARpCXJ[ł̐ϘaFMAɂ܂Ƃ߂ƋEɂ傤ǐڂ郉Cgς邱Ƃ
+	std::vector<uint32_t> scalarIndices;
+	for (const auto& kernel : kernels)
+	{
+		std::vector<uint32_t> serialIndices;
+		std::vector<uint32_t> serialCounts;
+		for (const bool parallel : { false, true })
+		{
+			const double time = measureBestMilliseconds(10, [&]() { clusters.assign(spheres, parallel ? &pool : nullptr, kernel.first); });
+			std::cout << "  " << kernel.second << (parallel ? " + pool" : "       ") << "        : " << time << " ms" << std::endl;
+			std::vector<uint32_t> counts;
+			for (const auto& cluster : clusters.clusters())
+			{
+				counts.push_back(cluster.count);
+			}
+			if (!parallel)
+			{
+				serialIndices = clusters.indices();
+				serialCounts = counts;
+			}
+			ok &= clusters.indices() == serialIndices && counts == serialCounts;
+		}
+		if (kernel.first == ClusterKernelScalar)
+		{
+			scalarIndices = serialIndices;
+		}
+	}
+	std::cout << "  pool == serial       : " << (ok ? "yes" : "no") << std::endl;
+	std::cout << "  same as scalar       : " << (clusters.indices() == scalarIndices ? "yes" : "no") << std::endl;
+
+	uint32_t maxCount = 0;
+	for (const auto& cluster : clusters.clusters())
+	{
+		maxCount = std::max(maxCount, cluster.count);
+	}
+	std::cout << "  light indices        : " << clusters.indices().size() << " (" << double(clusters.indices().size()) / clusters.clusters().size()
+		<< " per cluster, max " << maxCount << ")" << std::endl;
+
+	// ̒̓_Shaders/ClusteredLights.glslClusterIndex()ƓŃNX^Ɋ蓖Ă
+	const ClusterGridHeader& header = clusters.header();
+	size_t missing = 0;
+	const int samples = 20000;
+	for (int i = 0; i < samples; i++)
+	{
+		const glm::vec2 ndc(random() * 2.0f - 1.0f, random() * 2.0f - 1.0f);
+		const float distance = nearPlane + random() * (farPlane - nearPlane);
+		const glm::vec3 point(ndc.x * distance / Projection[0][0], ndc.y * distance / Projection[1][1], -distance);
+		const glm::vec2 fragCoord = (ndc * 0.5f + 0.5f) * glm::vec2(width, height);
+		const uint32_t x = std::min(static_cast<uint32_t>(fragCoord.x * header.clusterParams.x), countX - 1);
+		const uint32_t y = std::min(static_cast<uint32_t>(fragCoord.y * header.clusterParams.y), countY - 1);
+		const uint32_t z = std::min(static_cast<uint32_t>(std::log(distance / header.clusterParams.w) * header.clusterParams.z), countZ - 1);
+		const ClusterRange& cluster = clusters.clusters()[clusters.clusterIndex(x, y, z)];
+		const auto begin = clusters.indices().begin() + cluster.offset;
+		const auto end = begin + cluster.count;
+		for (uint32_t light = 0; light < lightCount; light++)
+		{
+			const glm::vec3 d = point - glm::vec3(spheres[light]);
+			if (glm::dot(d, d) <= spheres[light].w * spheres[light].w && std::find(begin, end, light) == end)
+			{
+				missing++;
+			}
+		}
+	}
+	std::cout << "  lights missing       : " << missing << " (" << samples << " points in the frustum)" << std::endl;
+	ok &= missing == 0;
+	return ok;
+}
+
+// ##################
+// Spot Light Volumes
+// ##################
+
+// ʂȃbV (ʂ͊O) ƃC (t >= 0) 邩
+bool rayHitsConvexMesh(const VolumeMesh& mesh, const glm::mat4& Model, const glm::vec3& origin, const glm::vec3& direction)
+{
+	float tNear = 0.0f;
+	float tFar = FLT_MAX;
+	for (size_t i = 0; i < mesh.indices.size(); i += 3)
+	{
+		const glm::vec3 p0 = glm::vec3(Model * glm::vec4(mesh.vertices[mesh.indices[i + 0]], 1.0f));
+		const glm::vec3 p1 = glm::vec3(Model * glm::vec4(mesh.vertices[mesh.indices[i + 1]], 1.0f));
+		const glm::vec3 p2 = glm::vec3(Model * glm::vec4(mesh.vertices[mesh.indices[i + 2]], 1.0f));
+		const glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		const float denominator = glm::dot(normal, direction);
+		const float numerator = glm::dot(normal, p0 - origin);
+		if (denominator > 0.0f)
+		{
+			tFar = std::min(tFar, numerator / denominator);
+		}
+		else if (denominator < 0.0f)
+		{
+			tNear = std::max(tNear, numerator / denominator);
+		}
+		else if (numerator < 0.0f)
+		{
+			return false;
+		}
+	}
+	return tNear <= tFar;
+}
+
+// ~̃bVOŃX|bgCg͈̔͂܂ނƁAʂ̋`bV̉f܂ނƂ̊mF
+// main.cpp̃X|bgCgŁAƉ~̃{[f (ʂ`Ƃ̃tOg) ̐̔r
+bool benchmarkLightVolumes()
+{
+	const int width = 640, height = 480;
+	const glm::vec3 cameraPos(0.0f, 10.0f, 10.0f);
+	const glm::mat4 View = glm::lookAt(cameraPos, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	const glm::mat4 Projection = glm::perspective(glm::radians(45.0f), static_cast<float>(width) / height, 1.0f, 50.0f);
+	const glm::mat4 ViewProjectionI = glm::inverse(Projection * View);
+	const VolumeMesh cone = createConeMesh(16);
+	bool ok = true;
+
+	// ʂOĂ邩 (ʂȂ̂Œ̓_ʂ܂ł̌Ɩ@)
+	const glm::vec3 inside(0.0f, 0.0f, 0.5f);
+	for (size_t i = 0; i < cone.indices.size(); i += 3)
+	{
+		const glm::vec3& p0 = cone.vertices[cone.indices[i + 0]];
+		const glm::vec3& p1 = cone.vertices[cone.indices[i + 1]];
+		const glm::vec3& p2 = cone.vertices[cone.indices[i + 2]];
+		ok &= glm::dot(glm::cross(p1 - p0, p2 - p0), (p0 + p1 + p2) / 3.0f - inside) > 0.0f;
+	}
+	std::cout << "[light-volumes] cone: " << cone.vertices.size() << " vertices, " << cone.indices.size() / 3 << " triangles, faces outward: " << (ok ? "yes" : "no") << std::endl;
+
+	// ͈͂ƊO̊px̒̓_A~̒ɂ邩
+	uint32_t seed = 1;
+	const auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / float(1 << 24);
+	};
+	size_t outside = 0;
+	const int lightSamples = 1000;
+	std::vector<glm::mat4> models;
+	for (int i = 0; i < lightSamples; i++)
+	{
+		const glm::vec3 position((random() * 2.0f - 1.0f) * 10.0f, random() * 8.0f, (random() * 2.0f - 1.0f) * 10.0f);
+		const glm::vec3 direction = glm::normalize(glm::vec3(random() * 2.0f - 1.0f, random() * 2.0f - 1.0f, random() * 2.0f - 1.0f) + glm::vec3(0.0f, -0.5f, 0.0f));
+		const float range = 2.0f + random() * 20.0f;
+		const float cosOuterAngle = std::cos(glm::radians(5.0f + random() * 55.0f));
+		const glm::mat4 Model = coneVolumeModel(position, direction, range, cosOuterAngle);
+		models.push_back(Model);
+		const glm::mat4 ModelI = glm::inverse(Model);
+		for (int j = 0; j < 100; j++)
+		{
+			// ~̒̓_ (Ǝ̊pxlɑI)
+			const float distance = random() * range;
+			const float cosAngle = 1.0f - random() * (1.0f - cosOuterAngle);
+			const float sinAngle = std::sqrt(1.0f - cosAngle * cosAngle);
+			const float azimuth = random() * 6.283185f;
+			const glm::mat3 basis = coneBasis(direction);
+			const glm::vec3 point = position + basis * (distance * glm::vec3(sinAngle * std::cos(azimuth), sinAngle * std::sin(azimuth), cosAngle));
+			const glm::vec3 local = glm::vec3(ModelI * glm::vec4(point, 1.0f));
+			if (local.z > 1.0f + 1e-4f || glm::length(glm::vec2(local)) > local.z + 1e-4f)
+			{
+				outside++;
+			}
+		}
+	}
+	std::cout << "  points outside cone  : " << outside << " (" << lightSamples * 100 << " points in " << lightSamples << " spot lights)" << std::endl;
+	ok &= outside == 0;
+
+	// ʂ̋`̌ς̎
+	ScreenRect rect = {};
+	const double boundsTime = measureBestMilliseconds(10, [&]() {
+		for (const auto& Model : models)
+		{
+			screenBounds(cone.vertices, Projection * View * Model, width, height, rect);
+		}
+	});
+	std::cout << "  screenBounds         : " << boundsTime / lightSamples * 1000.0 << " us per light" << std::endl;
+
+	// main.cpp̃X|bgCg (͈͂̓Cg{[Ɠ0.1L)
+	const glm::vec3 spotLightPosition(4.0f, 8.0f, 4.0f);
+	const glm::vec3 spotLightDirection = glm::normalize(glm::vec3(-1.0f, -1.0f, -1.0f));
+	const float spotLightRange = 30.0f + 0.1f;
+	const float cosOuterAngle = std::cos(glm::radians(45.0f) / 2.0f);
+	const glm::mat4 Model = coneVolumeModel(spotLightPosition, spotLightDirection, spotLightRange, cosOuterAngle);
+	const bool bounded = screenBounds(cone.vertices, Projection * View * Model, width, height, rect);
+
+	size_t spherePixels = 0;
+	size_t conePixels = 0;
+	size_t conePixelsOutsideRect = 0;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const glm::vec2 ndc((x + 0.5f) / width * 2.0f - 1.0f, (y + 0.5f) / height * 2.0f - 1.0f);
+			const glm::vec4 farPoint = ViewProjectionI * glm::vec4(ndc, 1.0f, 1.0f);
+			const glm::vec3 direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - cameraPos);
+			// : S烌C܂ł̋aȉŁA_JOɂ
+			const glm::vec3 toCenter = spotLightPosition - cameraPos;
+			const float t = glm::dot(toCenter, direction);
+			const float distanceSq = glm::dot(toCenter, toCenter) - t * t;
+			const float halfChord = std::sqrt(std::max(0.0f, spotLightRange * spotLightRange - distanceSq));
+			if (distanceSq <= spotLightRange * spotLightRange && t + halfChord >= 0.0f)
+			{
+				spherePixels++;
+			}
+			if (rayHitsConvexMesh(cone, Model, cameraPos, direction))
+			{
+				conePixels++;
+				if (bounded && (x < rect.x || x >= rect.x + rect.width || y < rect.y || y >= rect.y + rect.height))
+				{
+					conePixelsOutsideRect++;
+				}
+			}
+		}
+	}
+	std::cout << "  scene spot light     : sphere " << spherePixels << " px, cone " << conePixels << " px (" << 100.0 * conePixels / std::max<size_t>(spherePixels, 1) << "%)" << std::endl;
+	std::cout << "  solid angle ratio    : " << 100.0 * (1.0 - cosOuterAngle) / 2.0 << "% of the sphere" << std::endl;
+	if (bounded)
+	{
+		std::cout << "  scissor              : " << rect.width << "x" << rect.height << " at (" << rect.x << ", " << rect.y << "), " << conePixelsOutsideRect << " cone px outside" << std::endl;
+	}
+	else
+	{
+		std::cout << "  scissor              : full screen (cone crosses the camera plane)" << std::endl;
+	}
+	ok &= conePixelsOutsideRect == 0;
+	return ok;
+}
+
+
+struct Benchmark
+{
+	const char* name;
+	bool (*run)();
+};
+
+const Benchmark benchmarks[] = {
+	{ "obj", benchmarkObjLoader },
+	{ "obj-parallel", benchmarkObjParallel },
+	{ "obj-indexed", benchmarkObjIndexed },
+	{ "mesh-cache", benchmarkMeshCache },
+	{ "vertex-format", benchmarkVertexFormat },
+	{ "vertex-cache", benchmarkVertexCache },
+	{ "tangents", benchmarkTangents },
+	{ "texture-decode", benchmarkTextureDecode },
+	{ "texture-bake", benchmarkTextureBake },
+	{ "material-pack", benchmarkMaterialPack },
+	{ "mipmap", benchmarkMipmap },
+	{ "brdf-permutations", benchmarkBrdfPermutations },
+	{ "cluster-lights", benchmarkClusterLights },
+	{ "light-volumes", benchmarkLightVolumes },
+};
+
+// ȂȂSẴx`}[NsAΖOv̂s
+int main(int argc, char* argv[])
+{
+	bool ok = true;
+	for (const auto& benchmark : benchmarks)
+	{
+		bool selected = argc < 2;
+		for (int i = 1; i < argc; i++)
+		{
+			selected |= std::strcmp(argv[i], benchmark.name) == 0;
+		}
+		if (selected)
+		{
+			ok &= benchmark.run();
+		}
+	}
+	return ok ? 0 : 1;
+}
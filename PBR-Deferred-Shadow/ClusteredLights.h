@@ -0,0 +1,330 @@
+#pragma once
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <glm.hpp>
+
+#include "CpuFeatures.h"
+#include "ThreadPool.h"
+
+#if defined(CPU_FEATURES_AVX2)
+#define CLUSTERED_LIGHTS_AVX2 1
+#endif
+
+// NX^[hVF[fBÕCg̊蓖ĂCPUōs
+// r[Ԃʂ̃^CƎwIɕ[x̃XCX3Obh (NX^) ɕA
+// NX^AABBƌ郉Cg̔ԍNX^Ƃɋl߂ĕׂ
+// ʂShaders/ClusteredLights.glsl2SSBO (NX^Ƃ(offset, count)ƃCgԍ̔z) ɂ̂܂܏
+// Cg̓XCXAsANX^̏AABBōi荞݁AXCXƂThreadPoolŕɏ
+
+enum ClusterKernel
+{
+	ClusterKernelScalar,
+	ClusterKernelAvx2,
+};
+
+inline ClusterKernel bestClusterKernel()
+{
+	static const ClusterKernel kernel = cpuSupportsAvx2() ? ClusterKernelAvx2 : ClusterKernelScalar;
+	return kernel;
+}
+
+// Shaders/ClusteredLights.glslClusterGrid̐擪 (std430)
+struct ClusterGridHeader
+{
+	glm::uvec4 clusterCount; // xyz: NX^̐
+	glm::vec4 clusterParams; // x: countX / width, y: countY / height, z: countZ / log(far / near), w: near
+};
+static_assert(sizeof(ClusterGridHeader) == 32, "std430 layout mismatch");
+
+// ClusterGridclusterLights[]̗vf
+struct ClusterRange
+{
+	uint32_t offset;
+	uint32_t count;
+};
+static_assert(sizeof(ClusterRange) == 8, "std430 layout mismatch");
+
+class ClusteredLights
+{
+public:
+	ClusteredLights(uint32_t countX, uint32_t countY, uint32_t countZ)
+		: countX(countX), countY(countY), countZ(countZ), slices(countZ), clusterRanges(size_t(countX) * countY * countZ)
+	{
+		gridHeader.clusterCount = glm::uvec4(countX, countY, countZ, 0);
+	}
+
+	// Ώ̂ȓe (glm::perspective) OɃNX^AABB蒼 (lςȂΉȂ)
+	void setProjection(const glm::mat4& Projection, float nearPlane, float farPlane, float width, float height)
+	{
+		const glm::vec4 params(Projection[0][0], Projection[1][1], nearPlane, farPlane);
+		if (params == projectionParams && !boxes.empty() && gridHeader.clusterParams.x == countX / width && gridHeader.clusterParams.y == countY / height)
+		{
+			return;
+		}
+		projectionParams = params;
+		gridHeader.clusterParams = glm::vec4(countX / width, countY / height, countZ / std::log(farPlane / nearPlane), nearPlane);
+
+		// XCXk̐[x nearPlane * (farPlane / nearPlane)^(k / countZ)
+		boxes.resize(clusterRanges.size());
+		rowBoxes.resize(size_t(countY) * countZ);
+		sliceBoxes.resize(countZ);
+		for (uint32_t z = 0; z < countZ; z++)
+		{
+			const float sliceNear = nearPlane * std::pow(farPlane / nearPlane, float(z) / countZ);
+			const float sliceFar = nearPlane * std::pow(farPlane / nearPlane, float(z + 1) / countZ);
+			sliceBoxes[z] = emptyBox();
+			for (uint32_t y = 0; y < countY; y++)
+			{
+				Box& row = rowBoxes[size_t(z) * countY + y];
+				row = emptyBox();
+				for (uint32_t x = 0; x < countX; x++)
+				{
+					const glm::vec2 ndcMin(-1.0f + 2.0f * x / countX, -1.0f + 2.0f * y / countY);
+					const glm::vec2 ndcMax(-1.0f + 2.0f * (x + 1) / countX, -1.0f + 2.0f * (y + 1) / countY);
+					const glm::vec2 scale(1.0f / Projection[0][0], 1.0f / Projection[1][1]);
+					// [xdł̃r[Ԃxyndc * d / Projection[i][i]Ȃ̂ŁAXCX̎OƉ̖ʂ̒[Ō܂
+					Box& box = boxes[clusterIndex(x, y, z)];
+					box.min = glm::vec3(glm::min(ndcMin * sliceNear, ndcMin * sliceFar) * scale, -sliceFar);
+					box.max = glm::vec3(glm::max(ndcMax * sliceNear, ndcMax * sliceFar) * scale, -sliceNear);
+					row = merge(row, box);
+				}
+				sliceBoxes[z] = merge(sliceBoxes[z], row);
+			}
+		}
+	}
+
+	// spheres: r[Ԃ̋E (xyz: S, w: a)A蓖Ăԍspheres̓Y
+	void assign(const std::vector<glm::vec4>& spheres, ThreadPool* pool = nullptr, ClusterKernel kernel = bestClusterKernel())
+	{
+		allSpheres.clear();
+		for (size_t i = 0; i < spheres.size(); i++)
+		{
+			allSpheres.push(spheres[i], static_cast<uint32_t>(i));
+		}
+
+		const auto assignSlices = [&](size_t begin, size_t end)
+		{
+			for (size_t z = begin; z < end; z++)
+			{
+				assignSlice(static_cast<uint32_t>(z), kernel);
+			}
+		};
+		if (pool != nullptr)
+		{
+			parallelFor(*pool, countZ, 1, assignSlices);
+		}
+		else
+		{
+			assignSlices(0, countZ);
+		}
+
+		// XCXƂ̔ԍ̔zȂAItZbg炷
+		size_t total = 0;
+		for (const auto& slice : slices)
+		{
+			total += slice.indices.size();
+		}
+		lightIndices.resize(total);
+		uint32_t base = 0;
+		for (uint32_t z = 0; z < countZ; z++)
+		{
+			const auto& sliceIndices = slices[z].indices;
+			if (!sliceIndices.empty())
+			{
+				std::memcpy(lightIndices.data() + base, sliceIndices.data(), sliceIndices.size() * sizeof(uint32_t));
+			}
+			for (size_t i = clusterIndex(0, 0, z), end = clusterIndex(0, 0, z + 1); i < end; i++)
+			{
+				clusterRanges[i].offset += base;
+			}
+			base += static_cast<uint32_t>(sliceIndices.size());
+		}
+	}
+
+	const ClusterGridHeader& header() const { return gridHeader; }
+	const std::vector<ClusterRange>& clusters() const { return clusterRanges; }
+	const std::vector<uint32_t>& indices() const { return lightIndices; }
+
+	// Shaders/ClusteredLights.glslClusterIndex()Ɠ
+	size_t clusterIndex(uint32_t x, uint32_t y, uint32_t z) const
+	{
+		return (size_t(z) * countY + y) * countX + x;
+	}
+
+private:
+	struct Box
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	// J[l8ǂ߂悤ɐƂɕׂ
+	struct Spheres
+	{
+		std::vector<float> x;
+		std::vector<float> y;
+		std::vector<float> z;
+		std::vector<float> radiusSq;
+		std::vector<uint32_t> index;
+
+		size_t size() const { return index.size(); }
+
+		void clear()
+		{
+			x.clear();
+			y.clear();
+			z.clear();
+			radiusSq.clear();
+			index.clear();
+		}
+
+		void push(const glm::vec4& sphere, uint32_t i)
+		{
+			x.push_back(sphere.x);
+			y.push_back(sphere.y);
+			z.push_back(sphere.z);
+			radiusSq.push_back(sphere.w * sphere.w);
+			index.push_back(i);
+		}
+
+		void push(const Spheres& from, uint32_t i)
+		{
+			x.push_back(from.x[i]);
+			y.push_back(from.y[i]);
+			z.push_back(from.z[i]);
+			radiusSq.push_back(from.radiusSq[i]);
+			index.push_back(from.index[i]);
+		}
+	};
+
+	// XCXƂ̍Ɨ̈ (XbhԂŋLȂ)
+	struct Slice
+	{
+		Spheres candidates;
+		Spheres rowCandidates;
+		std::vector<uint32_t> hits;
+		std::vector<uint32_t> indices;
+	};
+
+	static Box emptyBox()
+	{
+		return { glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX) };
+	}
+
+	static Box merge(const Box& a, const Box& b)
+	{
+		return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+	}
+
+#ifdef CLUSTERED_LIGHTS_AVX2
+	// 8肵AŌ8ɖȂ̐擪̈ʒuԂ
+	CPU_AVX2_TARGET static size_t overlappingAvx2(const Spheres& spheres, const Box& box, std::vector<uint32_t>& hits)
+	{
+		const __m256 zero = _mm256_setzero_ps();
+		const __m256 minX = _mm256_set1_ps(box.min.x), maxX = _mm256_set1_ps(box.max.x);
+		const __m256 minY = _mm256_set1_ps(box.min.y), maxY = _mm256_set1_ps(box.max.y);
+		const __m256 minZ = _mm256_set1_ps(box.min.z), maxZ = _mm256_set1_ps(box.max.z);
+		size_t i = 0;
+		for (; i + 8 <= spheres.size(); i += 8)
+		{
+			const __m256 x = _mm256_loadu_ps(spheres.x.data() + i);
+			const __m256 y = _mm256_loadu_ps(spheres.y.data() + i);
+			const __m256 z = _mm256_loadu_ps(spheres.z.data() + i);
+			// SAABB܂ł̋ (Ȃ0)
+			const __m256 dx = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minX, x), _mm256_sub_ps(x, maxX)), zero);
+			const __m256 dy = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minY, y), _mm256_sub_ps(y, maxY)), zero);
+			const __m256 dz = _mm256_max_ps(_mm256_max_ps(_mm256_sub_ps(minZ, z), _mm256_sub_ps(z, maxZ)), zero);
+			const __m256 distanceSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+			int mask = _mm256_movemask_ps(_mm256_cmp_ps(distanceSq, _mm256_loadu_ps(spheres.radiusSq.data() + i), _CMP_LE_OQ));
+			while (mask != 0)
+			{
+				int bit = 0;
+				while ((mask & (1 << bit)) == 0)
+				{
+					bit++;
+				}
+				hits.push_back(static_cast<uint32_t>(i + bit));
+				mask &= mask - 1;
+			}
+		}
+		return i;
+	}
+#endif
+
+	// AABBƌ鋅̓Y (spheres̈ʒu) hitsɏ
+	static void overlapping(const Spheres& spheres, const Box& box, ClusterKernel kernel, std::vector<uint32_t>& hits)
+	{
+		hits.clear();
+		size_t i = 0;
+#ifdef CLUSTERED_LIGHTS_AVX2
+		if (kernel == ClusterKernelAvx2)
+		{
+			i = overlappingAvx2(spheres, box, hits);
+		}
+#else
+		(void)kernel;
+#endif
+		for (; i < spheres.size(); i++)
+		{
+			const float dx = std::max(std::max(box.min.x - spheres.x[i], spheres.x[i] - box.max.x), 0.0f);
+			const float dy = std::max(std::max(box.min.y - spheres.y[i], spheres.y[i] - box.max.y), 0.0f);
+			const float dz = std::max(std::max(box.min.z - spheres.z[i], spheres.z[i] - box.max.z), 0.0f);
+			if (dx * dx + dy * dy + dz * dz <= spheres.radiusSq[i])
+			{
+				hits.push_back(static_cast<uint32_t>(i));
+			}
+		}
+	}
+
+	// clusterRanges̃ItZbg̓XCX̐擪̈ʒuŏAassign()ł炷
+	void assignSlice(uint32_t z, ClusterKernel kernel)
+	{
+		Slice& slice = slices[z];
+		slice.indices.clear();
+
+		overlapping(allSpheres, sliceBoxes[z], kernel, slice.hits);
+		slice.candidates.clear();
+		for (const uint32_t hit : slice.hits)
+		{
+			slice.candidates.push(allSpheres, hit);
+		}
+
+		for (uint32_t y = 0; y < countY; y++)
+		{
+			overlapping(slice.candidates, rowBoxes[size_t(z) * countY + y], kernel, slice.hits);
+			slice.rowCandidates.clear();
+			for (const uint32_t hit : slice.hits)
+			{
+				slice.rowCandidates.push(slice.candidates, hit);
+			}
+
+			for (uint32_t x = 0; x < countX; x++)
+			{
+				const size_t cluster = clusterIndex(x, y, z);
+				overlapping(slice.rowCandidates, boxes[cluster], kernel, slice.hits);
+				clusterRanges[cluster] = { static_cast<uint32_t>(slice.indices.size()), static_cast<uint32_t>(slice.hits.size()) };
+				for (const uint32_t hit : slice.hits)
+				{
+					slice.indices.push_back(slice.rowCandidates.index[hit]);
+				}
+			}
+		}
+	}
+
+	uint32_t countX;
+	uint32_t countY;
+	uint32_t countZ;
+	glm::vec4 projectionParams = glm::vec4(0.0f); // Projection[0][0], Projection[1][1], near, far
+	ClusterGridHeader gridHeader = {};
+	std::vector<Box> boxes;      // NX^
+	std::vector<Box> rowBoxes;   // XCX1s̃NX^͂
+	std::vector<Box> sliceBoxes; // XCX̑SẴNX^͂
+	Spheres allSpheres;
+	std::vector<Slice> slices;
+	std::vector<ClusterRange> clusterRanges;
+	std::vector<uint32_t> lightIndices;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+// sɑISIMD̃J[l̂߂̐ݒ
+// AVX2̃J[lx86/x64ȂɃRpCAcpuSupportsAvx2()őI
+// MSVC/arch:AVX2ȂłAVX2̑gݍ݊֐gBGCC/Clang͊֐Pʂtarget("avx2")t
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_FEATURES_AVX2 1
+#include <immintrin.h>
+// CPU_AVX2_FLATTEN͌Ăяo֐SēWJAAVX2LɂĂȂ֐__m256󂯓nȂ悤ɂ
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CPU_AVX2_TARGET
+#define CPU_AVX2_FLATTEN
+#else
+#define CPU_AVX2_TARGET __attribute__((target("avx2")))
+#define CPU_AVX2_FLATTEN __attribute__((target("avx2"), flatten))
+#endif
+#endif
+
+// CPUOSAVX2 (YMMWX^̕ۑ܂) ɑΉĂ邩
+inline bool cpuSupportsAvx2()
+{
+#if defined(CPU_FEATURES_AVX2) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+	{
+		return false;
+	}
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+	{
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#elif defined(CPU_FEATURES_AVX2)
+	return __builtin_cpu_supports("avx2") != 0;
+#else
+	return false;
+#endif
+}
@@ -2,9 +2,9 @@
 
 layout (location = 0) in vec4 position;
 
-uniform mat4 ModelViewProjection;
+#include "DrawData.glsl"
 
 void main()
 {
-  gl_Position = ModelViewProjection * position;
+  gl_Position = draws[gl_BaseInstance].ModelViewProjection * position;
 }
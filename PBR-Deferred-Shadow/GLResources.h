@@ -0,0 +1,29 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <GL/glew.h>
+
+// DSA (glCreate*) GL̃\[X쐬
+// 쐬ݒIuWFNg𒼐ڎw肷̂ŁAoCh̏ (GLStateCacheoĂl) ςȂ
+// eNX`ƃobt@͕sσXg[W (glTextureStorage*, glNamedBufferStorage) ŊmۂAhCoɑ傫ƌ`ŏm点
+// _[^[QbgƃVhE}bvRenderGraph
+
+// ő̃~bvx܂ł̒i
+inline GLsizei mipLevelCount(GLsizei width, GLsizei height)
+{
+	GLsizei levels = 1;
+	for (GLsizei size = std::max(width, height); size > 1; size /= 2)
+	{
+		levels++;
+	}
+	return levels;
+}
+
+// flags0Ȃ쐬CPU珑Ȃ (GPUǂސÓIȃf[^)
+inline GLuint createBuffer(GLsizeiptr size, const void* data, GLbitfield flags = 0)
+{
+	GLuint buffer;
+	glCreateBuffers(1, &buffer);
+	glNamedBufferStorage(buffer, size, data, flags);
+	return buffer;
+}
@@ -0,0 +1,297 @@
+#pragma once
+#include <array>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <vector>
+#include <GL/glew.h>
+
+// GL̃Xe[geŎA݂Ɠlݒ肷ĂяohCoɓnɎ̂Ă
+// t[[ṽXe[gύX͑SĂʂ (̏ꏊŒڕςXe[ginvalidate*()Ŗmɖ߂)
+// reportIntervalt[Ƃ1t[̔sƏȗ̕ςstd::coutɏo͂
+class GLStateCache
+{
+public:
+	struct Counters
+	{
+		size_t issued = 0;
+		size_t skipped = 0;
+	};
+
+	static const int MaxTextureUnits = 32;
+
+	explicit GLStateCache(int reportInterval = 300) : reportInterval(reportInterval)
+	{
+	}
+
+	// SẴXe[g𖢒mɂ (̐ݒ͕Ks)
+	void invalidate()
+	{
+		*this = GLStateCache(reportInterval, frameCounters, totalCounters, frames);
+	}
+
+	// glBindTextureŒڃoChR[ȟɌĂ
+	void invalidateTextures()
+	{
+		textures.fill(std::nullopt);
+	}
+
+	void useProgram(GLuint program)
+	{
+		set(currentProgram, program, [&]() { glUseProgram(program); });
+	}
+
+	void bindTextureUnit(GLuint unit, GLuint texture)
+	{
+		if (unit >= MaxTextureUnits)
+		{
+			issue([&]() { glBindTextureUnit(unit, texture); });
+			return;
+		}
+		set(textures[unit], texture, [&]() { glBindTextureUnit(unit, texture); });
+	}
+
+	void bindFramebuffer(GLenum target, GLuint framebuffer)
+	{
+		if (target == GL_FRAMEBUFFER)
+		{
+			if (drawFramebuffer == framebuffer && readFramebuffer == framebuffer)
+			{
+				frameCounters.skipped++;
+				return;
+			}
+			issue([&]() { glBindFramebuffer(GL_FRAMEBUFFER, framebuffer); });
+			drawFramebuffer = framebuffer;
+			readFramebuffer = framebuffer;
+			return;
+		}
+		set(target == GL_DRAW_FRAMEBUFFER ? drawFramebuffer : readFramebuffer, framebuffer, [&]() { glBindFramebuffer(target, framebuffer); });
+	}
+
+	void bindVertexArray(GLuint vao)
+	{
+		set(currentVertexArray, vao, [&]() { glBindVertexArray(vao); });
+	}
+
+	void enable(GLenum capability)
+	{
+		set(capabilities[capability], true, [&]() { glEnable(capability); });
+	}
+
+	void disable(GLenum capability)
+	{
+		set(capabilities[capability], false, [&]() { glDisable(capability); });
+	}
+
+	void depthMask(GLboolean flag)
+	{
+		set(currentDepthMask, flag, [&]() { glDepthMask(flag); });
+	}
+
+	void depthFunc(GLenum func)
+	{
+		set(currentDepthFunc, func, [&]() { glDepthFunc(func); });
+	}
+
+	void colorMask(GLboolean r, GLboolean g, GLboolean b, GLboolean a)
+	{
+		set(currentColorMask, std::make_tuple(r, g, b, a), [&]() { glColorMask(r, g, b, a); });
+	}
+
+	void stencilFunc(GLenum func, GLint ref, GLuint mask)
+	{
+		const auto value = std::make_tuple(func, ref, mask);
+		if (stencilFuncs[0] == value && stencilFuncs[1] == value)
+		{
+			frameCounters.skipped++;
+			return;
+		}
+		issue([&]() { glStencilFunc(func, ref, mask); });
+		stencilFuncs[0] = value;
+		stencilFuncs[1] = value;
+	}
+
+	void stencilOp(GLenum sfail, GLenum dpfail, GLenum dppass)
+	{
+		const auto value = std::make_tuple(sfail, dpfail, dppass);
+		if (stencilOps[0] == value && stencilOps[1] == value)
+		{
+			frameCounters.skipped++;
+			return;
+		}
+		issue([&]() { glStencilOp(sfail, dpfail, dppass); });
+		stencilOps[0] = value;
+		stencilOps[1] = value;
+	}
+
+	void stencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass)
+	{
+		if (face == GL_FRONT_AND_BACK)
+		{
+			stencilOp(sfail, dpfail, dppass);
+			return;
+		}
+		set(stencilOps[face == GL_FRONT ? 0 : 1], std::make_tuple(sfail, dpfail, dppass), [&]() { glStencilOpSeparate(face, sfail, dpfail, dppass); });
+	}
+
+	void stencilMask(GLuint mask)
+	{
+		set(currentStencilMask, mask, [&]() { glStencilMask(mask); });
+	}
+
+	void cullFace(GLenum mode)
+	{
+		set(currentCullFace, mode, [&]() { glCullFace(mode); });
+	}
+
+	void blendEquation(GLenum mode)
+	{
+		set(currentBlendEquation, mode, [&]() { glBlendEquation(mode); });
+	}
+
+	void blendFunc(GLenum sfactor, GLenum dfactor)
+	{
+		set(currentBlendFunc, std::make_tuple(sfactor, dfactor), [&]() { glBlendFunc(sfactor, dfactor); });
+	}
+
+	void polygonOffset(GLfloat factor, GLfloat units)
+	{
+		set(currentPolygonOffset, std::make_tuple(factor, units), [&]() { glPolygonOffset(factor, units); });
+	}
+
+	void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		set(currentViewport, std::make_tuple(x, y, width, height), [&]() { glViewport(x, y, width, height); });
+	}
+
+	void scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		set(currentScissor, std::make_tuple(x, y, width, height), [&]() { glScissor(x, y, width, height); });
+	}
+
+	void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+	{
+		set(currentClearColor, std::make_tuple(r, g, b, a), [&]() { glClearColor(r, g, b, a); });
+	}
+
+	void clearDepth(GLdouble depth)
+	{
+		set(currentClearDepth, depth, [&]() { glClearDepth(depth); });
+	}
+
+	void clearStencil(GLint s)
+	{
+		set(currentClearStencil, s, [&]() { glClearStencil(s); });
+	}
+
+	// `̃obt@̓t[obt@Ƃ̃Xe[gȂ̂ŁAoCh̃t[obt@ƂɊo
+	void drawBuffer(GLenum buffer)
+	{
+		drawBuffers(1, &buffer);
+	}
+
+	void drawBuffers(GLsizei count, const GLenum* buffers)
+	{
+		std::vector<GLenum> value(buffers, buffers + count);
+		if (!drawFramebuffer)
+		{
+			issueDrawBuffers(count, buffers);
+			return;
+		}
+		auto& current = framebufferDrawBuffers[*drawFramebuffer];
+		if (current == value)
+		{
+			frameCounters.skipped++;
+			return;
+		}
+		issueDrawBuffers(count, buffers);
+		current = std::move(value);
+	}
+
+	// ̃t[̔sƏȗ (endFrame()0ɖ߂)
+	const Counters& counters() const { return frameCounters; }
+
+	void endFrame()
+	{
+		totalCounters.issued += frameCounters.issued;
+		totalCounters.skipped += frameCounters.skipped;
+		frameCounters = Counters();
+		frames++;
+		if (frames == reportInterval)
+		{
+			std::cout << "GL state: " << static_cast<double>(totalCounters.issued) / frames << " issued, "
+				<< static_cast<double>(totalCounters.skipped) / frames << " skipped per frame (average of " << frames << " frames)" << std::endl;
+			totalCounters = Counters();
+			frames = 0;
+		}
+	}
+
+private:
+	GLStateCache(int reportInterval, const Counters& frameCounters, const Counters& totalCounters, int frames)
+		: reportInterval(reportInterval), frameCounters(frameCounters), totalCounters(totalCounters), frames(frames)
+	{
+	}
+
+	template <typename T, typename Apply>
+	void set(std::optional<T>& current, const T& value, Apply apply)
+	{
+		if (current == value)
+		{
+			frameCounters.skipped++;
+			return;
+		}
+		issue(apply);
+		current = value;
+	}
+
+	template <typename Apply>
+	void issue(Apply apply)
+	{
+		apply();
+		frameCounters.issued++;
+	}
+
+	void issueDrawBuffers(GLsizei count, const GLenum* buffers)
+	{
+		if (count == 1)
+		{
+			issue([&]() { glDrawBuffer(buffers[0]); });
+		}
+		else
+		{
+			issue([&]() { glDrawBuffers(count, buffers); });
+		}
+	}
+
+	using StencilFunc = std::tuple<GLenum, GLint, GLuint>;
+	using StencilOp = std::tuple<GLenum, GLenum, GLenum>;
+
+	int reportInterval;
+	Counters frameCounters;
+	Counters totalCounters;
+	int frames = 0;
+
+	std::optional<GLuint> currentProgram;
+	std::array<std::optional<GLuint>, MaxTextureUnits> textures;
+	std::optional<GLuint> drawFramebuffer;
+	std::optional<GLuint> readFramebuffer;
+	std::optional<GLuint> currentVertexArray;
+	std::map<GLenum, std::optional<bool>> capabilities;
+	std::optional<GLboolean> currentDepthMask;
+	std::optional<GLenum> currentDepthFunc;
+	std::optional<std::tuple<GLboolean, GLboolean, GLboolean, GLboolean>> currentColorMask;
+	std::array<std::optional<StencilFunc>, 2> stencilFuncs; // 0: front, 1: back
+	std::array<std::optional<StencilOp>, 2> stencilOps;     // 0: front, 1: back
+	std::optional<GLuint> currentStencilMask;
+	std::optional<GLenum> currentCullFace;
+	std::optional<GLenum> currentBlendEquation;
+	std::optional<std::tuple<GLenum, GLenum>> currentBlendFunc;
+	std::optional<std::tuple<GLfloat, GLfloat>> currentPolygonOffset;
+	std::optional<std::tuple<GLint, GLint, GLsizei, GLsizei>> currentViewport;
+	std::optional<std::tuple<GLint, GLint, GLsizei, GLsizei>> currentScissor;
+	std::optional<std::tuple<GLfloat, GLfloat, GLfloat, GLfloat>> currentClearColor;
+	std::optional<GLdouble> currentClearDepth;
+	std::optional<GLint> currentClearStencil;
+	std::map<GLuint, std::vector<GLenum>> framebufferDrawBuffers;
+};
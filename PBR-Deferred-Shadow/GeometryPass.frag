@@ -2,44 +2,45 @@
 
 in vec3 vWorldNormal;
 in vec3 vWorldTangent;
+in float vBitangentSign;
 in float vDepth;
 in vec2 vUv;
+flat in float vEmissiveIntensity;
 
 layout (location = 0) out vec4 GBuffer0; // rgb: albedo, a: ambient occlusion
 layout (location = 1) out vec4 GBuffer1; // rgb: world normal, a: metallic
 layout (location = 2) out vec4 GBuffer2; // rgb: world tangent, a: roughness
 layout (location = 3) out vec4 GBuffer3; // rgb: emissive, a: depth
 
-uniform sampler2D albedoMap;
-uniform sampler2D aoMap;
-uniform sampler2D metallicMap;
-uniform sampler2D roughnessMap;
-uniform sampler2D normalMap;
-uniform sampler2D emissiveMap;
-uniform float emissiveIntensity;
+layout (binding = 0) uniform sampler2D albedoMap;
+layout (binding = 1) uniform sampler2D ormMap;    // r: ambient occlusion, g: roughness, b: metallic
+layout (binding = 2) uniform sampler2D normalMap; // rg: tangent space normal xy, z is reconstructed
+layout (binding = 3) uniform sampler2D emissiveMap;
 
 void getNormalAndTangent(out vec3 normal, out vec3 tangent)
 {
   vec3 vNormal = normalize(vWorldNormal);
   vec3 vTangent = normalize(vWorldTangent);
-  vec3 bitangent = normalize(cross(vTangent, vNormal));
-  vec3 normalFromMap = texture(normalMap, vUv).xyz;
+  vec3 bitangent = normalize(cross(vTangent, vNormal)) * vBitangentSign;
+  vec2 normalXY = texture(normalMap, vUv).rg * 2.0 - 1.0;
+  vec3 normalFromMap = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
   mat3 TBN = mat3(vTangent, bitangent, vNormal);
-  normal = normalize(TBN * (normalFromMap * 2.0 - 1.0));
-  tangent = normalize(cross(bitangent, normal));
+  normal = normalize(TBN * normalFromMap);
+  tangent = normalize(cross(bitangent, normal)) * vBitangentSign;
 }
 
 void main()
 {
   vec4 albedo = texture(albedoMap, vUv);
   if  (albedo.a < 0.5) discard;
-  vec4 ao = texture(aoMap, vUv);
-  float metallic = texture(metallicMap, vUv).r;
-  float roughness = texture(roughnessMap, vUv).r;
+  vec3 orm = texture(ormMap, vUv).rgb;
+  float ao = orm.r;
+  float roughness = orm.g;
+  float metallic = orm.b;
   vec3 normal;
   vec3 tangent;
   getNormalAndTangent(normal, tangent);
-  vec3 emissive = texture(emissiveMap, vUv).rgb * emissiveIntensity;
+  vec3 emissive = texture(emissiveMap, vUv).rgb * vEmissiveIntensity;
 
   GBuffer0 = vec4(albedo.rgb, ao);
   GBuffer1 = vec4(normal * 0.5 + 0.5, metallic);
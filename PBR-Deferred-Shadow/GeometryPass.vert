@@ -1,32 +1,65 @@
 #version 460
 
-uniform mat4 ModelIT;
-uniform mat4 ModelView;
-uniform mat4 Projection;
-uniform vec2 ProjectionParams; // x: near, y: far
+#include "FrameUniforms.glsl"
+#include "DrawData.glsl"
 
-layout (location = 0) in vec4 position;
+layout (location = 0) in vec4 position; // 16bit quantized positions are dequantized by ModelView
 layout (location = 1) in vec2 uv;
-layout (location = 2) in vec3 normal;
-layout (location = 3) in vec3 tangent;
+layout (location = 2) in vec4 tangentFrame; // xy: octahedral normal, z: tangent angle / PI, w: bitangent sign
 
 out vec3 vWorldNormal;
 out vec3 vWorldTangent;
+out float vBitangentSign;
 out float vDepth;
 out vec2 vUv;
+flat out float vEmissiveIntensity;
+
+const float PI = 3.14159265358979;
 
 float EncodeDepth(in float viewDepth, in vec2 ProjectionParams)
 {
   return (-viewDepth - ProjectionParams.x) / (ProjectionParams.y - ProjectionParams.x);
 }
 
+vec3 DecodeOctahedral(in vec2 e)
+{
+  vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+  if (n.z < 0.0)
+  {
+    vec2 signNotZero = vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    n.xy = (1.0 - abs(n.yx)) * signNotZero;
+  }
+  return normalize(n);
+}
+
+// must match buildOrthonormalBasis in VertexFormat.h
+void BuildOrthonormalBasis(in vec3 n, out vec3 b1, out vec3 b2)
+{
+  float s = n.z >= 0.0 ? 1.0 : -1.0;
+  float a = -1.0 / (s + n.z);
+  float b = n.x * n.y * a;
+  b1 = vec3(1.0 + s * n.x * n.x * a, s * b, -s * n.x);
+  b2 = vec3(b, s + n.y * n.y * a, -n.y);
+}
+
 void main()
 {
-  vWorldNormal = mat3(ModelIT) * normal;
-  vWorldTangent = mat3(ModelIT) * tangent;
+  vec3 normal = DecodeOctahedral(tangentFrame.xy);
+  vec3 b1;
+  vec3 b2;
+  BuildOrthonormalBasis(normal, b1, b2);
+  float angle = tangentFrame.z * PI;
+  vec3 tangent = cos(angle) * b1 + sin(angle) * b2;
+
+  DrawData draw = draws[gl_BaseInstance];
+
+  vWorldNormal = mat3(draw.ModelIT) * normal;
+  vWorldTangent = mat3(draw.ModelIT) * tangent;
+  vBitangentSign = tangentFrame.w < 0.0 ? -1.0 : 1.0;
   vUv = uv;
+  vEmissiveIntensity = draw.params.x;
 
-  vec4 viewPos = ModelView * position;
+  vec4 viewPos = draw.ModelView * position;
   vDepth = EncodeDepth(viewPos.z, ProjectionParams);
 
   gl_Position = Projection * viewPos;
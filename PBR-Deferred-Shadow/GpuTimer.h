@@ -0,0 +1,82 @@
+#pragma once
+#include <array>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <GL/glew.h>
+
+// GL_TIME_ELAPSEDNGŃpXGPUԂv
+// t[ÕNǦʂǂނ̂ŃpCvC͎~߂Ȃ
+// reportIntervalt[Ƃɕςstd::coutɏo͂
+struct GpuTimer
+{
+	static const int QueryCount = 4;
+
+	std::string name;
+	int reportInterval;
+	std::array<GLuint, QueryCount> queries{};
+	int frame = 0;
+	int samples = 0;
+	double totalMilliseconds = 0.0;
+
+	GpuTimer(std::string name, int reportInterval = 300) : name(std::move(name)), reportInterval(reportInterval)
+	{
+		glCreateQueries(GL_TIME_ELAPSED, QueryCount, queries.data());
+	}
+
+	~GpuTimer()
+	{
+		glDeleteQueries(QueryCount, queries.data());
+	}
+
+	GpuTimer(const GpuTimer&) = delete;
+	GpuTimer& operator=(const GpuTimer&) = delete;
+
+	// ςČvƂɁA܂ł̃Tv̂Ă
+	void reset()
+	{
+		samples = 0;
+		totalMilliseconds = 0.0;
+	}
+
+	// reset()܂͑Ȍo͂̕ (ms)
+	double average() const
+	{
+		return samples > 0 ? totalMilliseconds / samples : 0.0;
+	}
+
+	void begin()
+	{
+		glBeginQuery(GL_TIME_ELAPSED, queries[frame % QueryCount]);
+	}
+
+	void end()
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		frame++;
+		if (frame < QueryCount)
+		{
+			return;
+		}
+
+		// ɏ㏑NG = ԌÂNǦʂ
+		const GLuint oldest = queries[frame % QueryCount];
+		GLint available = GL_FALSE;
+		glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available == GL_FALSE)
+		{
+			return;
+		}
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &nanoseconds);
+		totalMilliseconds += nanoseconds * 1e-6;
+		samples++;
+
+		if (samples == reportInterval)
+		{
+			std::cout << name << ": " << totalMilliseconds / samples << " ms (GPU, average of " << samples << " frames)" << std::endl;
+			samples = 0;
+			totalMilliseconds = 0.0;
+		}
+	}
+};
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// LbV̌ɂoCg̃nbV (FNV-1a8oCgPʂŉ񂵂)
+inline uint64_t hashBytes(const char* data, size_t size)
+{
+	const uint64_t prime = 0x100000001B3ull;
+	uint64_t hash = 0xCBF29CE484222325ull;
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, data + i, 8);
+		hash = (hash ^ word) * prime;
+		hash ^= hash >> 29;
+	}
+	for (; i < size; i++)
+	{
+		hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+	}
+	return hash;
+}
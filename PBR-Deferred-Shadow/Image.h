@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <stb_image.h>
+
+// fR[hς݂̉摜 ([J[XbhōACXbhŃAbv[h)
+struct DecodedImage
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	std::unique_ptr<stbi_uc, void (*)(void*)> pixels{ nullptr, stbi_image_free };
+
+	size_t size() const
+	{
+		return size_t(width) * height * channels;
+	}
+};
+
+inline bool decodeImage(const std::string& path, DecodedImage& out)
+{
+	// stbi_set_flip_vertically_on_load̓O[oȂ̂ŃXbhƂ̐ݒg
+	stbi_set_flip_vertically_on_load_thread(true);
+	out.pixels.reset(stbi_load(path.c_str(), &out.width, &out.height, &out.channels, 0));
+	return out.pixels != nullptr;
+}
+
+inline bool decodeImageFromMemory(const char* data, size_t size, DecodedImage& out)
+{
+	stbi_set_flip_vertically_on_load_thread(true);
+	out.pixels.reset(stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(data), static_cast<int>(size), &out.width, &out.height, &out.channels, 0));
+	return out.pixels != nullptr;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm.hpp>
+
+#include "UniformBlocks.h"
+
+// `悲Ƃ̃Cg̃JO (tH[ȟoHŎg)
+// ̂̋EƃCg̉e͈͂̋EdȂ郉CgA̕`̃Cg̃Xgɓ
+
+// X|bgCg̉~͂ލŏ̋ (xyz: S, w: a)
+inline glm::vec4 coneBoundingSphere(const glm::vec3& apex, const glm::vec3& direction, float range, float cosHalfAngle)
+{
+	if (cosHalfAngle < 0.70710678f)
+	{
+		const float sinHalfAngle = std::sqrt(std::max(0.0f, 1.0f - cosHalfAngle * cosHalfAngle));
+		return glm::vec4(apex + direction * range * cosHalfAngle, range * sinHalfAngle);
+	}
+	const float radius = range / (2.0f * cosHalfAngle);
+	return glm::vec4(apex + direction * radius, radius);
+}
+
+// Cg̉e͈͂͂ދ (xyz: S, w: a)AX|bgCg͉~͂
+inline glm::vec4 lightBoundingSphere(const PunctualLight& light)
+{
+	if (light.type == PunctualLightSpot)
+	{
+		return coneBoundingSphere(light.position, light.direction, light.range, light.cosOuterAngle);
+	}
+	return glm::vec4(light.position, light.range);
+}
+
+// _͂ދ (AABB̒Sԉ_܂)
+inline glm::vec4 boundingSphere(const std::vector<glm::vec3>& positions)
+{
+	if (positions.empty())
+	{
+		return glm::vec4(0.0f);
+	}
+	glm::vec3 lower = positions[0];
+	glm::vec3 upper = positions[0];
+	for (const auto& position : positions)
+	{
+		lower = glm::min(lower, position);
+		upper = glm::max(upper, position);
+	}
+	const glm::vec3 center = (lower + upper) * 0.5f;
+	float radiusSq = 0.0f;
+	for (const auto& position : positions)
+	{
+		const glm::vec3 d = position - center;
+		radiusSq = std::max(radiusSq, glm::dot(d, d));
+	}
+	return glm::vec4(center, std::sqrt(radiusSq));
+}
+
+// EModelŕϊ (a͈ԑ傫g傷鎲ɍ킹)
+inline glm::vec4 transformBoundingSphere(const glm::mat4& Model, const glm::vec4& sphere)
+{
+	const float scaleSq = std::max({ glm::dot(glm::vec3(Model[0]), glm::vec3(Model[0])),
+		glm::dot(glm::vec3(Model[1]), glm::vec3(Model[1])),
+		glm::dot(glm::vec3(Model[2]), glm::vec3(Model[2])) });
+	return glm::vec4(glm::vec3(Model * glm::vec4(glm::vec3(sphere), 1.0f)), sphere.w * std::sqrt(scaleSq));
+}
+
+// boundsƏdȂ郉Cg̔ԍ (lights̓Y) indicešɑAԂ
+inline uint32_t cullLights(const std::vector<PunctualLight>& lights, const glm::vec4& bounds, std::vector<uint32_t>& indices)
+{
+	const size_t first = indices.size();
+	for (size_t i = 0; i < lights.size(); i++)
+	{
+		const glm::vec4 sphere = lightBoundingSphere(lights[i]);
+		const glm::vec3 d = glm::vec3(sphere) - glm::vec3(bounds);
+		const float radius = sphere.w + bounds.w;
+		if (glm::dot(d, d) <= radius * radius)
+		{
+			indices.push_back(static_cast<uint32_t>(i));
+		}
+	}
+	return static_cast<uint32_t>(indices.size() - first);
+}
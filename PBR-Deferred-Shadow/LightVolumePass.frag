@@ -0,0 +1,44 @@
+#version 460
+
+// Back faces of the light volume are drawn with a GEQUAL depth test, so only pixels whose
+// surface lies in front of the volume's far side are shaded; LightRadiance() rejects the
+// pixels in front of the volume by range. This replaces the per-light stencil pass.
+layout (location = 0) out vec3 outRadiance;
+
+flat in uint vLight;
+
+#include "FrameUniforms.glsl"
+#include "GBuffer.glsl"
+#include "PunctualLightShading.glsl"
+#include "DepthReconstruction.glsl"
+
+
+// ###################
+// main
+// ###################
+void main()
+{
+  vec2 uv = gl_FragCoord.xy / resolution;
+
+  vec4 gbuffer0 = texture(GBuffer0, uv);
+  vec4 gbuffer1 = texture(GBuffer1, uv);
+  vec4 gbuffer2 = texture(GBuffer2, uv);
+  vec4 gbuffer3 = texture(GBuffer3, uv);
+
+  vec3 albedo = gbuffer0.rgb;
+  float ao = gbuffer0.a;
+  vec3 normal = gbuffer1.rgb * 2.0 - 1.0;
+  float metallic = gbuffer1.a;
+  vec3 tangent = gbuffer2.rgb * 2.0 - 1.0;
+  float roughness = gbuffer2.a;
+  float depth = gbuffer3.a;
+
+  vec3 bitangent = normalize(cross(tangent, normal));
+
+  vec3 worldPos = worldPosFromDepth(depth, uv);
+
+  vec3 V = normalize(worldCameraPos - worldPos);
+  vec3 N = normalize(normal);
+
+  outRadiance = LightRadiance(lights[vLight], worldPos, V, N, tangent, bitangent, albedo, metallic, roughness) * ao;
+}
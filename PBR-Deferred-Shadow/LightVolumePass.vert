@@ -0,0 +1,40 @@
+#version 460
+
+// One instance per light: the unit volume mesh is placed and scaled from
+// lights[gl_BaseInstance + gl_InstanceID] instead of a per-light draw
+layout (location = 0) in vec4 position;
+
+// Permutations define LIGHT_VOLUME_CONE 1 to draw spot lights with the unit cone
+// (apex at the origin, +Z, length and base radius 1) from LightVolumes.h instead of the sphere
+#ifndef LIGHT_VOLUME_CONE
+#define LIGHT_VOLUME_CONE 0
+#endif
+
+#include "FrameUniforms.glsl"
+#include "PunctualLights.glsl"
+
+flat out uint vLight;
+
+// Rotates +Z onto direction, same as coneBasis() in LightVolumes.h
+mat3 ConeBasis(vec3 direction)
+{
+  vec3 up = abs(direction.y) < 0.99 ? vec3(0, 1, 0) : vec3(1, 0, 0);
+  vec3 x = normalize(cross(up, direction));
+  vec3 y = cross(direction, x);
+  return mat3(x, y, direction);
+}
+
+void main()
+{
+  vLight = gl_BaseInstance + gl_InstanceID;
+  PunctualLight light = lights[vLight];
+  // Same margin as the per-light volumes
+  float volumeRange = light.range + 0.1;
+#if LIGHT_VOLUME_CONE
+  float tanAngle = sqrt(max(0.0, 1.0 - light.cosOuterAngle * light.cosOuterAngle)) / light.cosOuterAngle;
+  vec3 worldPos = light.position + ConeBasis(light.direction) * (position.xyz * vec3(volumeRange * tanAngle, volumeRange * tanAngle, volumeRange));
+#else
+  vec3 worldPos = light.position + position.xyz * volumeRange;
+#endif
+  gl_Position = ViewProjection * vec4(worldPos, 1.0);
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm.hpp>
+
+// X|bgCg̃Cg{[
+// Pʂ̉~ (__A+Zɒ1Aʂ̔a1) ACgƂ̕ϊŔ͈͂ƊO̔pɍ킹
+// ̑ɎgƁACeBOœǂމf~̗̊pɉČ
+
+struct VolumeMesh
+{
+	std::vector<glm::vec3> vertices;
+	std::vector<uint32_t> indices;
+};
+
+// ʂ̑p`͉~ɊOڂAp`̉~{̉~܂ނ悤ɂ (ʂ͊OŔv)
+inline VolumeMesh createConeMesh(int slices)
+{
+	VolumeMesh mesh;
+	const float radius = 1.0f / std::cos(3.141593f / slices);
+	mesh.vertices.emplace_back(0.0f, 0.0f, 0.0f); // _
+	mesh.vertices.emplace_back(0.0f, 0.0f, 1.0f); // ʂ̒S
+	for (int i = 0; i < slices; i++)
+	{
+		const float angle = 6.283185f * i / slices;
+		mesh.vertices.emplace_back(radius * std::cos(angle), radius * std::sin(angle), 1.0f);
+	}
+	for (int i = 0; i < slices; i++)
+	{
+		const uint32_t current = 2 + i;
+		const uint32_t next = 2 + (i + 1) % slices;
+		// 
+		mesh.indices.push_back(0);
+		mesh.indices.push_back(next);
+		mesh.indices.push_back(current);
+		// 
+		mesh.indices.push_back(1);
+		mesh.indices.push_back(current);
+		mesh.indices.push_back(next);
+	}
+	return mesh;
+}
+
+// p60x𒴂Ɖ~͔͈͂𔼌aƂ鋅傫Ȃ̂ŁÃ{[g
+inline bool useConeVolume(float cosOuterAngle)
+{
+	return cosOuterAngle > 0.5f;
+}
+
+// +Zdirection (Kς) Ɍ] (LightVolumePass.vertConeBasis()Ɠ)
+inline glm::mat3 coneBasis(const glm::vec3& direction)
+{
+	const glm::vec3 up = std::abs(direction.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+	const glm::vec3 x = glm::normalize(glm::cross(up, direction));
+	const glm::vec3 y = glm::cross(direction, x);
+	return glm::mat3(x, y, direction);
+}
+
+// Pʂ̉~𒷂lengthAO̔pcoscosOuterAnglẻ~ɂModels
+inline glm::mat4 coneVolumeModel(const glm::vec3& position, const glm::vec3& direction, float length, float cosOuterAngle)
+{
+	const float tanAngle = std::sqrt(std::max(0.0f, 1.0f - cosOuterAngle * cosOuterAngle)) / cosOuterAngle;
+	const glm::mat3 basis = coneBasis(direction);
+	glm::mat4 Model(1.0f);
+	Model[0] = glm::vec4(basis[0] * length * tanAngle, 0.0f);
+	Model[1] = glm::vec4(basis[1] * length * tanAngle, 0.0f);
+	Model[2] = glm::vec4(basis[2] * length, 0.0f);
+	Model[3] = glm::vec4(position, 1.0f);
+	return Model;
+}
+
+// ʏ̋` (sNZAglScissor̈)
+struct ScreenRect
+{
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+// bV̒_𓊉eāAʏŃbV͂ދ`ς
+// SĂ̒_JOɂ΁Aʕ̓e͒_̓e̓ʕȂ̂ŋ`͕ێIɂȂ
+// J̌ɉ钸_falseԂ (ʑŜg)BʊOȂ畝0ɂȂ
+inline bool screenBounds(const std::vector<glm::vec3>& vertices, const glm::mat4& ModelViewProjection, int width, int height, ScreenRect& rect)
+{
+	glm::vec2 lower(FLT_MAX);
+	glm::vec2 upper(-FLT_MAX);
+	for (const auto& vertex : vertices)
+	{
+		const glm::vec4 clip = ModelViewProjection * glm::vec4(vertex, 1.0f);
+		if (clip.w <= 1e-4f)
+		{
+			return false;
+		}
+		const glm::vec2 ndc = glm::vec2(clip) / clip.w;
+		lower = glm::min(lower, ndc);
+		upper = glm::max(upper, ndc);
+	}
+	const glm::vec2 size(static_cast<float>(width), static_cast<float>(height));
+	const glm::vec2 pixelMin = glm::clamp((lower * 0.5f + 0.5f) * size, glm::vec2(0.0f), size);
+	const glm::vec2 pixelMax = glm::clamp((upper * 0.5f + 0.5f) * size, glm::vec2(0.0f), size);
+	rect.x = static_cast<int>(std::floor(pixelMin.x));
+	rect.y = static_cast<int>(std::floor(pixelMin.y));
+	rect.width = std::max(0, static_cast<int>(std::ceil(pixelMax.x)) - rect.x);
+	rect.height = std::max(0, static_cast<int>(std::ceil(pixelMax.y)) - rect.y);
+	return true;
+}
@@ -4,7 +4,7 @@ in vec2 vUv;
 
 layout (location = 0) out float outputColor;
 
-uniform sampler2D inputTexture;
+layout (binding = 0) uniform sampler2D inputTexture;
 
 
 const float HALF_MAX = 65504.0;
@@ -0,0 +1,168 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+	swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		close();
+		swap(other);
+	}
+	return *this;
+}
+
+void MappedFile::swap(MappedFile& other) noexcept
+{
+	std::swap(opened, other.opened);
+	std::swap(mappedData, other.mappedData);
+	std::swap(mappedSize, other.mappedSize);
+#ifdef _WIN32
+	std::swap(fileHandle, other.fileHandle);
+	std::swap(mappingHandle, other.mappingHandle);
+#else
+	std::swap(fileDescriptor, other.fileDescriptor);
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+	const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		close();
+		return false;
+	}
+	mappedSize = static_cast<size_t>(fileSize.QuadPart);
+	opened = true;
+
+	// ̃t@C̓}bvłȂATCY0̃t@CƂĂ͗L
+	if (mappedSize == 0)
+	{
+		return true;
+	}
+
+	const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		close();
+		return false;
+	}
+	mappingHandle = mapping;
+
+	mappedData = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	if (mappedData == nullptr)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mappedData != nullptr)
+	{
+		UnmapViewOfFile(mappedData);
+	}
+	if (mappingHandle != nullptr)
+	{
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != nullptr)
+	{
+		CloseHandle(fileHandle);
+	}
+	opened = false;
+	mappedData = nullptr;
+	mappedSize = 0;
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+	fileDescriptor = ::open(path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	struct stat status;
+	if (fstat(fileDescriptor, &status) != 0)
+	{
+		close();
+		return false;
+	}
+	mappedSize = static_cast<size_t>(status.st_size);
+	opened = true;
+
+	// ̃t@C̓}bvłȂATCY0̃t@CƂĂ͗L
+	if (mappedSize == 0)
+	{
+		return true;
+	}
+
+	void* mapping = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if (mapping == MAP_FAILED)
+	{
+		close();
+		return false;
+	}
+	mappedData = static_cast<const char*>(mapping);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mappedData != nullptr)
+	{
+		munmap(const_cast<char*>(mappedData), mappedSize);
+	}
+	if (fileDescriptor >= 0)
+	{
+		::close(fileDescriptor);
+	}
+	opened = false;
+	mappedData = nullptr;
+	mappedSize = 0;
+	fileDescriptor = -1;
+}
+
+#endif
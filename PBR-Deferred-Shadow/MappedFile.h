@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// t@CǂݎpŃɃ}bv
+// windows.hnear/far}Nmain.cppɘRȂ悤MappedFile.cppɒu
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	bool open(const std::string& path);
+	void close();
+
+	bool isOpen() const { return opened; }
+	const char* data() const { return mappedData; }
+	size_t size() const { return mappedSize; }
+
+private:
+	void swap(MappedFile& other) noexcept;
+
+	bool opened = false;
+	const char* mappedData = nullptr;
+	size_t mappedSize = 0;
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#else
+	int fileDescriptor = -1;
+#endif
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Disney BRDF̃[uƂ̃rbg (Shaders/DisneyBRDF.glslBRDF_FEATURE_*ƈv)
+enum MaterialFeature : uint32_t
+{
+	MaterialFeatureSubsurface = 1,
+	MaterialFeatureSheen = 2,
+	MaterialFeatureClearcoat = 4,
+	MaterialFeatureAnisotropic = 8,
+	MaterialFeatureSpecularTint = 16,
+	MaterialFeatureAll = 31,
+};
+
+// G-bufferɓĂȂDisney BRDF̃p[^ (Shaders/DisneyMaterial.glsluniformƓl)
+struct DisneyMaterial
+{
+	float subsurface = 0.0f;
+	float specular = 0.5f;
+	float specularTint = 0.0f;
+	float anisotropic = 0.0f;
+	float sheen = 0.0f;
+	float sheenTint = 0.5f;
+	float clearcoat = 0.0f;
+	float clearcoatGloss = 1.0f;
+
+	// l0̃[u͌ʂɊ^Ȃ̂ŁAVF[_菜
+	uint32_t features() const
+	{
+		uint32_t mask = 0;
+		if (subsurface != 0.0f) mask |= MaterialFeatureSubsurface;
+		if (sheen != 0.0f) mask |= MaterialFeatureSheen;
+		if (clearcoat != 0.0f) mask |= MaterialFeatureClearcoat;
+		if (anisotropic != 0.0f) mask |= MaterialFeatureAnisotropic;
+		if (specularTint != 0.0f) mask |= MaterialFeatureSpecularTint;
+		return mask;
+	}
+};
+
+// ShaderDefinesƂēnp[~e[V#define
+inline std::vector<std::pair<std::string, std::string>> materialFeatureDefines(uint32_t mask)
+{
+	return { { "BRDF_FEATURES", std::to_string(mask) } };
+}
+
+inline std::string materialFeatureName(uint32_t mask)
+{
+	static const char* const names[] = { "subsurface", "sheen", "clearcoat", "anisotropic", "specularTint" };
+	std::string name;
+	for (uint32_t bit = 0; bit < 5; bit++)
+	{
+		if ((mask & (1u << bit)) != 0)
+		{
+			name += (name.empty() ? "" : "+") + std::string(names[bit]);
+		}
+	}
+	return name.empty() ? "base" : name;
+}
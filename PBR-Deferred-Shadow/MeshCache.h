@@ -0,0 +1,261 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Hash.h"
+#include "MappedFile.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "VertexFormat.h"
+
+// bVLbṼt@C`
+// wb_̌ɊeXg[glBufferDataɂ̂܂ܓn`ŕ
+// `ςMeshCacheVersionグ邱
+const uint32_t MeshCacheMagic = 0x4853454D; // "MESH"
+const uint32_t MeshCacheVersion = 4;
+const uint64_t MeshCacheAlignment = 16;
+
+enum MeshStream : uint32_t
+{
+	MeshStreamPositions,  // MeshPositionFormat (ẽpX͂ꂾǂ)
+	MeshStreamAttributes, // PackedVertexAttributes
+	MeshStreamIndices,
+	MeshStreamCount,
+};
+
+struct MeshCacheStreamRange
+{
+	uint64_t offset;
+	uint64_t size;
+};
+
+struct MeshCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash;
+	uint64_t sourceSize;
+	uint32_t vertexCount;
+	uint32_t indexCount;
+	uint32_t indexSize; // 2 or 4
+	uint32_t positionFormat; // MeshPositionFormat
+	float positionOffset[3];
+	float positionScale[3];
+	uint32_t streamCount;
+	MeshCacheStreamRange streams[MeshStreamCount];
+};
+
+// }bvLbVt@C (݂Ɏsꍇ̓̃obt@)
+struct MeshCache
+{
+	MappedFile file;
+	std::vector<char> memory;
+	const MeshCacheHeader* header = nullptr;
+
+	const char* data() const
+	{
+		return file.isOpen() ? file.data() : memory.data();
+	}
+
+	const void* stream(MeshStream stream) const
+	{
+		return data() + header->streams[stream].offset;
+	}
+
+	size_t streamSize(MeshStream stream) const
+	{
+		return static_cast<size_t>(header->streams[stream].size);
+	}
+
+	PositionQuantization positionQuantization() const
+	{
+		PositionQuantization quantization;
+		quantization.offset = glm::vec3(header->positionOffset[0], header->positionOffset[1], header->positionOffset[2]);
+		quantization.scale = glm::vec3(header->positionScale[0], header->positionScale[1], header->positionScale[2]);
+		return quantization;
+	}
+};
+
+inline uint64_t alignMeshCacheOffset(uint64_t offset)
+{
+	return (offset + MeshCacheAlignment - 1) / MeshCacheAlignment * MeshCacheAlignment;
+}
+
+// wb_ƊeXg[͈̔͂t@CɎ܂Ă邩AXg[̑傫_ƃCfbNXɍĂ邩mF
+inline bool validateMeshCache(const char* data, size_t size, uint64_t sourceHash, uint64_t sourceSize, MeshPositionFormat positionFormat)
+{
+	if (size < sizeof(MeshCacheHeader))
+	{
+		return false;
+	}
+	const auto header = reinterpret_cast<const MeshCacheHeader*>(data);
+	if (header->magic != MeshCacheMagic || header->version != MeshCacheVersion || header->streamCount != MeshStreamCount)
+	{
+		return false;
+	}
+	if (header->sourceHash != sourceHash || header->sourceSize != sourceSize || header->positionFormat != positionFormat)
+	{
+		return false;
+	}
+	if (header->indexSize != 2 && header->indexSize != 4)
+	{
+		return false;
+	}
+	const uint64_t sizes[MeshStreamCount] = {
+		uint64_t(header->vertexCount) * positionStride(positionFormat),
+		uint64_t(header->vertexCount) * sizeof(PackedVertexAttributes),
+		uint64_t(header->indexCount) * header->indexSize,
+	};
+	for (uint32_t i = 0; i < MeshStreamCount; i++)
+	{
+		const auto& range = header->streams[i];
+		if (range.size != sizes[i] || range.offset > size || range.size > size - range.offset)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// ObjMeshLbVt@Č`ɕׂ
+// CfbNX͒_65536Ȃ16bitɂ
+// _VertexFormat.ḧk`ɕϊ
+inline std::vector<char> serializeMeshCache(const ObjMesh& mesh, uint64_t sourceHash, uint64_t sourceSize, MeshPositionFormat positionFormat)
+{
+	MeshCacheHeader header{};
+	header.magic = MeshCacheMagic;
+	header.version = MeshCacheVersion;
+	header.sourceHash = sourceHash;
+	header.sourceSize = sourceSize;
+	header.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+	header.indexCount = static_cast<uint32_t>(mesh.indices.size());
+	header.indexSize = mesh.vertices.size() <= 0xFFFF ? 2 : 4;
+	header.positionFormat = positionFormat;
+	header.streamCount = MeshStreamCount;
+
+	const PositionQuantization quantization = positionFormat == MeshPositionUnorm16 ? computePositionQuantization(mesh.vertices) : PositionQuantization();
+	for (int i = 0; i < 3; i++)
+	{
+		header.positionOffset[i] = quantization.offset[i];
+		header.positionScale[i] = quantization.scale[i];
+	}
+
+	const uint64_t sizes[MeshStreamCount] = {
+		mesh.vertices.size() * positionStride(positionFormat),
+		mesh.vertices.size() * sizeof(PackedVertexAttributes),
+		mesh.indices.size() * header.indexSize,
+	};
+	uint64_t offset = alignMeshCacheOffset(sizeof(MeshCacheHeader));
+	for (uint32_t i = 0; i < MeshStreamCount; i++)
+	{
+		header.streams[i] = { offset, sizes[i] };
+		offset = alignMeshCacheOffset(offset + sizes[i]);
+	}
+
+	std::vector<char> buffer(static_cast<size_t>(offset), 0);
+	std::memcpy(buffer.data(), &header, sizeof(header));
+	const auto write = [&](MeshStream stream, const void* src) {
+		std::memcpy(buffer.data() + header.streams[stream].offset, src, static_cast<size_t>(header.streams[stream].size));
+	};
+	if (positionFormat == MeshPositionUnorm16)
+	{
+		std::vector<QuantizedPosition> positions(mesh.vertices.size());
+		for (size_t i = 0; i < positions.size(); i++)
+		{
+			positions[i] = quantizePosition(mesh.vertices[i], quantization);
+		}
+		write(MeshStreamPositions, positions.data());
+	}
+	else
+	{
+		write(MeshStreamPositions, mesh.vertices.data());
+	}
+
+	std::vector<PackedVertexAttributes> attributes(mesh.vertices.size());
+	for (size_t i = 0; i < attributes.size(); i++)
+	{
+		attributes[i] = packVertexAttributes(mesh.uvs[i], mesh.normals[i], glm::vec3(mesh.tangents[i]), mesh.tangents[i].w);
+	}
+	write(MeshStreamAttributes, attributes.data());
+	if (header.indexSize == 2)
+	{
+		const std::vector<uint16_t> indices(mesh.indices.begin(), mesh.indices.end());
+		write(MeshStreamIndices, indices.data());
+	}
+	else
+	{
+		write(MeshStreamIndices, mesh.indices.data());
+	}
+	return buffer;
+}
+
+inline bool openMeshCache(const std::string& cachePath, uint64_t sourceHash, uint64_t sourceSize, MeshPositionFormat positionFormat, MeshCache& out)
+{
+	MappedFile file;
+	if (!file.open(cachePath) || !validateMeshCache(file.data(), file.size(), sourceHash, sourceSize, positionFormat))
+	{
+		return false;
+	}
+	out.memory.clear();
+	out.file = std::move(file);
+	out.header = reinterpret_cast<const MeshCacheHeader*>(out.file.data());
+	return true;
+}
+
+// OBJt@Cǂݍ݁A"<path>.meshcache"ɃLbVo
+// Op`ƒ_̏optimizeMeshŕבւĂۑ
+// 2ڈȍ~̓\[Xt@C̃nbVv΃LbV}bv邾ōς
+// LbVȂꏊł̓̃obt@̂܂܎g
+// positionFormatقȂLbV͍蒼
+inline bool loadOBJCached(const std::string& path, MeshCache& out, bool* cacheHit = nullptr, MeshPositionFormat positionFormat = MeshPositionUnorm16)
+{
+	MappedFile source;
+	if (!source.open(path))
+	{
+		std::cerr << "Can't open obj file: " << path << std::endl;
+		return false;
+	}
+	const uint64_t sourceHash = hashBytes(source.data(), source.size());
+	const std::string cachePath = path + ".meshcache";
+
+	if (openMeshCache(cachePath, sourceHash, source.size(), positionFormat, out))
+	{
+		if (cacheHit != nullptr) *cacheHit = true;
+		return true;
+	}
+	if (cacheHit != nullptr) *cacheHit = false;
+
+	ObjData obj;
+	ObjMesh mesh;
+	if (!parseOBJParallel(source.data(), source.data() + source.size(), objParseThreadCount(source.size()), obj) || !buildOBJMesh(obj, mesh))
+	{
+		return false;
+	}
+	optimizeMesh(mesh);
+
+	auto buffer = serializeMeshCache(mesh, sourceHash, source.size(), positionFormat);
+	{
+		std::ofstream ofs(cachePath, std::ios::binary | std::ios::trunc);
+		ofs.write(buffer.data(), buffer.size());
+		if (ofs.fail())
+		{
+			std::cerr << "Can't write mesh cache: " << cachePath << std::endl;
+		}
+	}
+	if (openMeshCache(cachePath, sourceHash, source.size(), positionFormat, out))
+	{
+		return true;
+	}
+
+	std::remove(cachePath.c_str());
+	out.file.close();
+	out.memory = std::move(buffer);
+	out.header = reinterpret_cast<const MeshCacheHeader*>(out.memory.data());
+	return true;
+}
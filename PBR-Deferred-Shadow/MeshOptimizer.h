@@ -0,0 +1,443 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "ObjLoader.h"
+
+// CfbNXbV̎Op`ƒ_̕ёւ
+// 1. optimizeVertexCache: _ϊLbṼqbgグ (Tipsify, Sander et al. 2007)
+// 2. optimizeOverdraw: TipsifỹNX^Ô̂`悤ɕׂăI[o[h[炷
+// 3. optimizeVertexFetch: _߂ĎQƂ鏇ɕׂătFb`̋Ǐグ
+
+const unsigned int VertexCacheSize = 16;
+const float OverdrawThreshold = 1.05f; // NX^ACMR̈
+
+// FIFO̒_ϊLbVV~[V
+// ACMR: Op`̒_ϊ (0.5`3.0)AATVR: _̕ϊ (1.0ŏ)
+struct VertexCacheStatistics
+{
+	unsigned int vertexTransforms = 0;
+	float acmr = 0.0f;
+	float atvr = 0.0f;
+};
+
+inline VertexCacheStatistics analyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize = VertexCacheSize)
+{
+	VertexCacheStatistics statistics;
+	std::vector<unsigned int> timestamps(vertexCount, 0);
+	unsigned int timestamp = cacheSize + 1;
+	for (const auto index : indices)
+	{
+		if (timestamp - timestamps[index] > cacheSize)
+		{
+			timestamps[index] = timestamp++;
+			statistics.vertexTransforms++;
+		}
+	}
+	if (!indices.empty())
+	{
+		statistics.acmr = float(statistics.vertexTransforms) / float(indices.size() / 3);
+	}
+	if (vertexCount > 0)
+	{
+		statistics.atvr = float(statistics.vertexTransforms) / float(vertexCount);
+	}
+	return statistics;
+}
+
+// 6̐ˉeŎOp`ȃobt@ɃX^CYA
+// [xeXgʂsNZ / ŏIIɕꂽsNZI[o[h[Ƃ
+struct OverdrawStatistics
+{
+	unsigned int pixelsCovered = 0;
+	unsigned int pixelsShaded = 0;
+	float overdraw = 0.0f;
+};
+
+inline OverdrawStatistics analyzeOverdraw(const std::vector<unsigned int>& indices, const std::vector<glm::vec3>& vertices, int resolution = 256)
+{
+	OverdrawStatistics statistics;
+	if (vertices.empty())
+	{
+		return statistics;
+	}
+	glm::vec3 minimum = vertices[0];
+	glm::vec3 maximum = vertices[0];
+	for (const auto& v : vertices)
+	{
+		minimum = glm::min(minimum, v);
+		maximum = glm::max(maximum, v);
+	}
+	const glm::vec3 extent = maximum - minimum;
+	const float scale = float(resolution - 1) / std::max({ extent.x, extent.y, extent.z, 1e-6f });
+
+	std::vector<float> depthBuffer(size_t(resolution) * resolution);
+	for (int axis = 0; axis < 3; axis++)
+	{
+		for (const float direction : { 1.0f, -1.0f })
+		{
+			std::fill(depthBuffer.begin(), depthBuffer.end(), std::numeric_limits<float>::infinity());
+			const int u = (axis + 1) % 3;
+			const int v = (axis + 2) % 3;
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				const glm::vec3 p0 = vertices[indices[i]];
+				const glm::vec3 p1 = vertices[indices[i + 1]];
+				const glm::vec3 p2 = vertices[indices[i + 2]];
+				// ʂ̓JO
+				if (glm::cross(p1 - p0, p2 - p0)[axis] * direction >= 0.0f)
+				{
+					continue;
+				}
+				const glm::vec3 s0((p0[u] - minimum[u]) * scale, (p0[v] - minimum[v]) * scale, p0[axis] * direction);
+				const glm::vec3 s1((p1[u] - minimum[u]) * scale, (p1[v] - minimum[v]) * scale, p1[axis] * direction);
+				const glm::vec3 s2((p2[u] - minimum[u]) * scale, (p2[v] - minimum[v]) * scale, p2[axis] * direction);
+				const float area = (s1.x - s0.x) * (s2.y - s0.y) - (s1.y - s0.y) * (s2.x - s0.x);
+				if (area == 0.0f)
+				{
+					continue;
+				}
+				const int x0 = std::max(0, int(std::ceil(std::min({ s0.x, s1.x, s2.x }) - 0.5f)));
+				const int x1 = std::min(resolution - 1, int(std::floor(std::max({ s0.x, s1.x, s2.x }) - 0.5f)));
+				const int y0 = std::max(0, int(std::ceil(std::min({ s0.y, s1.y, s2.y }) - 0.5f)));
+				const int y1 = std::min(resolution - 1, int(std::floor(std::max({ s0.y, s1.y, s2.y }) - 0.5f)));
+				for (int y = y0; y <= y1; y++)
+				{
+					for (int x = x0; x <= x1; x++)
+					{
+						const float px = x + 0.5f;
+						const float py = y + 0.5f;
+						const float w0 = ((s1.x - px) * (s2.y - py) - (s1.y - py) * (s2.x - px)) / area;
+						const float w1 = ((s2.x - px) * (s0.y - py) - (s2.y - py) * (s0.x - px)) / area;
+						const float w2 = 1.0f - w0 - w1;
+						if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+						{
+							continue;
+						}
+						const float depth = w0 * s0.z + w1 * s1.z + w2 * s2.z;
+						float& stored = depthBuffer[size_t(y) * resolution + x];
+						if (depth < stored)
+						{
+							stored = depth;
+							statistics.pixelsShaded++;
+						}
+					}
+				}
+			}
+			for (const float depth : depthBuffer)
+			{
+				statistics.pixelsCovered += depth != std::numeric_limits<float>::infinity();
+			}
+		}
+	}
+	if (statistics.pixelsCovered > 0)
+	{
+		statistics.overdraw = float(statistics.pixelsShaded) / float(statistics.pixelsCovered);
+	}
+	return statistics;
+}
+
+// TipsifyŎOp`ёւ
+// s~܂肩ʂ̏ꏊɔ񂾈ʒu (Op`ԍ) hardBoundariesɕԂ
+inline void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, std::vector<unsigned int>* hardBoundaries = nullptr, unsigned int cacheSize = VertexCacheSize)
+{
+	const size_t triangleCount = indices.size() / 3;
+	if (hardBoundaries != nullptr)
+	{
+		hardBoundaries->clear();
+	}
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// _ -> Op`̗אڃXg (CSR)
+	std::vector<unsigned int> liveTriangles(vertexCount, 0);
+	for (const auto index : indices)
+	{
+		liveTriangles[index]++;
+	}
+	std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+	}
+	std::vector<unsigned int> adjacency(indices.size());
+	{
+		std::vector<unsigned int> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			adjacency[cursor[indices[i]]++] = static_cast<unsigned int>(i / 3);
+		}
+	}
+
+	std::vector<unsigned int> timestamps(vertexCount, 0);
+	std::vector<char> emitted(triangleCount, 0);
+	std::vector<unsigned int> deadEnd;
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	unsigned int timestamp = cacheSize + 1;
+	size_t cursor = 0;
+
+	// s~܂X^bNA܂Op`̎cĂ钸_擪T
+	const auto skipDeadEnd = [&]() -> long long {
+		while (!deadEnd.empty())
+		{
+			const unsigned int v = deadEnd.back();
+			deadEnd.pop_back();
+			if (liveTriangles[v] > 0)
+			{
+				return v;
+			}
+		}
+		while (cursor < vertexCount)
+		{
+			if (liveTriangles[cursor] > 0)
+			{
+				return static_cast<long long>(cursor);
+			}
+			cursor++;
+		}
+		return -1;
+	};
+
+	long long fanning = skipDeadEnd();
+	while (fanning >= 0)
+	{
+		candidates.clear();
+		for (unsigned int a = adjacencyOffsets[fanning]; a < adjacencyOffsets[fanning + 1]; a++)
+		{
+			const unsigned int triangle = adjacency[a];
+			if (emitted[triangle])
+			{
+				continue;
+			}
+			for (int k = 0; k < 3; k++)
+			{
+				const unsigned int v = indices[triangle * 3 + k];
+				result.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				liveTriangles[v]--;
+				if (timestamp - timestamps[v] > cacheSize)
+				{
+					timestamps[v] = timestamp++;
+				}
+			}
+			emitted[triangle] = 1;
+		}
+
+		// LbVɎcĂāAOp`oĂLbVǂoȂ_̂ԌÂ
+		long long next = -1;
+		unsigned int bestPriority = 0;
+		for (const auto v : candidates)
+		{
+			if (liveTriangles[v] == 0)
+			{
+				continue;
+			}
+			unsigned int priority = 0;
+			if (timestamp - timestamps[v] + 2 * liveTriangles[v] <= cacheSize)
+			{
+				priority = timestamp - timestamps[v];
+			}
+			if (priority > bestPriority)
+			{
+				bestPriority = priority;
+				next = v;
+			}
+		}
+		if (next < 0)
+		{
+			next = skipDeadEnd();
+			if (next >= 0 && hardBoundaries != nullptr && result.size() < indices.size())
+			{
+				hardBoundaries->push_back(static_cast<unsigned int>(result.size() / 3));
+			}
+		}
+		fanning = next;
+	}
+	indices.swap(result);
+}
+
+// TipsifỹNX^AACMRthreshold{ȏ㈫Ȃ͈͂łɍׂ
+inline std::vector<unsigned int> splitVertexCacheClusters(const std::vector<unsigned int>& indices, size_t vertexCount, const std::vector<unsigned int>& hardBoundaries, float threshold, unsigned int cacheSize = VertexCacheSize)
+{
+	const unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+	std::vector<unsigned int> hard;
+	hard.push_back(0);
+	for (const auto boundary : hardBoundaries)
+	{
+		if (boundary > hard.back() && boundary < triangleCount)
+		{
+			hard.push_back(boundary);
+		}
+	}
+	hard.push_back(triangleCount);
+
+	std::vector<unsigned int> timestamps(vertexCount, 0);
+	unsigned int timestamp = cacheSize + 1;
+	const auto countMisses = [&](unsigned int triangle) {
+		unsigned int misses = 0;
+		for (int k = 0; k < 3; k++)
+		{
+			const unsigned int v = indices[triangle * 3 + k];
+			if (timestamp - timestamps[v] > cacheSize)
+			{
+				timestamps[v] = timestamp++;
+				misses++;
+			}
+		}
+		return misses;
+	};
+	// LbVɂ
+	const auto flush = [&]() { timestamp += cacheSize + 1; };
+
+	std::vector<unsigned int> clusters;
+	for (size_t c = 0; c + 1 < hard.size(); c++)
+	{
+		const unsigned int begin = hard[c];
+		const unsigned int end = hard[c + 1];
+
+		flush();
+		unsigned int clusterMisses = 0;
+		for (unsigned int t = begin; t < end; t++)
+		{
+			clusterMisses += countMisses(t);
+		}
+		const float clusterThreshold = threshold * float(clusterMisses) / float(end - begin);
+
+		flush();
+		unsigned int start = begin;
+		unsigned int misses = 0;
+		clusters.push_back(begin);
+		for (unsigned int t = begin; t < end; t++)
+		{
+			misses += countMisses(t);
+			if (t + 1 < end && float(misses) / float(t - start + 1) <= clusterThreshold)
+			{
+				// Ő؂ĂACMRe͈͂Ȃ̂ŐVNX^n߂
+				clusters.push_back(t + 1);
+				start = t + 1;
+				misses = 0;
+				flush();
+			}
+		}
+	}
+	return clusters;
+}
+
+// NX^Ô (bV̒S猩Ė@OAɂ) `悤ɕׂ
+inline void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& clusters)
+{
+	const unsigned int triangleCount = static_cast<unsigned int>(indices.size() / 3);
+	if (triangleCount == 0 || clusters.empty())
+	{
+		return;
+	}
+
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+	for (unsigned int t = 0; t < triangleCount; t++)
+	{
+		const glm::vec3& p0 = vertices[indices[t * 3]];
+		const glm::vec3& p1 = vertices[indices[t * 3 + 1]];
+		const glm::vec3& p2 = vertices[indices[t * 3 + 2]];
+		const float area = glm::length(glm::cross(p1 - p0, p2 - p0));
+		meshCentroid += (p0 + p1 + p2) * (area / 3.0f);
+		meshArea += area;
+	}
+	meshCentroid /= std::max(meshArea, 1e-20f);
+
+	std::vector<std::pair<float, unsigned int>> sortKeys(clusters.size());
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		const unsigned int begin = clusters[c];
+		const unsigned int end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+		glm::vec3 centroid(0.0f);
+		glm::vec3 normal(0.0f);
+		float area = 0.0f;
+		for (unsigned int t = begin; t < end; t++)
+		{
+			const glm::vec3& p0 = vertices[indices[t * 3]];
+			const glm::vec3& p1 = vertices[indices[t * 3 + 1]];
+			const glm::vec3& p2 = vertices[indices[t * 3 + 2]];
+			const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+			const float a = glm::length(n);
+			centroid += (p0 + p1 + p2) * (a / 3.0f);
+			normal += n;
+			area += a;
+		}
+		centroid /= std::max(area, 1e-20f);
+		const float normalLength = glm::length(normal);
+		normal = normalLength > 0.0f ? normal / normalLength : glm::vec3(0.0f);
+		// 傫ɕׂ̂ŕ𔽓]
+		sortKeys[c] = { -glm::dot(centroid - meshCentroid, normal), static_cast<unsigned int>(c) };
+	}
+	std::stable_sort(sortKeys.begin(), sortKeys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	for (const auto& key : sortKeys)
+	{
+		const unsigned int c = key.second;
+		const unsigned int begin = clusters[c];
+		const unsigned int end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+		result.insert(result.end(), indices.begin() + size_t(begin) * 3, indices.begin() + size_t(end) * 3);
+	}
+	indices.swap(result);
+}
+
+template <typename T>
+void remapVertexStream(std::vector<T>& stream, const std::vector<unsigned int>& remap, size_t newVertexCount)
+{
+	if (stream.empty())
+	{
+		return;
+	}
+	std::vector<T> result(newVertexCount);
+	for (size_t v = 0; v < stream.size(); v++)
+	{
+		if (remap[v] != std::numeric_limits<unsigned int>::max())
+		{
+			result[remap[v]] = stream[v];
+		}
+	}
+	stream.swap(result);
+}
+
+// _CfbNXŏ߂ĎQƂ鏇ɕבւ (QƂȂ_͎菜)
+inline void optimizeVertexFetch(ObjMesh& mesh)
+{
+	std::vector<unsigned int> remap(mesh.vertices.size(), std::numeric_limits<unsigned int>::max());
+	unsigned int vertexCount = 0;
+	for (auto& index : mesh.indices)
+	{
+		if (remap[index] == std::numeric_limits<unsigned int>::max())
+		{
+			remap[index] = vertexCount++;
+		}
+		index = remap[index];
+	}
+	remapVertexStream(mesh.vertices, remap, vertexCount);
+	remapVertexStream(mesh.uvs, remap, vertexCount);
+	remapVertexStream(mesh.normals, remap, vertexCount);
+	remapVertexStream(mesh.tangents, remap, vertexCount);
+}
+
+// C|[g̍œK܂Ƃ߂čs
+inline void optimizeMesh(ObjMesh& mesh)
+{
+	std::vector<unsigned int> hardBoundaries;
+	optimizeVertexCache(mesh.indices, mesh.vertices.size(), &hardBoundaries);
+	const auto clusters = splitVertexCacheClusters(mesh.indices, mesh.vertices.size(), hardBoundaries, OverdrawThreshold);
+	optimizeOverdraw(mesh.indices, mesh.vertices, clusters);
+	optimizeVertexFetch(mesh);
+}
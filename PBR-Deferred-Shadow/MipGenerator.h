@@ -0,0 +1,643 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CpuFeatures.h"
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MIP_GENERATOR_SSE 1
+#include <emmintrin.h>
+#endif
+// AVX2̃J[lx86/x64ȂɃRpCAsCPUΉĂΎg (CpuFeatures.h)
+#if defined(CPU_FEATURES_AVX2)
+#define MIP_GENERATOR_AVX2 1
+#endif
+
+// CPUŃ~bv}bv
+// 8bit̉摜`lƂfloatɓWJAÕx2x2̕ςŎ̃x
+// sRGB: RGB`ɒĂ畽ςAoƂsRGBɖ߂ (At@͐`̂܂)
+// @: [-1, 1]ɒĕςAK (2`lȂZ𕜌Ă畽ς)
+// At@eXgpɃAt@̃JobW (cutoffȏ̊) x0Ƒ邱Ƃł
+// ʂ8bit̂܂܂Ȃ̂ŁAglTexImage2DɂubNkɂ̂܂ܓn
+
+// 1sNZcomponentsoCg8bit摜
+struct BakeImage
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t components = 0;
+	std::vector<uint8_t> pixels;
+};
+
+enum MipFilter
+{
+	MipFilterLinear,
+	MipFilterSRGB,
+	MipFilterNormal,
+};
+
+enum MipKernel
+{
+	MipKernelScalar,
+	MipKernelSse,
+	MipKernelAvx2,
+};
+
+inline MipKernel bestMipKernel()
+{
+#if defined(MIP_GENERATOR_AVX2)
+	if (cpuSupportsAvx2())
+	{
+		return MipKernelAvx2;
+	}
+#endif
+#if defined(MIP_GENERATOR_SSE)
+	return MipKernelSse;
+#else
+	return MipKernelScalar;
+#endif
+}
+
+struct MipOptions
+{
+	MipFilter filter = MipFilterLinear;
+	bool preserveAlphaCoverage = false; // 4`l̂Ƃ
+	float alphaCutoff = 0.5f;           // GeometryPass.fragdiscardƍ킹
+	MipKernel kernel = bestMipKernel();
+};
+
+inline float srgbToLinear(float c)
+{
+	return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+inline float linearToSrgb(float c)
+{
+	return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+}
+
+inline uint8_t srgbToLinear8(uint8_t value)
+{
+	static const auto table = []() {
+		std::vector<uint8_t> table(256);
+		for (int i = 0; i < 256; i++)
+		{
+			table[i] = static_cast<uint8_t>(srgbToLinear(i / 255.0f) * 255.0f + 0.5f);
+		}
+		return table;
+	}();
+	return table[value];
+}
+
+// 8bitsRGB  `
+inline const float* srgbDecodeTable()
+{
+	static const auto table = []() {
+		std::vector<float> table(256);
+		for (int i = 0; i < 256; i++)
+		{
+			table[i] = srgbToLinear(i / 255.0f);
+		}
+		return table;
+	}();
+	return table.data();
+}
+
+// 16bitɗʎq`̒l  8bitsRGB
+// ÕsRGB1i`1/3300xȂ̂16bitΑ
+const float MipSrgbEncodeScale = 65535.0f;
+inline const uint8_t* srgbEncodeTable()
+{
+	static const auto table = []() {
+		std::vector<uint8_t> table(65536);
+		for (int i = 0; i < 65536; i++)
+		{
+			table[i] = static_cast<uint8_t>(linearToSrgb(i / MipSrgbEncodeScale) * 255.0f + 0.5f);
+		}
+		return table;
+	}();
+	return table.data();
+}
+
+// AVX2OpsgcallMipAvx2()̒ɑSēWĴŁA__m256AVX2LɂĂȂ֐Ƃ̊ԂŎ󂯓n邱Ƃ͂Ȃ
+// GCC͓WJÕev[gɑ΂ABǏxôŗ}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+// SIMDƃXJ[œJ[lg߂̉Z
+// Z𑵂̏Ă̂ŁAǂgĂʂ̓rbgPʂňv
+struct MipScalarOps
+{
+	using F = float;
+	static const size_t width = 1;
+	static F load(const float* p) { return *p; }
+	static void store(float* p, F v) { *p = v; }
+	static void loadEvenOdd(const float* p, F& even, F& odd) { even = p[0]; odd = p[1]; }
+	static F set(float x) { return x; }
+	static F add(F a, F b) { return a + b; }
+	static F mul(F a, F b) { return a * b; }
+	static F div(F a, F b) { return a / b; }
+	static F min(F a, F b) { return b < a ? b : a; }
+	static F max(F a, F b) { return a < b ? b : a; }
+	static F sqrt(F x) { return std::sqrt(x); }
+	// a > bȂxAłȂy
+	static F selectGreater(F a, F b, F x, F y) { return a > b ? x : y; }
+	static size_t countAtLeast(F x, F threshold) { return x >= threshold ? 1 : 0; }
+	static void toInt(F x, int32_t* out) { *out = static_cast<int32_t>(x); }
+	// RGBA8̃sNZchannelo (0`255)
+	static F loadChannel(const uint8_t* rgba, int channel) { return static_cast<float>(rgba[channel]); }
+	static F lookupChannel(const float* table, const uint8_t* rgba, int channel) { return table[rgba[channel]]; }
+};
+
+#ifdef MIP_GENERATOR_SSE
+struct MipSseOps
+{
+	using F = __m128;
+	static const size_t width = 4;
+	static F load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, F v) { _mm_storeu_ps(p, v); }
+	static void loadEvenOdd(const float* p, F& even, F& odd)
+	{
+		const __m128 a = _mm_loadu_ps(p);
+		const __m128 b = _mm_loadu_ps(p + 4);
+		even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+	}
+	static F set(float x) { return _mm_set1_ps(x); }
+	static F add(F a, F b) { return _mm_add_ps(a, b); }
+	static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+	static F div(F a, F b) { return _mm_div_ps(a, b); }
+	static F min(F a, F b) { return _mm_min_ps(a, b); }
+	static F max(F a, F b) { return _mm_max_ps(a, b); }
+	static F sqrt(F x) { return _mm_sqrt_ps(x); }
+	static F selectGreater(F a, F b, F x, F y)
+	{
+		const __m128 mask = _mm_cmpgt_ps(a, b);
+		return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+	}
+	static size_t countAtLeast(F x, F threshold)
+	{
+		const int mask = _mm_movemask_ps(_mm_cmpge_ps(x, threshold));
+		return (mask & 1) + (mask >> 1 & 1) + (mask >> 2 & 1) + (mask >> 3 & 1);
+	}
+	static void toInt(F x, int32_t* out) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_cvttps_epi32(x)); }
+	static __m128i extractChannel(const uint8_t* rgba, int channel)
+	{
+		const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba));
+		return _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(channel * 8)), _mm_set1_epi32(0xFF));
+	}
+	static F loadChannel(const uint8_t* rgba, int channel) { return _mm_cvtepi32_ps(extractChannel(rgba, channel)); }
+	// SSE2ɂgather̂ŕ\XJ[ōs
+	static F lookupChannel(const float* table, const uint8_t* rgba, int channel)
+	{
+		return _mm_setr_ps(table[rgba[channel]], table[rgba[4 + channel]], table[rgba[8 + channel]], table[rgba[12 + channel]]);
+	}
+};
+#endif
+
+#ifdef MIP_GENERATOR_AVX2
+struct MipAvx2Ops
+{
+	using F = __m256;
+	static const size_t width = 8;
+	CPU_AVX2_TARGET static F load(const float* p) { return _mm256_loadu_ps(p); }
+	CPU_AVX2_TARGET static void store(float* p, F v) { _mm256_storeu_ps(p, v); }
+	// shuffle_ps128bitƂȂ̂ŁA64bitPʂŕג
+	CPU_AVX2_TARGET static void loadEvenOdd(const float* p, F& even, F& odd)
+	{
+		const __m256 a = _mm256_loadu_ps(p);
+		const __m256 b = _mm256_loadu_ps(p + 8);
+		const __m256 e = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m256 o = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+		even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(e), _MM_SHUFFLE(3, 1, 2, 0)));
+		odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(o), _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+	CPU_AVX2_TARGET static F set(float x) { return _mm256_set1_ps(x); }
+	CPU_AVX2_TARGET static F add(F a, F b) { return _mm256_add_ps(a, b); }
+	CPU_AVX2_TARGET static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+	CPU_AVX2_TARGET static F div(F a, F b) { return _mm256_div_ps(a, b); }
+	CPU_AVX2_TARGET static F min(F a, F b) { return _mm256_min_ps(a, b); }
+	CPU_AVX2_TARGET static F max(F a, F b) { return _mm256_max_ps(a, b); }
+	CPU_AVX2_TARGET static F sqrt(F x) { return _mm256_sqrt_ps(x); }
+	CPU_AVX2_TARGET static F selectGreater(F a, F b, F x, F y) { return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_GT_OQ)); }
+	CPU_AVX2_TARGET static size_t countAtLeast(F x, F threshold)
+	{
+		const unsigned int mask = static_cast<unsigned int>(_mm256_movemask_ps(_mm256_cmp_ps(x, threshold, _CMP_GE_OQ)));
+		size_t count = 0;
+		for (unsigned int m = mask; m != 0; m &= m - 1)
+		{
+			count++;
+		}
+		return count;
+	}
+	CPU_AVX2_TARGET static void toInt(F x, int32_t* out) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_cvttps_epi32(x)); }
+	CPU_AVX2_TARGET static __m256i extractChannel(const uint8_t* rgba, int channel)
+	{
+		const __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba));
+		return _mm256_and_si256(_mm256_srl_epi32(pixels, _mm_cvtsi32_si128(channel * 8)), _mm256_set1_epi32(0xFF));
+	}
+	CPU_AVX2_TARGET static F loadChannel(const uint8_t* rgba, int channel) { return _mm256_cvtepi32_ps(extractChannel(rgba, channel)); }
+	CPU_AVX2_TARGET static F lookupChannel(const float* table, const uint8_t* rgba, int channel) { return _mm256_i32gather_ps(table, extractChannel(rgba, channel), 4); }
+};
+
+// func̒g (Opsg) AVX2Lɂ1̊֐ɓWJČĂ
+// Xbhɓn֐̒ŌĂԂ (̊OŌĂԂƁAXbhœ͓WJȂ)
+template <typename Func>
+CPU_AVX2_FLATTEN void callMipAvx2(Func&& func)
+{
+	func(MipAvx2Ops());
+}
+#endif
+
+// `lƂfloat̉摜
+struct MipPlanes
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<std::vector<float>> planes;
+
+	float* row(size_t plane, uint32_t y) { return planes[plane].data() + size_t(y) * width; }
+	const float* row(size_t plane, uint32_t y) const { return planes[plane].data() + size_t(y) * width; }
+};
+
+// Ops::widthA[̓XJ[ŏ
+template <typename Ops, typename Step>
+void forEachMipSpan(uint32_t count, Step&& step)
+{
+	uint32_t x = 0;
+	for (; x + Ops::width <= count; x += static_cast<uint32_t>(Ops::width))
+	{
+		step(Ops(), x);
+	}
+	for (; x < count; x++)
+	{
+		step(MipScalarOps(), x);
+	}
+}
+
+template <typename Ops>
+void downsampleMipRow(const float* row0, const float* row1, float* out, uint32_t outWidth, uint32_t srcWidth)
+{
+	if (srcWidth < 2)
+	{
+		out[0] = ((row0[0] + row0[0]) + (row1[0] + row1[0])) * 0.25f;
+		return;
+	}
+	forEachMipSpan<Ops>(outWidth, [&](auto ops, uint32_t x) {
+		using O = decltype(ops);
+		typename O::F e0, o0, e1, o1;
+		O::loadEvenOdd(row0 + x * 2, e0, o0);
+		O::loadEvenOdd(row1 + x * 2, e1, o1);
+		O::store(out + x, O::mul(O::add(O::add(e0, o0), O::add(e1, o1)), O::set(0.25f)));
+	});
+}
+
+// 0̖@(0, 0, 1)ɂ
+template <typename Ops>
+void normalizeMipRow(float* x, float* y, float* z, uint32_t width)
+{
+	forEachMipSpan<Ops>(width, [&](auto ops, uint32_t i) {
+		using O = decltype(ops);
+		const auto vx = O::load(x + i);
+		const auto vy = O::load(y + i);
+		const auto vz = O::load(z + i);
+		const auto lengthSquared = O::add(O::add(O::mul(vx, vx), O::mul(vy, vy)), O::mul(vz, vz));
+		const auto valid = O::set(1e-12f);
+		const auto inverse = O::div(O::set(1.0f), O::sqrt(O::max(lengthSquared, valid)));
+		O::store(x + i, O::selectGreater(lengthSquared, valid, O::mul(vx, inverse), O::set(0.0f)));
+		O::store(y + i, O::selectGreater(lengthSquared, valid, O::mul(vy, inverse), O::set(0.0f)));
+		O::store(z + i, O::selectGreater(lengthSquared, valid, O::mul(vz, inverse), O::set(1.0f)));
+	});
+}
+
+template <typename Ops>
+size_t countMipCoverage(const float* alpha, size_t count, float threshold)
+{
+	size_t covered = 0;
+	forEachMipSpan<Ops>(static_cast<uint32_t>(count), [&](auto ops, uint32_t i) {
+		using O = decltype(ops);
+		covered += O::countAtLeast(O::load(alpha + i), O::set(threshold));
+	});
+	return covered;
+}
+
+// in * multiply + offset[0, 1]Ɏ߁Ascale{Ďľܓɂ
+template <typename Ops>
+void quantizeMipRow(const float* in, int32_t* out, uint32_t width, float multiply, float offset, float scale)
+{
+	forEachMipSpan<Ops>(width, [&](auto ops, uint32_t i) {
+		using O = decltype(ops);
+		const auto v = O::add(O::mul(O::load(in + i), O::set(multiply)), O::set(offset));
+		const auto clamped = O::min(O::max(v, O::set(0.0f)), O::set(1.0f));
+		O::toInt(O::add(O::mul(clamped, O::set(scale)), O::set(0.5f)), out + i);
+	});
+}
+
+class MipGenerator
+{
+public:
+	MipGenerator(const MipOptions& options, ThreadPool* pool)
+		: options(options), pool(pool)
+	{
+	}
+
+	// x0 (imagẽRs[) 1x1܂łԂ
+	std::vector<BakeImage> generate(const BakeImage& image)
+	{
+		std::vector<BakeImage> levels;
+		levels.push_back(image);
+		if (image.width == 0 || image.height == 0)
+		{
+			return levels;
+		}
+		components = image.components;
+		const bool coverage = options.preserveAlphaCoverage && components == 4;
+		float coverageRatio = 0.0f;
+		if (coverage)
+		{
+			size_t covered = 0;
+			for (size_t i = 3; i < image.pixels.size(); i += 4)
+			{
+				covered += image.pixels[i] / 255.0f >= options.alphaCutoff ? 1 : 0;
+			}
+			coverageRatio = float(covered) / (image.pixels.size() / 4);
+		}
+		MipPlanes current;
+		while (levels.back().width > 1 || levels.back().height > 1)
+		{
+			MipPlanes next = levels.size() == 1 ? downsampleImage(image) : downsample(current);
+			// ̃x͊g傷ÕAt@
+			const float alphaScale = coverage ? coverageAlphaScale(next, coverageRatio) : 1.0f;
+			levels.push_back(encode(next, alphaScale));
+			current = std::move(next);
+		}
+		return levels;
+	}
+
+private:
+	bool isNormal() const
+	{
+		return options.filter == MipFilterNormal;
+	}
+
+	bool isSRGBChannel(size_t channel) const
+	{
+		return options.filter == MipFilterSRGB && channel < 3;
+	}
+
+	// @2`lłZ
+	size_t planeCount() const
+	{
+		return isNormal() && components == 2 ? 3 : components;
+	}
+
+	template <typename Func>
+	void forEachRow(uint32_t rows, uint32_t width, Func&& func)
+	{
+		const size_t grain = std::max<size_t>(1, 32768 / std::max(1u, width));
+		if (pool != nullptr)
+		{
+			parallelFor(*pool, rows, grain, [&](size_t begin, size_t end) {
+				for (size_t y = begin; y < end; y++)
+				{
+					func(static_cast<uint32_t>(y));
+				}
+			});
+		}
+		else
+		{
+			for (uint32_t y = 0; y < rows; y++)
+			{
+				func(y);
+			}
+		}
+	}
+
+	template <typename Func>
+	void dispatch(Func&& func)
+	{
+		switch (options.kernel)
+		{
+#ifdef MIP_GENERATOR_AVX2
+		case MipKernelAvx2:
+			callMipAvx2(func);
+			return;
+#endif
+#ifdef MIP_GENERATOR_SSE
+		case MipKernelSse:
+			func(MipSseOps());
+			return;
+#endif
+		default:
+			func(MipScalarOps());
+			return;
+		}
+	}
+
+	// 8bit1sv[ƂfloatɓWJ (out: planeCount() x width)
+	// RGBA̓sNZPʂSIMDɍڂAȊO̓XJ[œWJ
+	template <typename Ops>
+	void decodeRow(const BakeImage& image, uint32_t y, float* out) const
+	{
+		const uint8_t* src = &image.pixels[size_t(y) * image.width * components];
+		const float* srgb = srgbDecodeTable();
+		if (components == 4)
+		{
+			const bool srgbColor = options.filter == MipFilterSRGB;
+			const bool normal = isNormal();
+			forEachMipSpan<Ops>(image.width, [&](auto ops, uint32_t x) {
+				using O = decltype(ops);
+				const uint8_t* pixels = src + size_t(x) * 4;
+				for (int c = 0; c < 4; c++)
+				{
+					float* dst = out + c * image.width + x;
+					if (srgbColor && c < 3)
+					{
+						O::store(dst, O::lookupChannel(srgb, pixels, c));
+						continue;
+					}
+					const auto value = O::div(O::loadChannel(pixels, c), O::set(255.0f));
+					O::store(dst, normal && c < 3 ? O::add(O::mul(value, O::set(2.0f)), O::set(-1.0f)) : value);
+				}
+			});
+			return;
+		}
+		for (size_t c = 0; c < components; c++)
+		{
+			float* dst = out + c * image.width;
+			if (isNormal())
+			{
+				for (uint32_t x = 0; x < image.width; x++)
+				{
+					dst[x] = src[x * components + c] / 255.0f * 2.0f + -1.0f;
+				}
+			}
+			else
+			{
+				for (uint32_t x = 0; x < image.width; x++)
+				{
+					dst[x] = src[x * components + c] / 255.0f;
+				}
+			}
+		}
+		if (isNormal() && components == 2)
+		{
+			const float* nx = out;
+			const float* ny = out + image.width;
+			float* nz = out + 2 * image.width;
+			for (uint32_t x = 0; x < image.width; x++)
+			{
+				nz[x] = std::sqrt(std::max(1.0f - nx[x] * nx[x] - ny[x] * ny[x], 0.0f));
+			}
+		}
+	}
+
+	MipPlanes allocateNextLevel(uint32_t width, uint32_t height) const
+	{
+		MipPlanes dst;
+		dst.width = std::max(1u, width / 2);
+		dst.height = std::max(1u, height / 2);
+		dst.planes.assign(planeCount(), std::vector<float>(size_t(dst.width) * dst.height));
+		return dst;
+	}
+
+	// ̃x2s (v[Ƃ̐擪) 𕽋ςdstysڂ
+	template <typename O>
+	void reduceRows(const float* const* row0, const float* const* row1, uint32_t srcWidth, MipPlanes& dst, uint32_t y) const
+	{
+		for (size_t c = 0; c < dst.planes.size(); c++)
+		{
+			downsampleMipRow<O>(row0[c], row1[c], dst.row(c, y), dst.width, srcWidth);
+		}
+		if (isNormal())
+		{
+			normalizeMipRow<O>(dst.row(0, y), dst.row(1, y), dst.row(2, y), dst.width);
+		}
+	}
+
+	// x0float̉摜ۂƍ炸A2sWJȂk
+	// (x0float̓шłH)
+	MipPlanes downsampleImage(const BakeImage& image)
+	{
+		MipPlanes dst = allocateNextLevel(image.width, image.height);
+		const size_t planes = planeCount();
+		forEachRow(dst.height, dst.width, [&](uint32_t y) {
+			dispatch([&](auto ops) {
+				using O = decltype(ops);
+				std::vector<float> buffer(planes * image.width * 2);
+				decodeRow<O>(image, std::min(y * 2, image.height - 1), buffer.data());
+				decodeRow<O>(image, std::min(y * 2 + 1, image.height - 1), buffer.data() + planes * image.width);
+				std::vector<const float*> row0(planes);
+				std::vector<const float*> row1(planes);
+				for (size_t c = 0; c < planes; c++)
+				{
+					row0[c] = buffer.data() + c * image.width;
+					row1[c] = buffer.data() + (planes + c) * image.width;
+				}
+				reduceRows<O>(row0.data(), row1.data(), image.width, dst, y);
+			});
+		});
+		return dst;
+	}
+
+	MipPlanes downsample(const MipPlanes& src)
+	{
+		MipPlanes dst = allocateNextLevel(src.width, src.height);
+		forEachRow(dst.height, dst.width, [&](uint32_t y) {
+			dispatch([&](auto ops) {
+				using O = decltype(ops);
+				const uint32_t y0 = std::min(y * 2, src.height - 1);
+				const uint32_t y1 = std::min(y * 2 + 1, src.height - 1);
+				std::vector<const float*> row0(src.planes.size());
+				std::vector<const float*> row1(src.planes.size());
+				for (size_t c = 0; c < src.planes.size(); c++)
+				{
+					row0[c] = src.row(c, y0);
+					row1[c] = src.row(c, y1);
+				}
+				reduceRows<O>(row0.data(), row1.data(), src.width, dst, y);
+			});
+		});
+		return dst;
+	}
+
+	size_t countCoverage(const std::vector<float>& alpha, float threshold)
+	{
+		size_t covered = 0;
+		dispatch([&](auto ops) { covered = countMipCoverage<decltype(ops)>(alpha.data(), alpha.size(), threshold); });
+		return covered;
+	}
+
+	// JobWx0ƓɂȂ邵l񕪒TAꂪcutoffɂȂAt@̔{Ԃ
+	// (Castano, "Computing Alpha Mipmaps")
+	float coverageAlphaScale(const MipPlanes& level, float coverageRatio)
+	{
+		const std::vector<float>& alpha = level.planes[3];
+		const size_t target = static_cast<size_t>(coverageRatio * alpha.size() + 0.5f);
+		float low = 0.0f;
+		float high = 1.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			const float middle = (low + high) * 0.5f;
+			if (countCoverage(alpha, middle) > target)
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		const float threshold = (low + high) * 0.5f;
+		return threshold > 0.0f ? options.alphaCutoff / threshold : 1.0f;
+	}
+
+	BakeImage encode(const MipPlanes& planes, float alphaScale)
+	{
+		BakeImage image;
+		image.width = planes.width;
+		image.height = planes.height;
+		image.components = components;
+		image.pixels.resize(size_t(image.width) * image.height * components);
+		const uint8_t* srgb = srgbEncodeTable();
+		forEachRow(image.height, image.width, [&](uint32_t y) {
+			dispatch([&](auto ops) {
+				using O = decltype(ops);
+				std::vector<int32_t> quantized(image.width);
+				uint8_t* dst = &image.pixels[size_t(y) * image.width * components];
+				for (size_t c = 0; c < components; c++)
+				{
+					const bool srgbChannel = isSRGBChannel(c);
+					const bool normalChannel = isNormal() && c < 3;
+					// @[-1, 1][0, 1]ɖ߂Ăʎq
+					const float multiply = normalChannel ? 0.5f : c == 3 ? alphaScale : 1.0f;
+					quantizeMipRow<O>(planes.row(c, y), quantized.data(), image.width, multiply, normalChannel ? 0.5f : 0.0f, srgbChannel ? MipSrgbEncodeScale : 255.0f);
+					for (uint32_t x = 0; x < image.width; x++)
+					{
+						dst[x * components + c] = srgbChannel ? srgb[quantized[x]] : static_cast<uint8_t>(quantized[x]);
+					}
+				}
+			});
+		});
+		return image;
+	}
+
+	MipOptions options;
+	ThreadPool* pool;
+	size_t components = 0;
+};
+
+inline std::vector<BakeImage> generateMipChain(const BakeImage& image, const MipOptions& options, ThreadPool* pool = nullptr)
+{
+	return MipGenerator(options, pool).generate(image);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
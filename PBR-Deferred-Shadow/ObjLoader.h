@@ -0,0 +1,343 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <glm.hpp>
+
+#include "TangentSpace.h"
+
+// OBJ̖ʂ\钸_̃CfbNX (1n܂)
+struct ObjIndex
+{
+	unsigned int vertex;
+	unsigned int uv;
+	unsigned int normal;
+};
+
+// p[XOBJt@C̒g
+struct ObjData
+{
+	std::vector<glm::vec3> vertices;
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> normals;
+	std::vector<ObjIndex> indices;
+};
+
+inline bool operator==(const ObjIndex& a, const ObjIndex& b)
+{
+	return a.vertex == b.vertex && a.uv == b.uv && a.normal == b.normal;
+}
+
+struct ObjIndexHash
+{
+	size_t operator()(const ObjIndex& index) const
+	{
+		size_t hash = index.vertex;
+		hash = hash * 0x9E3779B1u ^ index.uv;
+		hash = hash * 0x9E3779B1u ^ index.normal;
+		return hash;
+	}
+};
+
+// (v, vt, vn)̑g̏d_ƃCfbNXȂ郁bV
+struct ObjMesh
+{
+	std::vector<glm::vec3> vertices;
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> normals;
+	std::vector<glm::vec4> tangents; // w: nhlX
+	std::vector<unsigned int> indices;
+};
+
+// t@CŜ1̃obt@ɓǂݍ
+inline bool readFileToBuffer(const std::string& path, std::vector<char>& buffer)
+{
+	std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+	if (ifs.fail())
+	{
+		return false;
+	}
+	const auto size = static_cast<std::streamsize>(ifs.tellg());
+	buffer.resize(static_cast<size_t>(size));
+	ifs.seekg(0);
+	ifs.read(buffer.data(), size);
+	return !ifs.fail();
+}
+
+inline bool isObjSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char* skipObjSpaces(const char* p, const char* end)
+{
+	while (p < end && isObjSpace(*p)) ++p;
+	return p;
+}
+
+inline bool parseObjFloat(const char*& p, const char* end, float& out)
+{
+	p = skipObjSpaces(p, end);
+	const auto [ptr, ec] = std::from_chars(p, end, out);
+	if (ec != std::errc()) return false;
+	p = ptr;
+	return true;
+}
+
+// "v/vt/vn" `̒_1ǂ
+inline bool parseObjIndex(const char*& p, const char* end, ObjIndex& out)
+{
+	p = skipObjSpaces(p, end);
+	auto result = std::from_chars(p, end, out.vertex);
+	if (result.ec != std::errc() || result.ptr == end || *result.ptr != '/') return false;
+	result = std::from_chars(result.ptr + 1, end, out.uv);
+	if (result.ec != std::errc() || result.ptr == end || *result.ptr != '/') return false;
+	result = std::from_chars(result.ptr + 1, end, out.normal);
+	if (result.ec != std::errc()) return false;
+	p = result.ptr;
+	return true;
+}
+
+// obt@ł̂܂܃g[N؂oăp[X
+// sƂ̃mۂ͍sȂ
+// fileBegin̓G[̍sԍ̌vZɎg
+inline bool parseOBJChunk(const char* fileBegin, const char* begin, const char* end, ObjData& out)
+{
+	const char* line = begin;
+	while (line < end)
+	{
+		const char* lineEnd = static_cast<const char*>(std::memchr(line, '\n', end - line));
+		if (lineEnd == nullptr) lineEnd = end;
+
+		const char* p = skipObjSpaces(line, lineEnd);
+		const char* keywordEnd = p;
+		while (keywordEnd < lineEnd && !isObjSpace(*keywordEnd)) ++keywordEnd;
+		const std::string_view keyword(p, keywordEnd - p);
+		p = keywordEnd;
+
+		bool ok = true;
+		if (keyword == "v")
+		{
+			glm::vec3 v;
+			ok = parseObjFloat(p, lineEnd, v.x) && parseObjFloat(p, lineEnd, v.y) && parseObjFloat(p, lineEnd, v.z);
+			out.vertices.push_back(v);
+		}
+		else if (keyword == "vt")
+		{
+			glm::vec2 uv;
+			ok = parseObjFloat(p, lineEnd, uv.x) && parseObjFloat(p, lineEnd, uv.y);
+			out.uvs.push_back(uv);
+		}
+		else if (keyword == "vn")
+		{
+			glm::vec3 n;
+			ok = parseObjFloat(p, lineEnd, n.x) && parseObjFloat(p, lineEnd, n.y) && parseObjFloat(p, lineEnd, n.z);
+			out.normals.push_back(n);
+		}
+		else if (keyword == "f")
+		{
+			ObjIndex i0, i1, i2;
+			ok = parseObjIndex(p, lineEnd, i0) && parseObjIndex(p, lineEnd, i1) && parseObjIndex(p, lineEnd, i2);
+			out.indices.push_back(i0);
+			out.indices.push_back(i1);
+			out.indices.push_back(i2);
+		}
+
+		if (!ok)
+		{
+			const auto lineNumber = std::count(fileBegin, line, '\n') + 1;
+			std::cerr << "Can't parse obj line " << lineNumber << ": " << std::string_view(line, lineEnd - line) << std::endl;
+			return false;
+		}
+
+		line = lineEnd + 1;
+	}
+	return true;
+}
+
+inline bool parseOBJ(const char* begin, const char* end, ObjData& out)
+{
+	return parseOBJChunk(begin, begin, end, out);
+}
+
+template <typename T>
+void concatObjChunks(const std::vector<ObjData>& chunks, std::vector<T> ObjData::* member, std::vector<T>& out)
+{
+	size_t size = out.size();
+	for (const auto& chunk : chunks) size += (chunk.*member).size();
+	out.reserve(size);
+	for (const auto& chunk : chunks)
+	{
+		out.insert(out.end(), (chunk.*member).begin(), (chunk.*member).end());
+	}
+}
+
+// obt@s̋EthreadCountɕĕɃp[XA擪珇Ɍ
+// OBJ̃CfbNX̓t@CŜł̒ʂԍȂ̂ŁAʂparseOBJƊSɈv
+inline bool parseOBJParallel(const char* begin, const char* end, unsigned int threadCount, ObjData& out)
+{
+	if (threadCount <= 1)
+	{
+		return parseOBJ(begin, end, out);
+	}
+
+	// ʒủ͎s̒ɂ炷
+	std::vector<const char*> bounds{ begin };
+	const size_t chunkSize = (end - begin) / threadCount;
+	for (unsigned int i = 1; i < threadCount; i++)
+	{
+		const char* p = std::max(bounds.back(), begin + chunkSize * i);
+		const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+		bounds.push_back(newline != nullptr ? newline + 1 : end);
+	}
+	bounds.push_back(end);
+
+	std::vector<ObjData> chunks(threadCount);
+	std::vector<char> results(threadCount, false);
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < threadCount; i++)
+	{
+		threads.emplace_back([&, i]() { results[i] = parseOBJChunk(begin, bounds[i], bounds[i + 1], chunks[i]); });
+	}
+	results[0] = parseOBJChunk(begin, bounds[0], bounds[1], chunks[0]);
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	if (std::find(results.begin(), results.end(), false) != results.end())
+	{
+		return false;
+	}
+
+	concatObjChunks(chunks, &ObjData::vertices, out.vertices);
+	concatObjChunks(chunks, &ObjData::uvs, out.uvs);
+	concatObjChunks(chunks, &ObjData::normals, out.normals);
+	concatObjChunks(chunks, &ObjData::indices, out.indices);
+	return true;
+}
+
+// t@C̓Xbh̋N̕t̂1MBƂ1Xbh܂łɂ
+inline unsigned int objParseThreadCount(size_t fileSize)
+{
+	const size_t minChunkSize = 1 << 20;
+	const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	return static_cast<unsigned int>(std::clamp<size_t>(fileSize / minChunkSize, 1, hardwareThreads));
+}
+
+// Op`̈ʒuUV̍ʂ̃^WFg߂
+inline glm::vec3 computeFaceTangent(const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec2& uv2)
+{
+	auto deltaPos1 = v1 - v0;
+	auto deltaPos2 = v2 - v0;
+
+	auto deltaUV1 = uv1 - uv0;
+	auto deltaUV2 = uv2 - uv0;
+
+	float r = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x);
+	return (deltaPos1 * deltaUV2.y - deltaPos2 * deltaUV1.y) * r;
+}
+
+// CfbNXWJĒ_Ƃ̔zƃ^WFg
+inline bool buildOBJVertices(const ObjData& obj, std::vector<glm::vec3>& outVertices, std::vector<glm::vec2>& outUVs, std::vector<glm::vec3>& outNormals, std::vector<glm::vec3>& outTangents)
+{
+	outVertices.reserve(outVertices.size() + obj.indices.size());
+	outUVs.reserve(outUVs.size() + obj.indices.size());
+	outNormals.reserve(outNormals.size() + obj.indices.size());
+	outTangents.reserve(outTangents.size() + obj.indices.size());
+
+	for (const auto& index : obj.indices)
+	{
+		if (index.vertex - 1 >= obj.vertices.size() || index.uv - 1 >= obj.uvs.size() || index.normal - 1 >= obj.normals.size())
+		{
+			std::cerr << "Obj face index out of range." << std::endl;
+			return false;
+		}
+		outVertices.emplace_back(obj.vertices[index.vertex - 1]);
+		outUVs.emplace_back(obj.uvs[index.uv - 1]);
+		outNormals.emplace_back(obj.normals[index.normal - 1]);
+	}
+
+	for (size_t i = 0; i < outVertices.size(); i += 3)
+	{
+		auto tangent = computeFaceTangent(outVertices[i + 0], outVertices[i + 1], outVertices[i + 2], outUVs[i + 0], outUVs[i + 1], outUVs[i + 2]);
+
+		outTangents.emplace_back(tangent);
+		outTangents.emplace_back(tangent);
+		outTangents.emplace_back(tangent);
+	}
+
+	return true;
+}
+
+// (v, vt, vn)̑gƂɒ_1ACfbNXobt@
+// ^WFgTangentSpace.hMikkTSpace݊̂̂ (~[̌pڂł͒_)
+inline bool buildOBJMesh(const ObjData& obj, ObjMesh& out)
+{
+	std::unordered_map<ObjIndex, unsigned int, ObjIndexHash> uniqueVertices;
+	uniqueVertices.reserve(obj.vertices.size() * 2);
+	out.indices.reserve(obj.indices.size());
+
+	for (const auto& index : obj.indices)
+	{
+		if (index.vertex - 1 >= obj.vertices.size() || index.uv - 1 >= obj.uvs.size() || index.normal - 1 >= obj.normals.size())
+		{
+			std::cerr << "Obj face index out of range." << std::endl;
+			return false;
+		}
+		const auto [it, inserted] = uniqueVertices.try_emplace(index, static_cast<unsigned int>(out.vertices.size()));
+		if (inserted)
+		{
+			out.vertices.emplace_back(obj.vertices[index.vertex - 1]);
+			out.uvs.emplace_back(obj.uvs[index.uv - 1]);
+			out.normals.emplace_back(obj.normals[index.normal - 1]);
+		}
+		out.indices.push_back(it->second);
+	}
+
+	generateTangents(out.vertices, out.uvs, out.normals, out.indices, out.tangents);
+	return true;
+}
+
+inline bool loadOBJ(std::string path, std::vector<glm::vec3>& outVertices, std::vector<glm::vec2>& outUVs, std::vector<glm::vec3>& outNormals, std::vector<glm::vec3>& outTangents)
+{
+	std::vector<char> buffer;
+	if (!readFileToBuffer(path, buffer))
+	{
+		std::cerr << "Can't open obj file: " << path << std::endl;
+		return false;
+	}
+
+	ObjData obj;
+	if (!parseOBJParallel(buffer.data(), buffer.data() + buffer.size(), objParseThreadCount(buffer.size()), obj))
+	{
+		return false;
+	}
+
+	return buildOBJVertices(obj, outVertices, outUVs, outNormals, outTangents);
+}
+
+inline bool loadOBJ(std::string path, ObjMesh& outMesh)
+{
+	std::vector<char> buffer;
+	if (!readFileToBuffer(path, buffer))
+	{
+		std::cerr << "Can't open obj file: " << path << std::endl;
+		return false;
+	}
+
+	ObjData obj;
+	if (!parseOBJParallel(buffer.data(), buffer.data() + buffer.size(), objParseThreadCount(buffer.size()), obj))
+	{
+		return false;
+	}
+
+	return buildOBJMesh(obj, outMesh);
+}
@@ -2,9 +2,9 @@
 
 layout (location = 0) in vec4 position;
 
-uniform mat4 Model;
+#include "DrawData.glsl"
 
 void main()
 {
-  gl_Position = Model * position;
+  gl_Position = draws[gl_BaseInstance].Model * position;
 }
@@ -0,0 +1,388 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+#include "Hash.h"
+#include "MappedFile.h"
+#include "ShaderPreprocessor.h"
+
+// vOoCiLbṼt@C`
+// wb_̌glGetProgramBinary̏o͂̂܂ܑ
+// `ςProgramCacheVersionグ邱
+const uint32_t ProgramCacheMagic = 0x47525050; // "PPRG"
+const uint32_t ProgramCacheVersion = 1;
+
+struct ProgramCacheHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t sourceHash; // SXe[W̃\[XƃhCõ̕nbV
+	uint64_t sourceSize;
+	uint32_t binaryFormat;
+	uint32_t binarySize;
+};
+
+// vO\VF[_̎ނƃt@C
+struct ShaderStage
+{
+	GLenum type;
+	std::string path;
+};
+
+inline const char* shaderStageName(GLenum type)
+{
+	switch (type)
+	{
+	case GL_VERTEX_SHADER: return "Vertex";
+	case GL_GEOMETRY_SHADER: return "Geometry";
+	case GL_FRAGMENT_SHADER: return "Fragment";
+	case GL_COMPUTE_SHADER: return "Compute";
+	default: return "Unknown";
+	}
+}
+
+// RpCʂmFăOo͂
+// KHR_parallel_shader_compileLȏꍇAŏ߂ăRpC̊҂
+inline bool checkShaderCompile(GLuint shader, GLenum type)
+{
+	GLint status = GL_FALSE;
+	GLsizei infoLogLength;
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+	if (status == GL_FALSE)
+		std::cerr << "Compile Error in " << shaderStageName(type) << " Shader." << std::endl;
+	glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
+	if (infoLogLength > 1) {
+		std::vector<GLchar> errorMessage(infoLogLength);
+		glGetShaderInfoLog(shader, infoLogLength, nullptr, errorMessage.data());
+		std::cerr << errorMessage.data() << std::endl;
+	}
+	return status != GL_FALSE;
+}
+
+// NʂmF (glProgramBinary̎sŕ)
+inline bool checkProgramLink(GLuint program, bool printLog = true)
+{
+	GLint status = GL_FALSE;
+	GLsizei infoLogLength;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (!printLog)
+	{
+		return status != GL_FALSE;
+	}
+	if (status == GL_FALSE)
+		std::cerr << "Link Error." << std::endl;
+	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
+	if (infoLogLength > 1) {
+		std::vector<GLchar> errorMessage(infoLogLength);
+		glGetProgramInfoLog(program, infoLogLength, nullptr, errorMessage.data());
+		std::cerr << errorMessage.data() << std::endl;
+	}
+	return status != GL_FALSE;
+}
+
+// submitŕԂԍ (ProgramCache̒̃vO̓Y)
+using ProgramHandle = size_t;
+
+// Nς݃vÕoCi"<Ō̃Xe[W̃t@C>.programcache"ɕۑA
+// ̋NłglProgramBinaryœǂݍGLSL̃RpCȂ
+// ̓\[XGL_VENDOR/GL_RENDERER/GL_VERSIOÑnbVȂ̂ŁAhCoς΍蒼
+// hCooCiۂꍇ͕ʂɃRpCď㏑
+//
+// submit̓RpCƃN𔭍s邾ŏԂ₢킹Ȃ
+// KHR_parallel_shader_compile΃hCõXbhŃRpCiނ̂ŁA
+// SvOsubmitAgOgetŊ҂
+class ProgramCache
+{
+public:
+	ProgramCache()
+	{
+		const auto glString = [](GLenum name) {
+			const auto value = reinterpret_cast<const char*>(glGetString(name));
+			return std::string(value != nullptr ? value : "");
+		};
+		driverKey = glString(GL_VENDOR) + '\n' + glString(GL_RENDERER) + '\n' + glString(GL_VERSION) + '\n';
+		GLint formatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		enabled = formatCount > 0;
+
+		// RpC̃Xbh̓hCoɔC
+		if (GLEW_KHR_parallel_shader_compile)
+		{
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+			parallel = true;
+		}
+		else if (GLEW_ARB_parallel_shader_compile)
+		{
+			glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+			parallel = true;
+		}
+	}
+
+	~ProgramCache()
+	{
+		for (auto& entry : entries)
+		{
+			deleteShaders(entry);
+		}
+	}
+
+	ProgramCache(const ProgramCache&) = delete;
+	ProgramCache& operator=(const ProgramCache&) = delete;
+
+	// \[XOAoCi̓ǂݍ݂RpCƃN𔭍s
+	// defines͑SXe[Wɍ܂Ap[~e[VƂɕʂ̃LbVt@CɂȂ
+	// \[Xǂ߂Ȃ΃vO0̃nhԂ
+	ProgramHandle submit(const std::vector<ShaderStage>& stages, const ShaderDefines& defines = {})
+	{
+		const auto start = std::chrono::steady_clock::now();
+		if (entries.empty())
+		{
+			firstSubmit = start;
+		}
+		entries.emplace_back();
+		Entry& entry = entries.back();
+		entry.name = stages.back().path;
+		entry.stages = stages;
+
+		entry.sources.resize(stages.size());
+		std::string key = driverKey;
+		uint64_t sourceSize = 0;
+		for (size_t i = 0; i < stages.size(); i++)
+		{
+			entry.sources[i] = preprocessor.preprocess(stages[i].path, defines);
+			if (entry.sources[i] == nullptr)
+			{
+				entry.finished = true;
+				return entries.size() - 1;
+			}
+			key += std::to_string(stages[i].type) + '\n' + *entry.sources[i] + '\n';
+			sourceSize += entry.sources[i]->size();
+		}
+		entry.sourceHash = hashBytes(key.data(), key.size());
+		entry.sourceSize = sourceSize;
+		entry.cachePath = stages.back().path + ".programcache";
+		if (!defines.empty())
+		{
+			const std::string definesKey = shaderDefinesKey(defines);
+			char suffix[20];
+			std::snprintf(suffix, sizeof(suffix), ".%016llx", static_cast<unsigned long long>(hashBytes(definesKey.data(), definesKey.size())));
+			entry.name += " [" + definesKey + "]";
+			entry.cachePath = stages.back().path + suffix + ".programcache";
+		}
+
+		entry.fromBinary = enabled && submitBinary(entry);
+		if (!entry.fromBinary)
+		{
+			submitCompile(entry);
+		}
+		entry.submitMilliseconds = elapsedMilliseconds(start);
+		return entries.size() - 1;
+	}
+
+	// ҂Ɏg邩𒲂ׂ
+	// gꍇ͖₢킹̂҂̂ŁAtrueԂgetɔC
+	bool isReady(ProgramHandle handle) const
+	{
+		const Entry& entry = entries[handle];
+		if (entry.finished || !parallel)
+		{
+			return true;
+		}
+		GLint completed = GL_FALSE;
+		glGetProgramiv(entry.program, GL_COMPLETION_STATUS_KHR, &completed);
+		return completed != GL_FALSE;
+	}
+
+	// N̊҂AʂmFăvOԂ
+	// sꍇvOIuWFNg͕Ԃ (createProgramƓ)
+	GLuint get(ProgramHandle handle)
+	{
+		Entry& entry = entries[handle];
+		if (entry.finished)
+		{
+			return entry.program;
+		}
+		const auto start = std::chrono::steady_clock::now();
+		entry.readyBeforeGet = parallel && isReady(handle);
+
+		if (entry.fromBinary && !checkProgramLink(entry.program, false))
+		{
+			// hCooCiۂ̂Ń\[X蒼 (͓Iɑ҂)
+			glDeleteProgram(entry.program);
+			entry.fromBinary = false;
+			submitCompile(entry);
+		}
+		if (!entry.fromBinary)
+		{
+			bool compiled = true;
+			for (size_t i = 0; i < entry.shaders.size(); i++)
+			{
+				compiled &= checkShaderCompile(entry.shaders[i], entry.stages[i].type);
+			}
+			if (checkProgramLink(entry.program) && compiled && enabled)
+			{
+				saveBinary(entry);
+			}
+			deleteShaders(entry);
+		}
+		entry.sources.clear();
+		entry.finished = true;
+		entry.waitMilliseconds = elapsedMilliseconds(start);
+		lastFinish = std::chrono::steady_clock::now();
+		return entry.program;
+	}
+
+	// submitget𑱂čs (҂Ă\Ȃꍇ)
+	GLuint create(const std::vector<ShaderStage>& stages)
+	{
+		return get(submit(stages));
+	}
+
+	// vOƂɃCXbhŎgԂƍvo͂
+	// submit̓R}h̔sAwaitgetŊ҂
+	void report() const
+	{
+		double total = 0.0;
+		size_t hits = 0;
+		size_t ready = 0;
+		for (const auto& entry : entries)
+		{
+			std::cout << "  " << entry.name << ": submit " << entry.submitMilliseconds << " ms, wait " << entry.waitMilliseconds << " ms ("
+				<< (entry.fromBinary ? "binary" : "compiled") << (entry.readyBeforeGet ? ", ready" : "") << ")" << std::endl;
+			total += entry.submitMilliseconds + entry.waitMilliseconds;
+			hits += entry.fromBinary ? 1 : 0;
+			ready += entry.readyBeforeGet ? 1 : 0;
+		}
+		const double span = entries.empty() ? 0.0 : std::chrono::duration<double, std::milli>(lastFinish - firstSubmit).count();
+		std::cout << "Programs: " << entries.size() << " programs (" << hits << " from binary cache, " << ready << " ready before use), "
+			<< total << " ms on main thread, " << span << " ms from first submit to last use ("
+			<< (!enabled ? "binary cache unsupported" : hits == entries.size() ? "warm cache" : "cold cache")
+			<< (parallel ? ", parallel compile" : "") << ")" << std::endl;
+		std::cout << "Shader sources: " << preprocessor.cacheMisses() << " preprocessed, " << preprocessor.cacheHits() << " reused" << std::endl;
+	}
+
+private:
+	struct Entry
+	{
+		std::string name;
+		std::vector<ShaderStage> stages;
+		std::vector<const std::string*> sources; // ShaderPreprocessor̃LbVw
+		std::vector<GLuint> shaders;
+		std::string cachePath;
+		uint64_t sourceHash = 0;
+		uint64_t sourceSize = 0;
+		GLuint program = 0;
+		bool fromBinary = false;
+		bool readyBeforeGet = false;
+		bool finished = false;
+		double submitMilliseconds = 0.0;
+		double waitMilliseconds = 0.0;
+	};
+
+	static double elapsedMilliseconds(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// ŇʂgetŊmF
+	bool submitBinary(Entry& entry)
+	{
+		MappedFile file;
+		if (!file.open(entry.cachePath) || file.size() < sizeof(ProgramCacheHeader))
+		{
+			return false;
+		}
+		ProgramCacheHeader header;
+		std::memcpy(&header, file.data(), sizeof(header));
+		if (header.magic != ProgramCacheMagic || header.version != ProgramCacheVersion
+			|| header.sourceHash != entry.sourceHash || header.sourceSize != entry.sourceSize
+			|| header.binarySize > file.size() - sizeof(header))
+		{
+			return false;
+		}
+		entry.program = glCreateProgram();
+		glProgramBinary(entry.program, header.binaryFormat, file.data() + sizeof(header), header.binarySize);
+		return true;
+	}
+
+	// VF[_̏Ԃ͖₢킹ɃN܂Ŕs
+	// Oǂނ߂ɃVF[_IuWFNgget܂ŎcĂ
+	void submitCompile(Entry& entry)
+	{
+		entry.program = glCreateProgram();
+		// oCioƂNOɃhCo֓`
+		glProgramParameteri(entry.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		for (size_t i = 0; i < entry.stages.size(); i++)
+		{
+			const GLuint shader = glCreateShader(entry.stages[i].type);
+			GLchar const* sourcePointer = entry.sources[i]->c_str();
+			glShaderSource(shader, 1, &sourcePointer, nullptr);
+			glCompileShader(shader);
+			glAttachShader(entry.program, shader);
+			entry.shaders.push_back(shader);
+		}
+		glLinkProgram(entry.program);
+	}
+
+	void deleteShaders(Entry& entry)
+	{
+		for (const GLuint shader : entry.shaders)
+		{
+			glDetachShader(entry.program, shader);
+			glDeleteShader(shader);
+		}
+		entry.shaders.clear();
+	}
+
+	void saveBinary(const Entry& entry) const
+	{
+		GLint binarySize = 0;
+		glGetProgramiv(entry.program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+		if (binarySize <= 0)
+		{
+			return;
+		}
+		std::vector<char> buffer(sizeof(ProgramCacheHeader) + binarySize);
+		GLenum binaryFormat = 0;
+		GLsizei written = 0;
+		glGetProgramBinary(entry.program, binarySize, &written, &binaryFormat, buffer.data() + sizeof(ProgramCacheHeader));
+		if (written <= 0)
+		{
+			return;
+		}
+
+		ProgramCacheHeader header{};
+		header.magic = ProgramCacheMagic;
+		header.version = ProgramCacheVersion;
+		header.sourceHash = entry.sourceHash;
+		header.sourceSize = entry.sourceSize;
+		header.binaryFormat = binaryFormat;
+		header.binarySize = static_cast<uint32_t>(written);
+		std::memcpy(buffer.data(), &header, sizeof(header));
+
+		std::ofstream ofs(entry.cachePath, std::ios::binary | std::ios::trunc);
+		ofs.write(buffer.data(), sizeof(header) + written);
+		if (ofs.fail())
+		{
+			std::cerr << "Can't write program cache: " << entry.cachePath << std::endl;
+			ofs.close();
+			std::remove(entry.cachePath.c_str());
+		}
+	}
+
+	ShaderPreprocessor preprocessor;
+	std::string driverKey;
+	bool enabled = false;
+	bool parallel = false;
+	std::deque<Entry> entries;
+	std::chrono::steady_clock::time_point firstSubmit;
+	std::chrono::steady_clock::time_point lastFinish;
+};
@@ -0,0 +1,702 @@
+#pragma once
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+#include <GL/glew.h>
+
+// pXǂݏeNX` (RenderGraph::createTexture()ԂCfbNX)
+using RenderGraphTexture = size_t;
+
+const RenderGraphTexture RenderGraphNoTexture = static_cast<RenderGraphTexture>(-1);
+
+// pXeNX`ǂg (oÃrbgƃA^b`ǧɎg)
+enum RenderGraphUsage
+{
+	RenderGraphUsageSampled,         // texture()
+	RenderGraphUsageImage,           // imageLoad / imageStore
+	RenderGraphUsageColorAttachment, // ݂̏GL_COLOR_ATTACHMENT0t
+	RenderGraphUsageDepthAttachment, // `ɃXeVGL_DEPTH_STENCIL_ATTACHMENT
+	RenderGraphUsageTransfer,        // glBlit*, glGetTextureImage, glGenerateTextureMipmap
+};
+
+struct RenderGraphTextureDesc
+{
+	GLenum target;
+	GLenum internalFormat;
+	GLsizei width;
+	GLsizei height;
+	GLsizei levels;
+	GLenum filter;
+	bool depthCompare;
+
+	bool operator==(const RenderGraphTextureDesc& other) const
+	{
+		return target == other.target && internalFormat == other.internalFormat && width == other.width && height == other.height
+			&& levels == other.levels && filter == other.filter && depthCompare == other.depthCompare;
+	}
+};
+
+inline RenderGraphTextureDesc renderTargetDesc(GLenum internalFormat, GLsizei width, GLsizei height, GLenum filter, GLsizei levels = 1)
+{
+	return { GL_TEXTURE_2D, internalFormat, width, height, levels, filter, false };
+}
+
+// r[h̃fvXeNX` (targetGL_TEXTURE_2DGL_TEXTURE_CUBE_MAP)
+inline RenderGraphTextureDesc shadowMapDesc(GLenum target, GLsizei size)
+{
+	return { target, GL_DEPTH_COMPONENT24, size, size, 1, GL_LINEAR, true };
+}
+
+// 1sNZ̃oCgƁAeNX`r[œʂ̌`ƂČg (r[NX)
+// fvX̌`͓`młr[Ȃ̂ŁA`̂̂NXɂ
+struct RenderGraphFormatInfo
+{
+	GLenum internalFormat;
+	GLsizeiptr bytesPerPixel;
+	GLenum viewClass;
+};
+
+inline RenderGraphFormatInfo renderGraphFormatInfo(GLenum internalFormat)
+{
+	static const RenderGraphFormatInfo formats[] = {
+		{ GL_RGBA8, 4, GL_VIEW_CLASS_32_BITS },
+		{ GL_SRGB8_ALPHA8, 4, GL_VIEW_CLASS_32_BITS },
+		{ GL_RGB10_A2, 4, GL_VIEW_CLASS_32_BITS },
+		{ GL_R11F_G11F_B10F, 4, GL_VIEW_CLASS_32_BITS },
+		{ GL_RG16F, 4, GL_VIEW_CLASS_32_BITS },
+		{ GL_R32F, 4, GL_VIEW_CLASS_32_BITS },
+		{ GL_R32UI, 4, GL_VIEW_CLASS_32_BITS },
+		{ GL_RGB16F, 6, GL_VIEW_CLASS_48_BITS },
+		{ GL_RGBA16F, 8, GL_VIEW_CLASS_64_BITS },
+		{ GL_RG32F, 8, GL_VIEW_CLASS_64_BITS },
+		{ GL_RGB32F, 12, GL_VIEW_CLASS_96_BITS },
+		{ GL_RGBA32F, 16, GL_VIEW_CLASS_128_BITS },
+		{ GL_DEPTH_COMPONENT24, 4, GL_DEPTH_COMPONENT24 },
+		{ GL_DEPTH_COMPONENT32F, 4, GL_DEPTH_COMPONENT32F },
+		{ GL_DEPTH24_STENCIL8, 4, GL_DEPTH24_STENCIL8 },
+		{ GL_DEPTH32F_STENCIL8, 8, GL_DEPTH32F_STENCIL8 },
+	};
+	for (const auto& format : formats)
+	{
+		if (format.internalFormat == internalFormat)
+		{
+			return format;
+		}
+	}
+	std::cerr << "Error: render graph: unknown internal format " << internalFormat << std::endl;
+	return { internalFormat, 4, internalFormat };
+}
+
+// S~bvx (L[u}bv6) ̃oCg
+inline GLsizeiptr renderGraphTextureBytes(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height, GLsizei levels)
+{
+	GLsizeiptr bytes = 0;
+	for (GLsizei level = 0; level < levels; level++)
+	{
+		bytes += GLsizeiptr(std::max(1, width >> level)) * std::max(1, height >> level);
+	}
+	return bytes * renderGraphFormatInfo(internalFormat).bytesPerPixel * (target == GL_TEXTURE_CUBE_MAP ? 6 : 1);
+}
+
+class RenderGraph;
+
+struct RenderGraphPass
+{
+	struct Access
+	{
+		RenderGraphTexture texture;
+		RenderGraphUsage usage;
+		bool write;
+	};
+
+	std::string name;
+	std::function<void(const RenderGraphPass&)> execute;
+	std::vector<Access> accesses;
+	bool sideEffects = false;
+
+	// compile()Ō܂
+	bool culled = false;
+	GLbitfield barriers = 0; // sOglMemoryBarrierɓnrbg
+	GLuint framebuffer = 0;  // A^b`g0
+
+	// ߂l̎QƂ͎addPass()܂ŗL
+	RenderGraphPass& read(RenderGraphTexture texture, RenderGraphUsage usage)
+	{
+		accesses.push_back({ texture, usage, false });
+		return *this;
+	}
+
+	RenderGraphPass& write(RenderGraphTexture texture, RenderGraphUsage usage)
+	{
+		accesses.push_back({ texture, usage, true });
+		return *this;
+	}
+
+	// ʂւ̏o͂CPUւ̓ǂݖ߂ȂǁAOt̊O猩錋ʂpX͊ԈȂ
+	RenderGraphPass& setSideEffects()
+	{
+		sideEffects = true;
+		return *this;
+	}
+};
+
+// pXǂݏeNX`錾Aˑ֌Ws߂郌_[Ot
+// t[reset()pXǉAcompile()execute()Ă
+// - ˑ̖pXm͐錾ۂ܂܃g|WJ\[g
+// - ʂgȂpX (setSideEffects()AeNX`̃pXǂ܂Ȃ) ͎sȂ
+// - imageStoreŏeNX`̃pXǂނƂɁAgɍ킹glMemoryBarrier
+// - dȂȂeNX`́Ar[NXƑ傫Ȃ瓯sσXg[WeNX`r[ŋL
+//   (GLł͌`̈قȂ郁d˂Ȃ̂ŁAJ[ƃfvX͋LȂ)
+// ̂̃eNX`FBO̓Ot̍\ςȂt[܂Ŏg
+// LeNX`̒g͂̃pXōŏɏ܂ŕsȂ̂ŁAŏɏpXŃNASʂ̏㏑
+class RenderGraph
+{
+public:
+	RenderGraph() = default;
+
+	~RenderGraph()
+	{
+		releaseAllocations();
+	}
+
+	RenderGraph(const RenderGraph&) = delete;
+	RenderGraph& operator=(const RenderGraph&) = delete;
+
+	void reset()
+	{
+		textures.clear();
+		passes.clear();
+		order.clear();
+	}
+
+	RenderGraphTexture createTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+	{
+		textures.push_back({ name, desc });
+		return textures.size() - 1;
+	}
+
+	RenderGraphPass& addPass(const std::string& name, std::function<void(const RenderGraphPass&)> execute)
+	{
+		passes.emplace_back();
+		passes.back().name = name;
+		passes.back().execute = std::move(execute);
+		return passes.back();
+	}
+
+	void compile()
+	{
+		schedule();
+		cull();
+		assignLifetimes();
+		const std::vector<Allocation> assigned = alias();
+		allocationsChanged = !sameAllocations(assigned);
+		if (allocationsChanged)
+		{
+			releaseAllocations();
+			allocations = assigned;
+			createAllocations();
+			report();
+		}
+		else
+		{
+			for (size_t i = 0; i < textures.size(); i++)
+			{
+				textures[i].view = cachedTextures[i].view;
+			}
+		}
+		placeBarriers();
+		for (const size_t index : order)
+		{
+			if (!passes[index].culled)
+			{
+				passes[index].framebuffer = passFramebuffer(passes[index]);
+			}
+		}
+	}
+
+	void execute()
+	{
+		for (const size_t index : order)
+		{
+			const RenderGraphPass& pass = passes[index];
+			if (pass.culled)
+			{
+				continue;
+			}
+			if (pass.barriers != 0)
+			{
+				glMemoryBarrier(pass.barriers);
+			}
+			pass.execute(pass);
+		}
+	}
+
+	// pX̎sɎgeNX`̖O (̂LĂĂeNX`Ƃɕʂ̃r[)
+	GLuint texture(RenderGraphTexture texture) const
+	{
+		return textures[texture].view;
+	}
+
+	// pX̃A^b`gȊȎgݍ킹FBO (glBlitNamedFramebuffer̓ǂݏoȂ)
+	GLuint framebuffer(std::initializer_list<RenderGraphTexture> colors, RenderGraphTexture depth = RenderGraphNoTexture)
+	{
+		std::vector<GLuint> key;
+		for (const RenderGraphTexture color : colors)
+		{
+			key.push_back(textures[color].view);
+		}
+		key.push_back(depth != RenderGraphNoTexture ? textures[depth].view : 0);
+		return cachedFramebuffer(key, depth != RenderGraphNoTexture ? textures[depth].desc.internalFormat : GL_NONE);
+	}
+
+	// eNX`蒼t[true (폜ꂽeNX`FBÕoCh̋L^̂Ă)
+	bool allocationsRecreated() const { return allocationsChanged; }
+
+private:
+	struct Texture
+	{
+		std::string name;
+		RenderGraphTextureDesc desc;
+		size_t firstUse = 0;
+		size_t lastUse = 0;
+		bool used = false;
+		size_t allocation = 0;
+		GLuint view = 0;
+	};
+
+	// ̂̕sσXg[W (r[NXA^[QbgA傫eNX`̏dȂȂ͈͂ŋL)
+	struct Allocation
+	{
+		GLenum target;
+		GLenum internalFormat;
+		GLsizei width;
+		GLsizei height;
+		GLsizei levels;
+		size_t lastUse;
+		std::vector<size_t> textures;
+		GLuint storage = 0;
+
+		bool operator==(const Allocation& other) const
+		{
+			return target == other.target && internalFormat == other.internalFormat && width == other.width && height == other.height
+				&& levels == other.levels && textures == other.textures;
+		}
+	};
+
+	// ݂̌̓ǂݏƁAǂݍ݂݂̌̏ɕӂ𒣂Aˑ̖͈͂ł͐錾ۂ
+	void schedule()
+	{
+		std::vector<std::vector<size_t>> successors(passes.size());
+		std::vector<size_t> dependencies(passes.size(), 0);
+		const auto addEdge = [&](size_t from, size_t to)
+		{
+			if (from != to && std::find(successors[from].begin(), successors[from].end(), to) == successors[from].end())
+			{
+				successors[from].push_back(to);
+				dependencies[to]++;
+			}
+		};
+
+		const size_t none = static_cast<size_t>(-1);
+		std::vector<size_t> lastWriter(textures.size(), none);
+		std::vector<std::vector<size_t>> readers(textures.size());
+		for (size_t i = 0; i < passes.size(); i++)
+		{
+			// pXœǂŏeNX`́Aǂݍ݂Ɉ
+			for (const bool write : { false, true })
+			{
+				for (const auto& access : passes[i].accesses)
+				{
+					if (access.write != write)
+					{
+						continue;
+					}
+					if (lastWriter[access.texture] != none)
+					{
+						addEdge(lastWriter[access.texture], i);
+					}
+					if (write)
+					{
+						for (const size_t reader : readers[access.texture])
+						{
+							addEdge(reader, i);
+						}
+						readers[access.texture].clear();
+						lastWriter[access.texture] = i;
+					}
+					else
+					{
+						readers[access.texture].push_back(i);
+					}
+				}
+			}
+		}
+
+		std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+		for (size_t i = 0; i < passes.size(); i++)
+		{
+			if (dependencies[i] == 0)
+			{
+				ready.push(i);
+			}
+		}
+		order.clear();
+		while (!ready.empty())
+		{
+			const size_t index = ready.top();
+			ready.pop();
+			order.push_back(index);
+			for (const size_t next : successors[index])
+			{
+				if (--dependencies[next] == 0)
+				{
+					ready.push(next);
+				}
+			}
+		}
+	}
+
+	// 납HAKvȃpXǂރeNX`pXc
+	void cull()
+	{
+		std::vector<bool> needed(textures.size(), false);
+		for (auto it = order.rbegin(); it != order.rend(); ++it)
+		{
+			RenderGraphPass& pass = passes[*it];
+			pass.culled = !pass.sideEffects;
+			for (const auto& access : pass.accesses)
+			{
+				if (access.write && needed[access.texture])
+				{
+					pass.culled = false;
+				}
+			}
+			if (pass.culled)
+			{
+				continue;
+			}
+			for (const auto& access : pass.accesses)
+			{
+				if (!access.write || access.usage == RenderGraphUsageColorAttachment || access.usage == RenderGraphUsageDepthAttachment)
+				{
+					// uhfvXeXg͑ÕpX̌ʂǂ
+					needed[access.texture] = true;
+				}
+			}
+		}
+	}
+
+	void assignLifetimes()
+	{
+		for (auto& texture : textures)
+		{
+			texture.used = false;
+		}
+		for (size_t position = 0; position < order.size(); position++)
+		{
+			const RenderGraphPass& pass = passes[order[position]];
+			if (pass.culled)
+			{
+				continue;
+			}
+			for (const auto& access : pass.accesses)
+			{
+				Texture& texture = textures[access.texture];
+				if (!texture.used)
+				{
+					texture.firstUse = position;
+					texture.used = true;
+				}
+				texture.lastUse = position;
+			}
+		}
+	}
+
+	// gn߂̏ɁȀI݊Ȏ̂֊蓖Ă (ΐV)
+	std::vector<Allocation> alias()
+	{
+		std::vector<size_t> sorted;
+		for (size_t i = 0; i < textures.size(); i++)
+		{
+			if (textures[i].used)
+			{
+				sorted.push_back(i);
+			}
+		}
+		std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) { return textures[a].firstUse < textures[b].firstUse; });
+
+		std::vector<Allocation> assigned;
+		for (const size_t index : sorted)
+		{
+			Texture& texture = textures[index];
+			const RenderGraphTextureDesc& desc = texture.desc;
+			const GLenum viewClass = renderGraphFormatInfo(desc.internalFormat).viewClass;
+			Allocation* found = nullptr;
+			for (auto& allocation : assigned)
+			{
+				if (allocation.lastUse < texture.firstUse && allocation.target == desc.target && allocation.width == desc.width && allocation.height == desc.height
+					&& renderGraphFormatInfo(allocation.internalFormat).viewClass == viewClass)
+				{
+					found = &allocation;
+					break;
+				}
+			}
+			if (found == nullptr)
+			{
+				assigned.push_back({ desc.target, desc.internalFormat, desc.width, desc.height, desc.levels, 0, {} });
+				found = &assigned.back();
+			}
+			found->levels = std::max(found->levels, desc.levels);
+			found->lastUse = texture.lastUse;
+			found->textures.push_back(index);
+			texture.allocation = found - assigned.data();
+		}
+		return assigned;
+	}
+
+	bool sameAllocations(const std::vector<Allocation>& assigned) const
+	{
+		if (!(assigned == allocations) || textures.size() != cachedTextures.size())
+		{
+			return false;
+		}
+		for (size_t i = 0; i < textures.size(); i++)
+		{
+			if (!(textures[i].desc == cachedTextures[i].desc) || textures[i].used != cachedTextures[i].used)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// eNX`r[̖OglGenTexturesōA܂oChĂȂ̂łȂ΂ȂȂ
+	void createAllocations()
+	{
+		for (auto& allocation : allocations)
+		{
+			glCreateTextures(allocation.target, 1, &allocation.storage);
+			glTextureStorage2D(allocation.storage, allocation.levels, allocation.internalFormat, allocation.width, allocation.height);
+		}
+		for (auto& texture : textures)
+		{
+			if (!texture.used)
+			{
+				texture.view = 0;
+				continue;
+			}
+			const RenderGraphTextureDesc& desc = texture.desc;
+			const GLuint layers = desc.target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+			glGenTextures(1, &texture.view);
+			glTextureView(texture.view, desc.target, allocations[texture.allocation].storage, desc.internalFormat, 0, desc.levels, 0, layers);
+			glTextureParameteri(texture.view, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(texture.view, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(texture.view, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+			glTextureParameteri(texture.view, GL_TEXTURE_MIN_FILTER, desc.filter);
+			glTextureParameteri(texture.view, GL_TEXTURE_MAG_FILTER, desc.filter);
+			if (desc.depthCompare)
+			{
+				glTextureParameteri(texture.view, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+				glTextureParameteri(texture.view, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+			}
+		}
+		cachedTextures = textures;
+	}
+
+	void releaseAllocations()
+	{
+		for (const auto& framebuffer : framebuffers)
+		{
+			glDeleteFramebuffers(1, &framebuffer.second);
+		}
+		framebuffers.clear();
+		for (const auto& texture : cachedTextures)
+		{
+			if (texture.view != 0)
+			{
+				glDeleteTextures(1, &texture.view);
+			}
+		}
+		cachedTextures.clear();
+		for (const auto& allocation : allocations)
+		{
+			glDeleteTextures(1, &allocation.storage);
+		}
+		allocations.clear();
+	}
+
+	// imageStoreŏ̂́AǂނƂ̎gƂɃoAv
+	// glMemoryBarrier͑SĂ̎̂Ɍ̂ŁAorbg̖͑̎̂
+	void placeBarriers()
+	{
+		std::vector<GLbitfield> pending(allocations.size(), 0);
+		for (const size_t index : order)
+		{
+			RenderGraphPass& pass = passes[index];
+			pass.barriers = 0;
+			if (pass.culled)
+			{
+				continue;
+			}
+			for (const auto& access : pass.accesses)
+			{
+				pass.barriers |= pending[textures[access.texture].allocation] & barrierBits(access.usage);
+			}
+			for (auto& bits : pending)
+			{
+				bits &= ~pass.barriers;
+			}
+			for (const auto& access : pass.accesses)
+			{
+				if (access.write && access.usage == RenderGraphUsageImage)
+				{
+					pending[textures[access.texture].allocation] = GL_ALL_BARRIER_BITS;
+				}
+			}
+		}
+	}
+
+	static GLbitfield barrierBits(RenderGraphUsage usage)
+	{
+		switch (usage)
+		{
+		case RenderGraphUsageSampled:
+			return GL_TEXTURE_FETCH_BARRIER_BIT;
+		case RenderGraphUsageImage:
+			return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+		case RenderGraphUsageColorAttachment:
+		case RenderGraphUsageDepthAttachment:
+			return GL_FRAMEBUFFER_BARRIER_BIT;
+		default:
+			return GL_TEXTURE_UPDATE_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT;
+		}
+	}
+
+	GLuint passFramebuffer(const RenderGraphPass& pass)
+	{
+		std::vector<GLuint> key;
+		GLuint depth = 0;
+		GLenum depthFormat = GL_NONE;
+		for (const auto& access : pass.accesses)
+		{
+			const Texture& texture = textures[access.texture];
+			if (access.usage == RenderGraphUsageColorAttachment && std::find(key.begin(), key.end(), texture.view) == key.end())
+			{
+				key.push_back(texture.view);
+			}
+			else if (access.usage == RenderGraphUsageDepthAttachment)
+			{
+				depth = texture.view;
+				depthFormat = texture.desc.internalFormat;
+			}
+		}
+		if (key.empty() && depth == 0)
+		{
+			return 0;
+		}
+		key.push_back(depth);
+		return cachedFramebuffer(key, depthFormat);
+	}
+
+	// key͐F̃r[AŌɃfvX̃r[ (0)
+	GLuint cachedFramebuffer(const std::vector<GLuint>& key, GLenum depthFormat)
+	{
+		const auto found = framebuffers.find(key);
+		if (found != framebuffers.end())
+		{
+			return found->second;
+		}
+		GLuint framebuffer;
+		glCreateFramebuffers(1, &framebuffer);
+		std::vector<GLenum> drawBuffers;
+		for (size_t i = 0; i + 1 < key.size(); i++)
+		{
+			drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i));
+			glNamedFramebufferTexture(framebuffer, drawBuffers.back(), key[i], 0);
+		}
+		if (drawBuffers.empty())
+		{
+			glNamedFramebufferDrawBuffer(framebuffer, GL_NONE);
+			glNamedFramebufferReadBuffer(framebuffer, GL_NONE);
+		}
+		else
+		{
+			glNamedFramebufferDrawBuffers(framebuffer, static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+		}
+		if (key.back() != 0)
+		{
+			const bool stencil = depthFormat == GL_DEPTH24_STENCIL8 || depthFormat == GL_DEPTH32F_STENCIL8;
+			glNamedFramebufferTexture(framebuffer, stencil ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT, key.back(), 0);
+		}
+		const GLenum status = glCheckNamedFramebufferStatus(framebuffer, GL_FRAMEBUFFER);
+		if (status != GL_FRAMEBUFFER_COMPLETE)
+		{
+			std::cerr << "Framebuffer Error: render graph: " << status << std::endl;
+		}
+		framebuffers.emplace(key, framebuffer);
+		return framebuffer;
+	}
+
+	// LȂꍇ (eNX`ƂɊm) Ǝۂ̊mۗʂׂ
+	void report() const
+	{
+		GLsizeiptr separateBytes = 0;
+		size_t usedTextures = 0;
+		for (const auto& texture : textures)
+		{
+			if (texture.used)
+			{
+				const RenderGraphTextureDesc& desc = texture.desc;
+				separateBytes += renderGraphTextureBytes(desc.target, desc.internalFormat, desc.width, desc.height, desc.levels);
+				usedTextures++;
+			}
+		}
+		GLsizeiptr aliasedBytes = 0;
+		for (const auto& allocation : allocations)
+		{
+			aliasedBytes += renderGraphTextureBytes(allocation.target, allocation.internalFormat, allocation.width, allocation.height, allocation.levels);
+		}
+		size_t culledPasses = 0;
+		for (const auto& pass : passes)
+		{
+			if (pass.culled)
+			{
+				std::cout << "Render graph: culled pass " << pass.name << std::endl;
+				culledPasses++;
+			}
+		}
+		for (const auto& allocation : allocations)
+		{
+			if (allocation.textures.size() > 1)
+			{
+				std::cout << "Render graph: aliased";
+				for (const size_t index : allocation.textures)
+				{
+					std::cout << ' ' << textures[index].name;
+				}
+				std::cout << std::endl;
+			}
+		}
+		const double megabyte = 1024.0 * 1024.0;
+		std::cout << "Render graph: " << passes.size() - culledPasses << "/" << passes.size() << " passes, "
+			<< usedTextures << " textures in " << allocations.size() << " allocations, peak VRAM "
+			<< std::fixed << std::setprecision(2) << separateBytes / megabyte << " MB -> " << aliasedBytes / megabyte << " MB"
+			<< std::defaultfloat << std::endl;
+	}
+
+	std::vector<Texture> textures;
+	std::vector<RenderGraphPass> passes;
+	std::vector<size_t> order;
+
+	std::vector<Allocation> allocations;
+	std::vector<Texture> cachedTextures;
+	std::map<std::vector<GLuint>, GLuint> framebuffers;
+	bool allocationsChanged = false;
+};
@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <stb_include.h>
+
+// LGLSLt@CufBNg (evWFNg̃fBNg̑΃pX)
+const char* const ShaderIncludeDirectory = "../Shaders";
+
+// p[~e[V邽߂#define (Oƒl)
+using ShaderDefines = std::vector<std::pair<std::string, std::string>>;
+
+inline bool readShaderSource(const std::string& path, std::string& out)
+{
+	std::ifstream ifs(path, std::ios::binary);
+	if (ifs.fail())
+	{
+		std::cerr << "Error: Can't open source file: " << path << std::endl;
+		return false;
+	}
+	out.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	if (ifs.fail())
+	{
+		std::cerr << "Error: could not read source file: " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// #definȇg͓ɂȂ̂ŁALbV̌t@CɎg
+inline std::string shaderDefinesKey(const ShaderDefines& defines)
+{
+	std::string key;
+	for (const auto& define : defines)
+	{
+		key += define.first + '=' + define.second + ';';
+	}
+	return key;
+}
+
+// "#include"includeDirectorỹt@CœWJA#version̎̍s#define
+// #linestb_includeGLSĽ` (STB_INCLUDE_LINE_GLSL) ŏo͂̂ŁA
+// G[̍sԍ͌̃t@Ĉ̂ɂȂ (CN[hꂽ̓\[X̔ԍŋʂ)
+// CN[hK[hGLSL#ifndefŏ
+inline bool preprocessShaderSource(const std::string& source, const std::string& path, const std::string& includeDirectory, const ShaderDefines& defines, std::string& out)
+{
+	std::string text = source;
+	std::string directory = includeDirectory;
+	std::string filename = path;
+	char error[256] = {};
+	char* const result = stb_include_string(&text[0], nullptr, &directory[0], &filename[0], error);
+	if (result == nullptr)
+	{
+		std::cerr << "Error: " << path << ": " << error << std::endl;
+		return false;
+	}
+	out = result;
+	std::free(result);
+
+	if (defines.empty())
+	{
+		return true;
+	}
+	std::string defineLines;
+	for (const auto& define : defines)
+	{
+		defineLines += "#define " + define.first + ' ' + define.second + '\n';
+	}
+	// #versionOɂ͉uȂ
+	size_t insertAt = 0;
+	const size_t version = out.find("#version");
+	if (version != std::string::npos)
+	{
+		const size_t lineEnd = out.find('\n', version);
+		insertAt = lineEnd != std::string::npos ? lineEnd + 1 : out.size();
+		defineLines += "#line 2 0\n";
+	}
+	out.insert(insertAt, defineLines);
+	return true;
+}
+
+// Oς݂̃\[Xt@C#definȇgƂɕێ
+// t@C畡̃p[~e[VꍇAg͈xWJȂ
+class ShaderPreprocessor
+{
+public:
+	explicit ShaderPreprocessor(std::string includeDirectory = ShaderIncludeDirectory) : includeDirectory(std::move(includeDirectory))
+	{
+	}
+
+	// ΑOς݂̃\[Xw|C^Ԃ (ShaderPreprocessorĂԗL)
+	const std::string* preprocess(const std::string& path, const ShaderDefines& defines = {})
+	{
+		const std::string key = path + '\n' + shaderDefinesKey(defines);
+		const auto found = cache.find(key);
+		if (found != cache.end())
+		{
+			hits++;
+			return &found->second;
+		}
+		std::string source;
+		std::string preprocessed;
+		if (!readShaderSource(path, source) || !preprocessShaderSource(source, path, includeDirectory, defines, preprocessed))
+		{
+			return nullptr;
+		}
+		misses++;
+		return &cache.emplace(key, std::move(preprocessed)).first->second;
+	}
+
+	size_t cacheHits() const { return hits; }
+	size_t cacheMisses() const { return misses; }
+
+private:
+	std::string includeDirectory;
+	std::map<std::string, std::string> cache;
+	size_t hits = 0;
+	size_t misses = 0;
+};
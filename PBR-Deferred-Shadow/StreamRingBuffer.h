@@ -0,0 +1,158 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <GL/glew.h>
+
+// obt@̊蓖Ĉʒu (glBindBufferRangeɓn)
+struct StreamRange
+{
+	GLintptr offset;
+	GLsizeiptr size;
+};
+
+// i}bvobt@FrameCount̗̈ɕAt[ƂɏԂɎgOAP[^
+// CPU͊蓖Ăɒڏ݁AGPU͂̂܂ܓǂ (Rs[glBufferSubDatäÖق̓Ȃ)
+// ëendFrame()̃tFXŎAFrameCountt[ɍĂюgOGPUǂݏÎ҂
+class StreamRingBuffer
+{
+public:
+	static const int FrameCount = 3;
+
+	// ë̐擪ǂ̃oCh̃ACg悤AframeCapacity256̔{ɐ؂グ
+	explicit StreamRingBuffer(GLsizeiptr frameCapacity) : frameCapacity((frameCapacity + 255) / 256 * 256)
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &buffer);
+		glNamedBufferStorage(buffer, this->frameCapacity * FrameCount, nullptr, flags);
+		mapped = static_cast<uint8_t*>(glMapNamedBufferRange(buffer, 0, this->frameCapacity * FrameCount, flags));
+		if (mapped == nullptr)
+		{
+			std::cerr << "Error: could not map stream buffer" << std::endl;
+		}
+	}
+
+	~StreamRingBuffer()
+	{
+		for (auto& fence : fences)
+		{
+			glDeleteSync(fence);
+		}
+		glUnmapNamedBuffer(buffer);
+		glDeleteBuffers(1, &buffer);
+	}
+
+	StreamRingBuffer(const StreamRingBuffer&) = delete;
+	StreamRingBuffer& operator=(const StreamRingBuffer&) = delete;
+
+	// ̗̈ɈڂÄ̗ǂłFrameCountt[O̕`悪I܂ő҂
+	void beginFrame()
+	{
+		frame = (frame + 1) % FrameCount;
+		head = 0;
+		frames++;
+		GLsync& fence = fences[frame];
+		if (fence == nullptr)
+		{
+			return;
+		}
+		if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000) == GL_TIMEOUT_EXPIRED)
+			{
+			}
+			stalls++;
+			stallMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+
+	// ̃t[̕`R}hSĔsɌĂ
+	void endFrame()
+	{
+		fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	// alignmentGL_UNIFORM_BUFFER_OFFSET_ALIGNMENTȂǃoCh̐ɍ킹
+	// ̈悪ȂnullptrԂ (frameCapacity1t[̍őʂɍ킹Č߂)
+	void* allocate(GLsizeiptr size, GLsizeiptr alignment, StreamRange& range)
+	{
+		const GLsizeiptr offset = (head + alignment - 1) / alignment * alignment;
+		if (mapped == nullptr || offset + size > frameCapacity)
+		{
+			std::cerr << "Error: stream buffer overflow (" << offset + size << " / " << frameCapacity << " bytes)" << std::endl;
+			return nullptr;
+		}
+		head = offset + size;
+		range = { frame * frameCapacity + offset, size };
+		return mapped + range.offset;
+	}
+
+	template <typename T>
+	StreamRange push(const T& value, GLsizeiptr alignment)
+	{
+		StreamRange range = {};
+		if (void* data = allocate(sizeof(T), alignment, range))
+		{
+			std::memcpy(data, &value, sizeof(T));
+		}
+		return range;
+	}
+
+	void bind(GLenum target, GLuint binding, const StreamRange& range) const
+	{
+		glBindBufferRange(target, binding, buffer, range.offset, range.size);
+	}
+
+	void report() const
+	{
+		std::cout << "Stream buffer: " << frames << " frames, " << stalls << " waited for the GPU (" << stallMilliseconds << " ms)" << std::endl;
+	}
+
+private:
+	GLuint buffer = 0;
+	uint8_t* mapped = nullptr;
+	GLsizeiptr frameCapacity;
+	GLsizeiptr head = 0;
+	int frame = FrameCount - 1;
+	std::array<GLsync, FrameCount> fences{};
+	size_t frames = 0;
+	size_t stalls = 0;
+	double stallMilliseconds = 0.0;
+};
+
+// t[̍ŏɍő吔蓖āA`悲Ƃ1vfޔz
+// push()ԂCfbNX`baseInstanceɂăVF[_
+template <typename T>
+struct StreamArray
+{
+	T* data = nullptr;
+	GLuint count = 0;
+	GLuint capacity = 0;
+	StreamRange range = {};
+
+	StreamArray(StreamRingBuffer& ring, GLuint capacity, GLsizeiptr alignment) : capacity(capacity)
+	{
+		data = static_cast<T*>(ring.allocate(sizeof(T) * capacity, alignment, range));
+	}
+
+	// tȂŌ̗vf㏑ (capacity1t[̍ő`搔ɍ킹Č߂)
+	GLuint push(const T& value)
+	{
+		if (data == nullptr)
+		{
+			return 0;
+		}
+		if (count == capacity)
+		{
+			std::cerr << "Error: too many draws in a frame (" << capacity << ")" << std::endl;
+			count--;
+		}
+		std::memcpy(data + count, &value, sizeof(T));
+		return count++;
+	}
+};
@@ -0,0 +1,310 @@
+#pragma once
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "VertexFormat.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TANGENT_SPACE_SSE 1
+#include <emmintrin.h>
+#endif
+
+// MikkTSpace݊̃^WFg
+// ʂƂ̃^WFg𒸓_@ɒApxŏdݕtĒ_Ƃɍv
+// w ̓nhlX (]ڐ = w * cross(normal, tangent) ̕)
+// UV̌t̖ (~[) _LĂꍇ͒_𕡐ĕ
+
+// SIMDƃXJ[œJ[lg߂̉Z
+inline float tangentSqrt(float x) { return std::sqrt(x); }
+inline float tangentMax(float a, float b) { return std::max(a, b); }
+inline float tangentMin(float a, float b) { return std::min(a, b); }
+inline float tangentAbs(float x) { return std::abs(x); }
+inline bool tangentGreater(float a, float b) { return a > b; }
+inline float tangentSelect(bool mask, float a, float b) { return mask ? a : b; }
+
+#ifdef TANGENT_SPACE_SSE
+struct TangentFloat4
+{
+	__m128 v;
+	TangentFloat4() = default;
+	TangentFloat4(__m128 v) : v(v) {}
+	TangentFloat4(float x) : v(_mm_set1_ps(x)) {}
+};
+inline TangentFloat4 operator+(TangentFloat4 a, TangentFloat4 b) { return _mm_add_ps(a.v, b.v); }
+inline TangentFloat4 operator-(TangentFloat4 a, TangentFloat4 b) { return _mm_sub_ps(a.v, b.v); }
+inline TangentFloat4 operator*(TangentFloat4 a, TangentFloat4 b) { return _mm_mul_ps(a.v, b.v); }
+inline TangentFloat4 operator/(TangentFloat4 a, TangentFloat4 b) { return _mm_div_ps(a.v, b.v); }
+inline TangentFloat4 operator-(TangentFloat4 a) { return _mm_sub_ps(_mm_setzero_ps(), a.v); }
+inline TangentFloat4 tangentSqrt(TangentFloat4 x) { return _mm_sqrt_ps(x.v); }
+inline TangentFloat4 tangentMax(TangentFloat4 a, TangentFloat4 b) { return _mm_max_ps(a.v, b.v); }
+inline TangentFloat4 tangentMin(TangentFloat4 a, TangentFloat4 b) { return _mm_min_ps(a.v, b.v); }
+inline TangentFloat4 tangentAbs(TangentFloat4 x) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), x.v); }
+inline TangentFloat4 tangentGreater(TangentFloat4 a, TangentFloat4 b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline TangentFloat4 tangentSelect(TangentFloat4 mask, TangentFloat4 a, TangentFloat4 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+#endif
+
+// acos (Abramowitz and Stegun 4.4.46, 덷2e-8x)
+template <typename F>
+F tangentAcos(F x)
+{
+	const F a = tangentAbs(x);
+	F p = F(-0.0012624911f);
+	p = p * a + F(0.0066700901f);
+	p = p * a + F(-0.0170881256f);
+	p = p * a + F(0.0308918810f);
+	p = p * a + F(-0.0501743046f);
+	p = p * a + F(0.0889789874f);
+	p = p * a + F(-0.2145988016f);
+	p = p * a + F(1.5707963050f);
+	const F r = tangentSqrt(tangentMax(F(1.0f) - a, F(0.0f))) * p;
+	return tangentSelect(tangentGreater(F(0.0f), x), F(3.14159265358979f) - r, r);
+}
+
+// [Ȃ0̂܂ܕԂ
+template <typename F>
+void tangentNormalize(F& x, F& y, F& z)
+{
+	const F length = tangentSqrt(x * x + y * y + z * z);
+	const auto valid = tangentGreater(length, F(FLT_MIN));
+	const F inverse = F(1.0f) / tangentSelect(valid, length, F(1.0f));
+	x = x * inverse;
+	y = y * inverse;
+	z = z * inverse;
+}
+
+// v - n * dot(n, v) 𐳋K
+template <typename F>
+void tangentProject(const F& nx, const F& ny, const F& nz, F& x, F& y, F& z)
+{
+	const F d = nx * x + ny * y + nz * z;
+	x = x - nx * d;
+	y = y - ny * d;
+	z = z - nz * d;
+	tangentNormalize(x, y, z);
+}
+
+// Op`Ƃ̓ (SoA)
+struct TangentTriangles
+{
+	enum
+	{
+		PX0, PY0, PZ0, PX1, PY1, PZ1, PX2, PY2, PZ2,
+		U0, V0, U1, V1, U2, V2,
+		NX0, NY0, NZ0, NX1, NY1, NZ1, NX2, NY2, NZ2,
+		InputCount,
+	};
+	enum
+	{
+		TX0, TY0, TZ0, TX1, TY1, TZ1, TX2, TY2, TZ2, // pxŏdݕteR[i[̃^WFg
+		Orientation, // 1: UV̌ۂ, -1: ], 0: UVk
+		OutputCount,
+	};
+
+	size_t count = 0;
+	size_t stride = 0; // 4̔{
+	std::vector<float> inputs;
+	std::vector<float> outputs;
+
+	void resize(size_t triangleCount)
+	{
+		count = triangleCount;
+		stride = (triangleCount + 3) / 4 * 4;
+		inputs.assign(stride * InputCount, 0.0f);
+		outputs.assign(stride * OutputCount, 0.0f);
+	}
+	float* input(int i) { return inputs.data() + stride * i; }
+	float* output(int i) { return outputs.data() + stride * i; }
+};
+
+// Op`1 (܂SIMD4) ̃J[l
+template <typename F>
+void computeTangentKernel(const F (&in)[TangentTriangles::InputCount], F (&out)[TangentTriangles::OutputCount])
+{
+	using T = TangentTriangles;
+	const F d1x = in[T::PX1] - in[T::PX0], d1y = in[T::PY1] - in[T::PY0], d1z = in[T::PZ1] - in[T::PZ0];
+	const F d2x = in[T::PX2] - in[T::PX0], d2y = in[T::PY2] - in[T::PY0], d2z = in[T::PZ2] - in[T::PZ0];
+	const F t21x = in[T::U1] - in[T::U0], t21y = in[T::V1] - in[T::V0];
+	const F t31x = in[T::U2] - in[T::U0], t31y = in[T::V2] - in[T::V0];
+
+	// UVԂł̕tʐ (1/r 0ɂȂʂ͏kނƂĈ)
+	const F area = t21x * t31y - t21y * t31x;
+	F sx = t31y * d1x - t21y * d2x;
+	F sy = t31y * d1y - t21y * d2y;
+	F sz = t31y * d1z - t21y * d2z;
+	tangentNormalize(sx, sy, sz);
+	const F sign = tangentSelect(tangentGreater(area, F(0.0f)), F(1.0f), F(-1.0f));
+	const auto valid = tangentGreater(tangentAbs(area), F(FLT_MIN));
+	sx = sx * sign;
+	sy = sy * sign;
+	sz = sz * sign;
+	out[T::Orientation] = tangentSelect(valid, sign, F(0.0f));
+
+	for (int corner = 0; corner < 3; corner++)
+	{
+		const int prev = (corner + 2) % 3;
+		const int next = (corner + 1) % 3;
+		F nx = in[T::NX0 + corner * 3], ny = in[T::NY0 + corner * 3], nz = in[T::NZ0 + corner * 3];
+		tangentNormalize(nx, ny, nz);
+
+		F v1x = in[T::PX0 + prev * 3] - in[T::PX0 + corner * 3];
+		F v1y = in[T::PY0 + prev * 3] - in[T::PY0 + corner * 3];
+		F v1z = in[T::PZ0 + prev * 3] - in[T::PZ0 + corner * 3];
+		F v2x = in[T::PX0 + next * 3] - in[T::PX0 + corner * 3];
+		F v2y = in[T::PY0 + next * 3] - in[T::PY0 + corner * 3];
+		F v2z = in[T::PZ0 + next * 3] - in[T::PZ0 + corner * 3];
+		tangentProject(nx, ny, nz, v1x, v1y, v1z);
+		tangentProject(nx, ny, nz, v2x, v2y, v2z);
+		const F cosine = tangentMax(F(-1.0f), tangentMin(F(1.0f), v1x * v2x + v1y * v2y + v1z * v2z));
+		const F weight = tangentSelect(valid, tangentAcos(cosine), F(0.0f));
+
+		F tx = sx, ty = sy, tz = sz;
+		tangentProject(nx, ny, nz, tx, ty, tz);
+		out[T::TX0 + corner * 3] = tx * weight;
+		out[T::TY0 + corner * 3] = ty * weight;
+		out[T::TZ0 + corner * 3] = tz * weight;
+	}
+}
+
+inline void computeTangentTriangles(TangentTriangles& triangles, bool useSimd = true)
+{
+	size_t i = 0;
+#ifdef TANGENT_SPACE_SSE
+	if (useSimd)
+	{
+		for (; i + 4 <= triangles.stride; i += 4)
+		{
+			TangentFloat4 in[TangentTriangles::InputCount];
+			TangentFloat4 out[TangentTriangles::OutputCount];
+			for (int k = 0; k < TangentTriangles::InputCount; k++)
+			{
+				in[k] = _mm_loadu_ps(triangles.input(k) + i);
+			}
+			computeTangentKernel(in, out);
+			for (int k = 0; k < TangentTriangles::OutputCount; k++)
+			{
+				_mm_storeu_ps(triangles.output(k) + i, out[k].v);
+			}
+		}
+	}
+#endif
+	for (; i < triangles.count; i++)
+	{
+		float in[TangentTriangles::InputCount];
+		float out[TangentTriangles::OutputCount];
+		for (int k = 0; k < TangentTriangles::InputCount; k++)
+		{
+			in[k] = triangles.input(k)[i];
+		}
+		computeTangentKernel(in, out);
+		for (int k = 0; k < TangentTriangles::OutputCount; k++)
+		{
+			triangles.output(k)[i] = out[k];
+		}
+	}
+}
+
+// CfbNXꂽ_^WFg
+// ~[̌pڂł͒_𕡐̂ŁApositions / uvs / normals / indices 
+inline void generateTangents(std::vector<glm::vec3>& positions, std::vector<glm::vec2>& uvs, std::vector<glm::vec3>& normals, std::vector<unsigned int>& indices, std::vector<glm::vec4>& tangents, bool useSimd = true)
+{
+	using T = TangentTriangles;
+	const size_t triangleCount = indices.size() / 3;
+
+	TangentTriangles triangles;
+	triangles.resize(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		for (int corner = 0; corner < 3; corner++)
+		{
+			const unsigned int v = indices[t * 3 + corner];
+			triangles.input(T::PX0 + corner * 3)[t] = positions[v].x;
+			triangles.input(T::PY0 + corner * 3)[t] = positions[v].y;
+			triangles.input(T::PZ0 + corner * 3)[t] = positions[v].z;
+			triangles.input(T::U0 + corner * 2)[t] = uvs[v].x;
+			triangles.input(T::V0 + corner * 2)[t] = uvs[v].y;
+			triangles.input(T::NX0 + corner * 3)[t] = normals[v].x;
+			triangles.input(T::NY0 + corner * 3)[t] = normals[v].y;
+			triangles.input(T::NZ0 + corner * 3)[t] = normals[v].z;
+		}
+	}
+	computeTangentTriangles(triangles, useSimd);
+
+	// Ƃɒ_։Z
+	const size_t vertexCount = positions.size();
+	std::vector<glm::vec3> preserving(vertexCount, glm::vec3(0.0f));
+	std::vector<glm::vec3> flipped(vertexCount, glm::vec3(0.0f));
+	std::vector<unsigned char> used(vertexCount, 0); // bit0: ۂ, bit1: ]
+	const float* orientation = triangles.output(T::Orientation);
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		if (orientation[t] == 0.0f)
+		{
+			continue;
+		}
+		auto& accumulated = orientation[t] > 0.0f ? preserving : flipped;
+		const unsigned char bit = orientation[t] > 0.0f ? 1 : 2;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			const unsigned int v = indices[t * 3 + corner];
+			accumulated[v] += glm::vec3(triangles.output(T::TX0 + corner * 3)[t], triangles.output(T::TY0 + corner * 3)[t], triangles.output(T::TZ0 + corner * 3)[t]);
+			used[v] |= bit;
+		}
+	}
+
+	const auto finish = [](const glm::vec3& normal, const glm::vec3& sum, float handedness) {
+		const float length = glm::length(sum);
+		if (length > FLT_MIN)
+		{
+			return glm::vec4(sum / length, handedness);
+		}
+		// UVkނʂȂ_͖@KȐڐ
+		glm::vec3 b1, b2;
+		buildOrthonormalBasis(glm::normalize(normal), b1, b2);
+		return glm::vec4(b1, 1.0f);
+	};
+
+	tangents.resize(vertexCount);
+	std::vector<unsigned int> flippedVertex(vertexCount, 0);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		if (used[v] == 2)
+		{
+			tangents[v] = finish(normals[v], flipped[v], -1.0f);
+		}
+		else
+		{
+			tangents[v] = finish(normals[v], preserving[v], 1.0f);
+		}
+		if (used[v] == 3)
+		{
+			flippedVertex[v] = static_cast<unsigned int>(positions.size());
+			positions.push_back(positions[v]);
+			uvs.push_back(uvs[v]);
+			normals.push_back(normals[v]);
+			tangents.push_back(finish(normals[v], flipped[v], -1.0f));
+		}
+	}
+	for (size_t t = 0; t < triangleCount; t++)
+	{
+		if (orientation[t] >= 0.0f)
+		{
+			continue;
+		}
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int& v = indices[t * 3 + corner];
+			if (v < vertexCount && used[v] == 3)
+			{
+				v = flippedVertex[v];
+			}
+		}
+	}
+}
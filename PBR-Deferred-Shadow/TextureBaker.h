@@ -0,0 +1,519 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stb_dxt.h>
+
+#include "Hash.h"
+#include "Image.h"
+#include "MappedFile.h"
+#include "MipGenerator.h"
+#include "ThreadPool.h"
+
+// }eÃeNX`MipGeneratorō~bv}bv݂ŃubNkA"<path>.dds"ɕۑ
+// J[ (AxhEG~bVu): BC1AAt@BC3
+// XJ[: BC4AsRGBŕۑꂽ̂͐`ɒĂ爳k
+// ORM: AOEtlXE^bN3REGEBɋl߂BC1 (`)AsRGBAÕ\[XsRGBǂ
+// @: XYBC5ɓAZ̓VF[_[ŕ
+// sOpenGĽ () ŕ
+// ĂςTextureBakeVersionグ邱
+const uint32_t TextureBakeVersion = 3;
+
+enum TextureBakeKind : uint32_t
+{
+	TextureBakeColor,
+	TextureBakeScalar,
+	TextureBakeNormal,
+	TextureBakeORM,
+};
+
+enum BakedTextureFormat : uint32_t
+{
+	BakedTextureRGBA8,
+	BakedTextureBC1,
+	BakedTextureBC3,
+	BakedTextureBC4,
+	BakedTextureBC5,
+};
+
+inline bool isBlockCompressed(BakedTextureFormat format)
+{
+	return format != BakedTextureRGBA8;
+}
+
+inline size_t bakedLevelSize(BakedTextureFormat format, uint32_t width, uint32_t height)
+{
+	const size_t blocks = size_t((width + 3) / 4) * ((height + 3) / 4);
+	switch (format)
+	{
+	case BakedTextureBC1:
+	case BakedTextureBC4:
+		return blocks * 8;
+	case BakedTextureBC3:
+	case BakedTextureBC5:
+		return blocks * 16;
+	default:
+		return size_t(width) * height * 4;
+	}
+}
+
+// DDSt@C̃wb_ (DX10gwb_t)
+// dwReserved1Ɍ̉摜̃nbVƏĂĂAςĂĂ
+const uint32_t DdsMagic = 0x20534444;  // "DDS "
+const uint32_t DdsFourCCDX10 = 0x30315844; // "DX10"
+
+enum DdsReserved : uint32_t
+{
+	DdsReservedVersion,
+	DdsReservedSourceHashLow,
+	DdsReservedSourceHashHigh,
+	DdsReservedSourceSizeLow,
+	DdsReservedSourceSizeHigh,
+	DdsReservedBakeKey, // TextureBakeKind | sRGB << 8
+};
+
+struct DdsFileHeader
+{
+	uint32_t magic;
+	uint32_t size;
+	uint32_t flags;
+	uint32_t height;
+	uint32_t width;
+	uint32_t pitchOrLinearSize;
+	uint32_t depth;
+	uint32_t mipMapCount;
+	uint32_t reserved1[11];
+	uint32_t pixelFormatSize;
+	uint32_t pixelFormatFlags;
+	uint32_t fourCC;
+	uint32_t rgbBitCount;
+	uint32_t bitMasks[4];
+	uint32_t caps[4];
+	uint32_t reserved2;
+	uint32_t dxgiFormat;
+	uint32_t resourceDimension;
+	uint32_t miscFlag;
+	uint32_t arraySize;
+	uint32_t miscFlags2;
+};
+
+inline uint32_t toDxgiFormat(BakedTextureFormat format, bool sRGB)
+{
+	switch (format)
+	{
+	case BakedTextureBC1:
+		return sRGB ? 72 : 71;
+	case BakedTextureBC3:
+		return sRGB ? 78 : 77;
+	case BakedTextureBC4:
+		return 80;
+	case BakedTextureBC5:
+		return 83;
+	default:
+		return sRGB ? 29 : 28;
+	}
+}
+
+inline bool fromDxgiFormat(uint32_t dxgiFormat, BakedTextureFormat& format, bool& sRGB)
+{
+	switch (dxgiFormat)
+	{
+	case 28: format = BakedTextureRGBA8; sRGB = false; return true;
+	case 29: format = BakedTextureRGBA8; sRGB = true; return true;
+	case 71: format = BakedTextureBC1; sRGB = false; return true;
+	case 72: format = BakedTextureBC1; sRGB = true; return true;
+	case 77: format = BakedTextureBC3; sRGB = false; return true;
+	case 78: format = BakedTextureBC3; sRGB = true; return true;
+	case 80: format = BakedTextureBC4; sRGB = false; return true;
+	case 83: format = BakedTextureBC5; sRGB = false; return true;
+	default: return false;
+	}
+}
+
+struct BakedTextureLevel
+{
+	uint32_t width;
+	uint32_t height;
+	size_t offset;
+	size_t size;
+};
+
+// }bvDDSt@C (݂Ɏsꍇ̓̃obt@)
+struct BakedTexture
+{
+	BakedTextureFormat format = BakedTextureRGBA8;
+	bool sRGB = false;
+	std::vector<BakedTextureLevel> levels;
+	MappedFile file;
+	std::vector<char> memory;
+
+	const char* data() const
+	{
+		return (file.isOpen() ? file.data() : memory.data()) + sizeof(DdsFileHeader);
+	}
+
+	const char* level(size_t i) const
+	{
+		return data() + levels[i].offset;
+	}
+
+	size_t size() const
+	{
+		return levels.empty() ? 0 : levels.back().offset + levels.back().size;
+	}
+
+	// 摜RGBA8Œuꍇ̃TCY (~bv}bv)
+	size_t uncompressedSize() const
+	{
+		size_t total = 0;
+		for (const auto& level : levels)
+		{
+			total += size_t(level.width) * level.height * 4;
+		}
+		return total;
+	}
+};
+
+inline uint32_t textureBakeKey(TextureBakeKind kind, bool sRGB)
+{
+	return uint32_t(kind) | uint32_t(sRGB) << 8;
+}
+
+// wb_mFAex͈̔͂outɐݒ肷
+inline bool readBakedTextureHeader(const char* data, size_t size, uint64_t sourceHash, uint64_t sourceSize, TextureBakeKind kind, bool sRGB, BakedTexture& out)
+{
+	if (size < sizeof(DdsFileHeader))
+	{
+		return false;
+	}
+	DdsFileHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (header.magic != DdsMagic || header.fourCC != DdsFourCCDX10 || header.mipMapCount == 0 || header.mipMapCount > 32)
+	{
+		return false;
+	}
+	if (header.reserved1[DdsReservedVersion] != TextureBakeVersion || header.reserved1[DdsReservedBakeKey] != textureBakeKey(kind, sRGB))
+	{
+		return false;
+	}
+	const uint64_t hash = header.reserved1[DdsReservedSourceHashLow] | uint64_t(header.reserved1[DdsReservedSourceHashHigh]) << 32;
+	const uint64_t length = header.reserved1[DdsReservedSourceSizeLow] | uint64_t(header.reserved1[DdsReservedSourceSizeHigh]) << 32;
+	if (hash != sourceHash || length != sourceSize || !fromDxgiFormat(header.dxgiFormat, out.format, out.sRGB))
+	{
+		return false;
+	}
+
+	out.levels.clear();
+	uint32_t width = header.width;
+	uint32_t height = header.height;
+	size_t offset = 0;
+	for (uint32_t i = 0; i < header.mipMapCount; i++)
+	{
+		const size_t levelSize = bakedLevelSize(out.format, width, height);
+		out.levels.push_back({ width, height, offset, levelSize });
+		offset += levelSize;
+		width = std::max(1u, width / 2);
+		height = std::max(1u, height / 2);
+	}
+	return offset <= size - sizeof(DdsFileHeader);
+}
+
+inline bool openBakedTexture(const std::string& bakedPath, uint64_t sourceHash, uint64_t sourceSize, TextureBakeKind kind, bool sRGB, BakedTexture& out)
+{
+	MappedFile file;
+	if (!file.open(bakedPath) || !readBakedTextureHeader(file.data(), file.size(), sourceHash, sourceSize, kind, sRGB, out))
+	{
+		return false;
+	}
+	out.memory.clear();
+	out.file = std::move(file);
+	return true;
+}
+
+// XJ[1`lA@XY2`lAJ[RGBAɕג
+inline BakeImage toBakeImage(const DecodedImage& image, TextureBakeKind kind, bool sRGB)
+{
+	BakeImage out;
+	out.width = image.width;
+	out.height = image.height;
+	out.components = kind == TextureBakeScalar ? 1 : kind == TextureBakeNormal ? 2 : 4;
+	out.pixels.resize(size_t(out.width) * out.height * out.components);
+	const size_t pixelCount = size_t(out.width) * out.height;
+	const int channels = image.channels;
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const stbi_uc* src = image.pixels.get() + i * channels;
+		uint8_t* dst = &out.pixels[i * out.components];
+		if (kind == TextureBakeScalar)
+		{
+			dst[0] = sRGB ? srgbToLinear8(src[0]) : src[0];
+			continue;
+		}
+		if (kind == TextureBakeNormal)
+		{
+			dst[0] = src[0];
+			dst[1] = channels > 1 ? src[1] : src[0];
+			continue;
+		}
+		const bool grey = channels < 3;
+		dst[0] = src[0];
+		dst[1] = grey ? src[0] : src[1];
+		dst[2] = grey ? src[0] : src[2];
+		dst[3] = channels == 2 ? src[1] : channels == 4 ? src[3] : 255;
+	}
+	return out;
+}
+
+// AOEtlXE^bN1`lڂREGEBɋl߂
+// 3̑傫ĂȂfalse
+inline bool packORMImage(const DecodedImage& ao, const DecodedImage& roughness, const DecodedImage& metallic, bool aoSRGB, BakeImage& out)
+{
+	if (ao.width != roughness.width || ao.width != metallic.width || ao.height != roughness.height || ao.height != metallic.height)
+	{
+		return false;
+	}
+	out.width = ao.width;
+	out.height = ao.height;
+	out.components = 4;
+	out.pixels.resize(size_t(out.width) * out.height * 4);
+	const size_t pixelCount = size_t(out.width) * out.height;
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		const uint8_t occlusion = ao.pixels.get()[i * ao.channels];
+		out.pixels[i * 4 + 0] = aoSRGB ? srgbToLinear8(occlusion) : occlusion;
+		out.pixels[i * 4 + 1] = roughness.pixels.get()[i * roughness.channels];
+		out.pixels[i * 4 + 2] = metallic.pixels.get()[i * metallic.channels];
+		out.pixels[i * 4 + 3] = 255;
+	}
+	return true;
+}
+
+// 1xubNkoutɏ
+// [̃ubN͍Ō̍sEJԂ4x4ɖ߂
+// pool΃ubN̍sƂɕɏ
+inline void compressLevel(const BakeImage& image, BakedTextureFormat format, ThreadPool* pool, char* out)
+{
+	if (!isBlockCompressed(format))
+	{
+		std::memcpy(out, image.pixels.data(), image.pixels.size());
+		return;
+	}
+	const uint32_t blocksX = (image.width + 3) / 4;
+	const uint32_t blocksY = (image.height + 3) / 4;
+	const size_t blockSize = bakedLevelSize(format, 4, 4);
+	const uint32_t c = image.components;
+	const auto compressRows = [&](size_t begin, size_t end) {
+		uint8_t block[16 * 4];
+		for (size_t by = begin; by < end; by++)
+		{
+			for (uint32_t bx = 0; bx < blocksX; bx++)
+			{
+				for (uint32_t py = 0; py < 4; py++)
+				{
+					const uint32_t y = std::min(uint32_t(by) * 4 + py, image.height - 1);
+					for (uint32_t px = 0; px < 4; px++)
+					{
+						const uint32_t x = std::min(bx * 4 + px, image.width - 1);
+						std::memcpy(&block[(py * 4 + px) * c], &image.pixels[(size_t(y) * image.width + x) * c], c);
+					}
+				}
+				auto dest = reinterpret_cast<unsigned char*>(out + (by * blocksX + bx) * blockSize);
+				switch (format)
+				{
+				case BakedTextureBC1:
+					stb_compress_dxt_block(dest, block, 0, STB_DXT_HIGHQUAL);
+					break;
+				case BakedTextureBC3:
+					stb_compress_dxt_block(dest, block, 1, STB_DXT_HIGHQUAL);
+					break;
+				case BakedTextureBC4:
+					stb_compress_bc4_block(dest, block);
+					break;
+				case BakedTextureBC5:
+					stb_compress_bc5_block(dest, block);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+	};
+	if (pool != nullptr)
+	{
+		parallelFor(*pool, blocksY, 4, compressRows);
+	}
+	else
+	{
+		compressRows(0, blocksY);
+	}
+}
+
+inline BakedTextureFormat chooseBakedFormat(const BakeImage& image, TextureBakeKind kind)
+{
+	if (kind == TextureBakeScalar)
+	{
+		return BakedTextureBC4;
+	}
+	if (kind == TextureBakeNormal)
+	{
+		return BakedTextureBC5;
+	}
+	// ORM̓`lƂ̑ւアBC4 31/3Ɏ܂
+	// l̖ڂɌtlX6bitGɒuĂ
+	if (kind == TextureBakeORM)
+	{
+		return BakedTextureBC1;
+	}
+	for (size_t i = 3; i < image.pixels.size(); i += 4)
+	{
+		if (image.pixels[i] != 255)
+		{
+			return BakedTextureBC3;
+		}
+	}
+	return BakedTextureBC1;
+}
+
+// ג摜ĂDDSt@Č`ɕׂ
+inline std::vector<char> bakeTexture(const BakeImage& image, TextureBakeKind kind, bool sRGB, uint64_t sourceHash, uint64_t sourceSize, ThreadPool* pool)
+{
+	const BakedTextureFormat format = chooseBakedFormat(image, kind);
+	// BC4ORM͐`Ŏ̂ŁAsRGBAOtoBakeImagepackORMImageŐ`ɒĂ
+	const bool storeSRGB = sRGB && kind == TextureBakeColor;
+
+	// At@̂ (BC3ɂ) Axh̓At@eXgŔ銄Sxő
+	MipOptions mipOptions;
+	mipOptions.filter = kind == TextureBakeNormal ? MipFilterNormal : storeSRGB ? MipFilterSRGB : MipFilterLinear;
+	mipOptions.preserveAlphaCoverage = format == BakedTextureBC3;
+	const std::vector<BakeImage> levels = generateMipChain(image, mipOptions, pool);
+	const BakeImage& level = levels[0];
+	const uint32_t levelCount = static_cast<uint32_t>(levels.size());
+
+	DdsFileHeader header{};
+	header.magic = DdsMagic;
+	header.size = 124;
+	header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // CAPS | HEIGHT | WIDTH | PIXELFORMAT | MIPMAPCOUNT | LINEARSIZE
+	header.width = level.width;
+	header.height = level.height;
+	header.pitchOrLinearSize = static_cast<uint32_t>(bakedLevelSize(format, level.width, level.height));
+	header.mipMapCount = levelCount;
+	header.reserved1[DdsReservedVersion] = TextureBakeVersion;
+	header.reserved1[DdsReservedSourceHashLow] = static_cast<uint32_t>(sourceHash);
+	header.reserved1[DdsReservedSourceHashHigh] = static_cast<uint32_t>(sourceHash >> 32);
+	header.reserved1[DdsReservedSourceSizeLow] = static_cast<uint32_t>(sourceSize);
+	header.reserved1[DdsReservedSourceSizeHigh] = static_cast<uint32_t>(sourceSize >> 32);
+	header.reserved1[DdsReservedBakeKey] = textureBakeKey(kind, sRGB);
+	header.pixelFormatSize = 32;
+	header.pixelFormatFlags = 0x4; // FOURCC
+	header.fourCC = DdsFourCCDX10;
+	header.caps[0] = 0x1000 | 0x400000 | 0x8; // TEXTURE | MIPMAP | COMPLEX
+	header.dxgiFormat = toDxgiFormat(format, storeSRGB);
+	header.resourceDimension = 3; // TEXTURE2D
+	header.arraySize = 1;
+
+	size_t total = sizeof(DdsFileHeader);
+	for (const auto& mip : levels)
+	{
+		total += bakedLevelSize(format, mip.width, mip.height);
+	}
+	std::vector<char> buffer(total);
+	std::memcpy(buffer.data(), &header, sizeof(header));
+
+	size_t offset = sizeof(DdsFileHeader);
+	for (const auto& mip : levels)
+	{
+		compressLevel(mip, format, pool, buffer.data() + offset);
+		offset += bakedLevelSize(format, mip.width, mip.height);
+	}
+	return buffer;
+}
+
+inline std::vector<char> bakeTexture(const DecodedImage& image, TextureBakeKind kind, bool sRGB, uint64_t sourceHash, uint64_t sourceSize, ThreadPool* pool)
+{
+	return bakeTexture(toBakeImage(image, kind, sRGB), kind, sRGB, sourceHash, sourceSize, pool);
+}
+
+// 摜ǂݍ݁AbakedPathɏĂʂo
+// ORMpathsAOEtlXE^bN̏ɓnAȊO1n
+// 2ڈȍ~͌̉摜̃nbVƏĂvDDS}bv邾ōς
+// Ȃꏊł̓̃obt@̂܂܎g
+inline bool loadBakedTexture(const std::vector<std::string>& paths, const std::string& bakedPath, TextureBakeKind kind, bool sRGB, ThreadPool* pool, BakedTexture& out, bool* cacheHit = nullptr)
+{
+	if (paths.size() != (kind == TextureBakeORM ? 3u : 1u))
+	{
+		return false;
+	}
+	std::vector<MappedFile> sources(paths.size());
+	std::vector<uint64_t> sourceHashes;
+	uint64_t sourceSize = 0;
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		if (!sources[i].open(paths[i]))
+		{
+			return false;
+		}
+		sourceHashes.push_back(hashBytes(sources[i].data(), sources[i].size()));
+		sourceSize += sources[i].size();
+	}
+	const uint64_t sourceHash = hashBytes(reinterpret_cast<const char*>(sourceHashes.data()), sourceHashes.size() * sizeof(uint64_t));
+
+	if (openBakedTexture(bakedPath, sourceHash, sourceSize, kind, sRGB, out))
+	{
+		if (cacheHit != nullptr) *cacheHit = true;
+		return true;
+	}
+	if (cacheHit != nullptr) *cacheHit = false;
+
+	std::vector<DecodedImage> images(sources.size());
+	for (size_t i = 0; i < sources.size(); i++)
+	{
+		if (!decodeImageFromMemory(sources[i].data(), sources[i].size(), images[i]))
+		{
+			return false;
+		}
+	}
+	BakeImage image;
+	if (kind == TextureBakeORM)
+	{
+		if (!packORMImage(images[0], images[1], images[2], sRGB, image))
+		{
+			std::cerr << "ORM source textures differ in size: " << paths[0] << std::endl;
+			return false;
+		}
+	}
+	else
+	{
+		image = toBakeImage(images[0], kind, sRGB);
+	}
+	auto buffer = bakeTexture(image, kind, sRGB, sourceHash, sourceSize, pool);
+	{
+		std::ofstream ofs(bakedPath, std::ios::binary | std::ios::trunc);
+		ofs.write(buffer.data(), buffer.size());
+		if (ofs.fail())
+		{
+			std::cerr << "Can't write baked texture: " << bakedPath << std::endl;
+		}
+	}
+	if (openBakedTexture(bakedPath, sourceHash, sourceSize, kind, sRGB, out))
+	{
+		return true;
+	}
+
+	std::remove(bakedPath.c_str());
+	out.file.close();
+	out.memory = std::move(buffer);
+	return readBakedTextureHeader(out.memory.data(), out.memory.size(), sourceHash, sourceSize, kind, sRGB, out);
+}
+
+// 1̉摜"<path>.dds"ɏĂ
+inline bool loadBakedTexture(const std::string& path, TextureBakeKind kind, bool sRGB, ThreadPool* pool, BakedTexture& out, bool* cacheHit = nullptr)
+{
+	return loadBakedTexture(std::vector<std::string>{ path }, path + ".dds", kind, sRGB, pool, out, cacheHit);
+}
@@ -0,0 +1,335 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <GL/glew.h>
+#include <glm.hpp>
+#include <gtc/type_precision.hpp>
+
+#include "TextureBaker.h"
+#include "ThreadPool.h"
+
+using TextureHandle = size_t;
+
+// eNX`񓯊ɓǂݍ
+// load()͂ɃnhԂAĂDDS̓ǂݍ (ΏĂ) ThreadPoolōs
+// update()𖈃t[ĂԂƁAǂݍ݂Îi}bvPBOoRŃ~bv}bvƃAbv[h
+// 풓܂texture()̓tH[obN1x1eNX`Ԃ
+class TextureStreamer
+{
+public:
+	TextureStreamer(ThreadPool& pool, size_t stagingSize = 32 << 20)
+		: pool(pool), stagingSize(stagingSize), startTime(std::chrono::steady_clock::now())
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glCreateBuffers(1, &stagingBuffer);
+		glNamedBufferStorage(stagingBuffer, stagingSize, nullptr, flags);
+		stagingMemory = static_cast<char*>(glMapNamedBufferRange(stagingBuffer, 0, stagingSize, flags));
+	}
+
+	~TextureStreamer()
+	{
+		// fR[h̃^XNthisQƂĂ̂ŐɏI点
+		pool.wait();
+		for (const auto& upload : uploads)
+		{
+			glDeleteSync(upload.fence);
+		}
+		for (const auto& entry : entries)
+		{
+			glDeleteTextures(1, &entry.texture);
+		}
+		for (const auto& fallback : fallbacks)
+		{
+			glDeleteTextures(1, &fallback.second);
+		}
+		glUnmapNamedBuffer(stagingBuffer);
+		glDeleteBuffers(1, &stagingBuffer);
+	}
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	TextureHandle load(const std::string& path, TextureBakeKind kind, bool sRGB, const glm::u8vec4& fallbackColor)
+	{
+		return load(std::vector<std::string>{ path }, path + ".dds", kind, sRGB, fallbackColor);
+	}
+
+	// ̉摜1ɋl߂ďĂ (ORM)
+	TextureHandle load(const std::vector<std::string>& paths, const std::string& bakedPath, TextureBakeKind kind, bool sRGB, const glm::u8vec4& fallbackColor)
+	{
+		const TextureHandle handle = entries.size();
+		std::string name = paths.empty() ? bakedPath : paths[0];
+		for (size_t i = 1; i < paths.size(); i++)
+		{
+			name += ", " + paths[i];
+		}
+		entries.push_back({ name, 0, getFallback(fallbackColor) });
+		pending++;
+		pool.push([this, handle, paths, bakedPath, kind, sRGB]() {
+			BakedTexture image;
+			bool cacheHit = false;
+			const bool ok = loadBakedTexture(paths, bakedPath, kind, sRGB, &pool, image, &cacheHit);
+			std::lock_guard<std::mutex> lock(decodedMutex);
+			bakedCount += ok && !cacheHit ? 1 : 0;
+			decoded.push_back({ handle, ok, std::move(image) });
+		});
+		return handle;
+	}
+
+	// 1t[ŃAbv[hʂuploadBudgetoCg܂łɗ}
+	void update(size_t uploadBudget = 16 << 20)
+	{
+		retireUploads();
+
+		size_t uploaded = 0;
+		while (uploaded < uploadBudget)
+		{
+			DecodedTexture texture;
+			{
+				std::lock_guard<std::mutex> lock(decodedMutex);
+				if (decoded.empty())
+				{
+					break;
+				}
+				texture = std::move(decoded.front());
+				decoded.pop_front();
+			}
+			if (!texture.ok)
+			{
+				std::cerr << "Can't load image: " << entries[texture.handle].path << std::endl;
+				pending--;
+				continue;
+			}
+			if (!upload(texture))
+			{
+				// Xe[WOobt@󂭂܂Ŏ̃t[ɉ
+				std::lock_guard<std::mutex> lock(decodedMutex);
+				decoded.push_front(std::move(texture));
+				break;
+			}
+			uploaded += texture.image.size();
+			pending--;
+		}
+
+		if (pending == 0 && !reported && !entries.empty())
+		{
+			reported = true;
+			const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+			std::cout << "Textures resident: " << entries.size() << " textures (" << bakedCount << " baked), " << elapsed << " ms after first load, "
+				<< residentBytes / 1048576.0 << " MiB (" << uncompressedBytes / 1048576.0 << " MiB as RGBA8)" << std::endl;
+		}
+	}
+
+	GLuint texture(TextureHandle handle) const
+	{
+		const auto& entry = entries[handle];
+		return entry.texture != 0 ? entry.texture : entry.fallback;
+	}
+
+	bool isResident(TextureHandle handle) const
+	{
+		return entries[handle].texture != 0;
+	}
+
+	bool allResident() const
+	{
+		return pending == 0;
+	}
+
+private:
+	struct Entry
+	{
+		std::string path;
+		GLuint texture;
+		GLuint fallback;
+	};
+
+	struct DecodedTexture
+	{
+		TextureHandle handle = 0;
+		bool ok = false;
+		BakedTexture image;
+	};
+
+	// Xe[WOobt@GPU܂ǂł͈
+	struct StagingRegion
+	{
+		size_t begin;
+		size_t end;
+		GLsync fence;
+	};
+
+	GLuint getFallback(const glm::u8vec4& color)
+	{
+		const uint32_t key = color.r | color.g << 8 | color.b << 16 | uint32_t(color.a) << 24;
+		for (const auto& fallback : fallbacks)
+		{
+			if (fallback.first == key)
+			{
+				return fallback.second;
+			}
+		}
+		GLuint texture;
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureStorage2D(texture, 1, GL_RGBA8, 1, 1);
+		glTextureSubImage2D(texture, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &color[0]);
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		fallbacks.emplace_back(key, texture);
+		return texture;
+	}
+
+	// GPUǂݏI͈͂
+	void retireUploads()
+	{
+		while (!uploads.empty())
+		{
+			const GLenum status = glClientWaitSync(uploads.front().fence, 0, 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+			{
+				break;
+			}
+			glDeleteSync(uploads.front().fence);
+			uploads.pop_front();
+		}
+		if (uploads.empty())
+		{
+			stagingHead = 0;
+		}
+	}
+
+	// Oobt@sizeoCgmۂB󂫂false
+	bool allocateStaging(size_t size, size_t& offset)
+	{
+		size = (size + 3) & ~size_t(3);
+		if (uploads.empty())
+		{
+			offset = 0;
+			return size <= stagingSize;
+		}
+		const size_t tail = uploads.front().begin;
+		if (stagingHead >= tail)
+		{
+			if (stagingSize - stagingHead >= size)
+			{
+				offset = stagingHead;
+				return true;
+			}
+			if (tail > size)
+			{
+				offset = 0;
+				return true;
+			}
+			return false;
+		}
+		if (tail - stagingHead > size)
+		{
+			offset = stagingHead;
+			return true;
+		}
+		return false;
+	}
+
+	static GLenum internalFormat(const BakedTexture& image)
+	{
+		switch (image.format)
+		{
+		case BakedTextureBC1:
+			return image.sRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case BakedTextureBC3:
+			return image.sRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case BakedTextureBC4:
+			return GL_COMPRESSED_RED_RGTC1;
+		case BakedTextureBC5:
+			return GL_COMPRESSED_RG_RGTC2;
+		default:
+			return image.sRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+		}
+	}
+
+	bool upload(DecodedTexture& decodedTexture)
+	{
+		const BakedTexture& image = decodedTexture.image;
+		Entry& entry = entries[decodedTexture.handle];
+		const size_t size = image.size();
+
+		// Xe[WOobt@傫摜̓NCAg璼ڑ
+		const bool direct = size > stagingSize;
+		size_t offset = 0;
+		if (!direct && !allocateStaging(size, offset))
+		{
+			return false;
+		}
+
+		const char* pixels = image.data();
+		if (!direct)
+		{
+			std::memcpy(stagingMemory + offset, image.data(), size);
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, stagingBuffer);
+			pixels = reinterpret_cast<const char*>(offset);
+		}
+
+		// Sẍ̗xɊmۂ (oChȂ̂GLStateCachẽeNX`jbg͕ςȂ)
+		const GLenum format = internalFormat(image);
+		GLuint texture;
+		glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+		glTextureStorage2D(texture, static_cast<GLsizei>(image.levels.size()), format, image.levels[0].width, image.levels[0].height);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+		// ~bv}bv͏ĂƂɍĂ̂őSx𑗂
+		for (size_t i = 0; i < image.levels.size(); i++)
+		{
+			const auto& level = image.levels[i];
+			const GLint mip = static_cast<GLint>(i);
+			if (isBlockCompressed(image.format))
+			{
+				glCompressedTextureSubImage2D(texture, mip, 0, 0, level.width, level.height, format, static_cast<GLsizei>(level.size), pixels + level.offset);
+			}
+			else
+			{
+				glTextureSubImage2D(texture, mip, 0, 0, level.width, level.height, GL_RGBA, GL_UNSIGNED_BYTE, pixels + level.offset);
+			}
+		}
+
+		if (!direct)
+		{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			stagingHead = offset + ((size + 3) & ~size_t(3));
+			uploads.push_back({ offset, stagingHead, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+		}
+		entry.texture = texture;
+		residentBytes += size;
+		uncompressedBytes += image.uncompressedSize();
+		return true;
+	}
+
+	ThreadPool& pool;
+	std::vector<Entry> entries;
+	std::vector<std::pair<uint32_t, GLuint>> fallbacks;
+	size_t pending = 0;
+	bool reported = false;
+	size_t bakedCount = 0;
+	size_t residentBytes = 0;
+	size_t uncompressedBytes = 0;
+
+	std::mutex decodedMutex;
+	std::deque<DecodedTexture> decoded;
+
+	GLuint stagingBuffer = 0;
+	char* stagingMemory = nullptr;
+	size_t stagingSize;
+	size_t stagingHead = 0;
+	std::deque<StagingRegion> uploads;
+
+	std::chrono::steady_clock::time_point startTime;
+};
@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Œ萔̃[J[XbhŃ^XNɎs
+// eNX`̃fR[hȂǁACXbh~߂ȂɎg
+class ThreadPool
+{
+public:
+	// CXbh̕1󂯂Ă
+	static unsigned int defaultThreadCount()
+	{
+		const unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	explicit ThreadPool(unsigned int threadCount = defaultThreadCount())
+	{
+		for (unsigned int i = 0; i < std::max(1u, threadCount); i++)
+		{
+			workers.emplace_back([this]() { run(); });
+		}
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		taskAvailable.notify_all();
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	void push(std::function<void()> task)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back(std::move(task));
+		}
+		taskAvailable.notify_one();
+	}
+
+	// L[ɂȂAs̃^XNSďI܂ő҂
+	void wait()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		idle.wait(lock, [this]() { return tasks.empty() && running == 0; });
+	}
+
+	unsigned int size() const
+	{
+		return static_cast<unsigned int>(workers.size());
+	}
+
+private:
+	void run()
+	{
+		for (;;)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				taskAvailable.wait(lock, [this]() { return stopping || !tasks.empty(); });
+				if (tasks.empty())
+				{
+					return;
+				}
+				task = std::move(tasks.front());
+				tasks.pop_front();
+				running++;
+			}
+			task();
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				running--;
+				if (tasks.empty() && running == 0)
+				{
+					idle.notify_all();
+				}
+			}
+		}
+	}
+
+	std::mutex mutex;
+	std::condition_variable taskAvailable;
+	std::condition_variable idle;
+	std::deque<std::function<void()>> tasks;
+	std::vector<std::thread> workers;
+	size_t running = 0;
+	bool stopping = false;
+};
+
+// [0, count)grainƂɕfunc(begin, end)ɎsASďI܂ő҂
+// ĂяoXbhɉ̂ŁA[J[Xbh̒ĂłfbhbNȂ
+template <typename Func>
+void parallelFor(ThreadPool& pool, size_t count, size_t grain, Func&& func)
+{
+	grain = std::max<size_t>(1, grain);
+	const size_t chunkCount = (count + grain - 1) / grain;
+	if (chunkCount <= 1)
+	{
+		if (count > 0)
+		{
+			func(size_t(0), count);
+		}
+		return;
+	}
+
+	struct State
+	{
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> done{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+	const auto state = std::make_shared<State>();
+	// SẴ`NI܂Ŗ߂Ȃ̂ŁAfunc͎QƂœnĂ悢
+	const auto run = [state, chunkCount, count, grain, &func]() {
+		for (;;)
+		{
+			const size_t chunk = state->next++;
+			if (chunk >= chunkCount)
+			{
+				return;
+			}
+			func(chunk * grain, std::min(count, (chunk + 1) * grain));
+			if (++state->done == chunkCount)
+			{
+				std::lock_guard<std::mutex> lock(state->mutex);
+				state->finished.notify_all();
+			}
+		}
+	};
+	const size_t helpers = std::min<size_t>(pool.size(), chunkCount - 1);
+	for (size_t i = 0; i < helpers; i++)
+	{
+		pool.push(run);
+	}
+	run();
+	std::unique_lock<std::mutex> lock(state->mutex);
+	state->finished.wait(lock, [&]() { return state->done == chunkCount; });
+}
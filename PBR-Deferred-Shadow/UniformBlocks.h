@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <GL/glew.h>
+#include <glm.hpp>
+
+// uniform block̃oCfBO|Cg (VF[_layout(binding = N)ƈv)
+enum UniformBinding : GLuint
+{
+	UniformBindingFrame = 0, // Shaders/FrameUniforms.glsl
+	UniformBindingLight = 1, // eCeBOpX̃Cg̃ubN
+};
+
+// VF[_Xg[Wobt@̃oCfBO|Cg
+enum StorageBinding : GLuint
+{
+	StorageBindingDraw = 0,   // Shaders/DrawData.glsl
+	StorageBindingLights = 1, // Shaders/PunctualLights.glsl
+	StorageBindingClusterGrid = 2,         // Shaders/ClusteredLights.glsl
+	StorageBindingClusterLightIndices = 3, // Shaders/ClusteredLights.glsl
+	StorageBindingObjectLights = 4,        // PBR-Forward/shader.frag
+};
+
+// Tv[̃eNX`jbg (VF[_layout(binding = N)ƈv)
+enum TextureUnit : GLuint
+{
+	TextureUnitGBuffer0 = 0,
+	TextureUnitGBuffer1 = 1,
+	TextureUnitGBuffer2 = 2,
+	TextureUnitGBuffer3 = 3,
+	TextureUnitShadowMap = 4,
+	TextureUnitSpotShadowMap = 5, // Xg[Wobt@̃Cg܂Ƃ߂ĕ`oHœ_̃VhE}bvƓɎg
+
+	// WIgpX̃}eA
+	TextureUnitAlbedo = 0,
+	TextureUnitOrm = 1,
+	TextureUnitNormal = 2,
+	TextureUnitEmissive = 3,
+
+	// |XgvZX̓
+	TextureUnitInput = 0,
+};
+
+// C[Wjbg (VF[_layout(binding = N)ƈv)
+enum ImageUnit : GLuint
+{
+	ImageUnitHDRColor = 0, // TiledLightingPass.comp
+};
+
+// ȉ̍\̂std140 (DrawDatastd430) ̃CAEgɍ킹Ă
+// vec3̌ɂ4oCǧԂ̂ŁAfloatl߂邩paddingu
+
+// Shaders/FrameUniforms.glsl
+struct FrameUniforms
+{
+	glm::mat4 View;
+	glm::mat4 Projection;
+	glm::mat4 ViewProjection;
+	glm::mat4 ViewProjectionI;
+	glm::vec3 worldCameraPos;
+	float padding0;
+	glm::vec2 ProjectionParams; // x: near, y: far
+	glm::vec2 resolution;
+};
+static_assert(offsetof(FrameUniforms, worldCameraPos) == 256, "std140 layout mismatch");
+static_assert(offsetof(FrameUniforms, ProjectionParams) == 272, "std140 layout mismatch");
+static_assert(sizeof(FrameUniforms) == 288, "std140 layout mismatch");
+
+// EmissiveAndDirectionalLightPass.frag
+struct DirectionalLightUniforms
+{
+	glm::mat4 LightViewProjection;
+	glm::vec3 LightDirection;
+	float LightIntensity; // lx
+	glm::vec3 LightColor;
+	float padding0;
+};
+static_assert(offsetof(DirectionalLightUniforms, LightColor) == 80, "std140 layout mismatch");
+static_assert(sizeof(DirectionalLightUniforms) == 96, "std140 layout mismatch");
+
+// PointLightPass.frag
+struct PointLightUniforms
+{
+	glm::vec3 worldLightPosition;
+	float LightIntensity; // lm
+	glm::vec3 LightColor;
+	float LightRange;
+	float shadowBias;
+	float padding0[3];
+};
+static_assert(offsetof(PointLightUniforms, shadowBias) == 32, "std140 layout mismatch");
+static_assert(sizeof(PointLightUniforms) == 48, "std140 layout mismatch");
+
+// SpotLightPass.frag
+struct SpotLightUniforms
+{
+	glm::mat4 LightViewProjection;
+	glm::vec3 worldLightPosition;
+	float LightIntensity; // lm
+	glm::vec3 LightColor;
+	float LightRange;
+	glm::vec3 LightDirection;
+	float LightAngle; // radian
+	float LightBlend; // 0-1
+	float padding0[3];
+};
+static_assert(offsetof(SpotLightUniforms, LightDirection) == 96, "std140 layout mismatch");
+static_assert(offsetof(SpotLightUniforms, LightBlend) == 112, "std140 layout mismatch");
+static_assert(sizeof(SpotLightUniforms) == 128, "std140 layout mismatch");
+
+// Shaders/PunctualLightShading.glsl (TiledLightingPass.comp, LightVolumePass.frag)
+struct PunctualLightingUniforms
+{
+	glm::mat4 SpotLightViewProjection; // VhE}bvX|bgCg
+	GLuint lightCount;
+	GLuint padding0[3];
+};
+static_assert(offsetof(PunctualLightingUniforms, lightCount) == 64, "std140 layout mismatch");
+static_assert(sizeof(PunctualLightingUniforms) == 80, "std140 layout mismatch");
+
+// Shaders/PunctualLights.glsl (std430)
+enum PunctualLightType : GLuint
+{
+	PunctualLightPoint = 0,
+	PunctualLightSpot = 1,
+};
+
+enum PunctualLightShadow : GLuint
+{
+	PunctualLightShadowNone = 0,
+	PunctualLightShadowCube = 1, // TextureUnitShadowMap
+	PunctualLightShadowSpot = 2, // TextureUnitSpotShadowMap
+};
+
+struct PunctualLight
+{
+	glm::vec3 position;
+	float range;
+	glm::vec3 color;
+	float intensity; // lm
+	glm::vec3 direction; // X|bgCĝ݁AKĂ
+	float cosOuterAngle; // ~̔pcos
+	float cosInnerAngle; // n܂锼pcos
+	GLuint type;
+	GLuint shadowMap;
+	float shadowBias;
+};
+static_assert(offsetof(PunctualLight, cosInnerAngle) == 48, "std430 layout mismatch");
+static_assert(sizeof(PunctualLight) == 64, "std430 layout mismatch");
+
+// Shaders/DrawData.glsl
+// pXƂɎgo[
+struct DrawData
+{
+	glm::mat4 Model;               // _̃VhE}bv
+	glm::mat4 ModelIT;             // WIgpX
+	glm::mat4 ModelView;           // WIgpX
+	glm::mat4 ModelViewProjection; // VhE}bv, Cg{[
+	glm::vec4 params;              // x: emissiveIntensity
+};
+static_assert(sizeof(DrawData) == 272, "std430 layout mismatch");
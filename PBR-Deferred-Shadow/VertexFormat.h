@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm.hpp>
+#include <gtc/packing.hpp>
+
+// WIgpXƉẽpXŎgkꂽ_tH[}bg
+// ʒu͉ẽpXƋLPƂ̃Xg[AȊO̓C^[[u1Xg[ɂ܂Ƃ߂
+
+enum MeshPositionFormat : uint32_t
+{
+	MeshPositionFloat32, // vec3 (12 bytes)
+	MeshPositionUnorm16, // GL_UNSIGNED_SHORT x3 + padding (8 bytes), oEfBO{bNXŐK
+};
+
+struct QuantizedPosition
+{
+	uint16_t x, y, z, w;
+};
+
+// WIgpXœǂރC^[[uꂽ_ (8 bytes)
+struct PackedVertexAttributes
+{
+	uint32_t uv;           // half2
+	uint32_t tangentFrame; // GL_INT_2_10_10_10_REV xy: ʑ̃GR[h̖@, z: ڐ̊px / PI, w: ]ڐ̕
+};
+
+// 16bitʒűtʎq position = offset + quantized * scale
+struct PositionQuantization
+{
+	glm::vec3 offset = glm::vec3(0.0f);
+	glm::vec3 scale = glm::vec3(1.0f);
+};
+
+inline size_t positionStride(MeshPositionFormat format)
+{
+	return format == MeshPositionUnorm16 ? sizeof(QuantizedPosition) : sizeof(glm::vec3);
+}
+
+inline PositionQuantization computePositionQuantization(const std::vector<glm::vec3>& positions)
+{
+	PositionQuantization quantization;
+	if (positions.empty())
+	{
+		return quantization;
+	}
+	glm::vec3 minimum = positions[0];
+	glm::vec3 maximum = positions[0];
+	for (const auto& position : positions)
+	{
+		minimum = glm::min(minimum, position);
+		maximum = glm::max(maximum, position);
+	}
+	quantization.offset = minimum;
+	// ݂̂Ȃ (Ȃ) 0ZɂȂȂ悤1ɂĂ
+	const glm::vec3 extent = maximum - minimum;
+	quantization.scale = glm::vec3(
+		extent.x > 0.0f ? extent.x : 1.0f,
+		extent.y > 0.0f ? extent.y : 1.0f,
+		extent.z > 0.0f ? extent.z : 1.0f);
+	return quantization;
+}
+
+inline QuantizedPosition quantizePosition(const glm::vec3& position, const PositionQuantization& quantization)
+{
+	const glm::vec3 normalized = glm::clamp((position - quantization.offset) / quantization.scale, 0.0f, 1.0f);
+	const glm::vec3 quantized = glm::round(normalized * 65535.0f);
+	return { static_cast<uint16_t>(quantized.x), static_cast<uint16_t>(quantized.y), static_cast<uint16_t>(quantized.z), 0 };
+}
+
+inline glm::vec3 dequantizePosition(const QuantizedPosition& position, const PositionQuantization& quantization)
+{
+	return quantization.offset + glm::vec3(position.x, position.y, position.z) / 65535.0f * quantization.scale;
+}
+
+inline glm::vec2 signNotZero(const glm::vec2& v)
+{
+	return glm::vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+// PʃxNg𔪖ʑ̂ɓe[-1, 1]^2Ɏʂ
+inline glm::vec2 encodeOctahedral(const glm::vec3& n)
+{
+	const float length = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+	if (!(length > 0.0f))
+	{
+		return glm::vec2(0.0f);
+	}
+	const glm::vec3 p = n / length;
+	if (p.z >= 0.0f)
+	{
+		return glm::vec2(p.x, p.y);
+	}
+	return (1.0f - glm::abs(glm::vec2(p.y, p.x))) * signNotZero(glm::vec2(p.x, p.y));
+}
+
+inline glm::vec3 decodeOctahedral(const glm::vec2& e)
+{
+	glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+	if (n.z < 0.0f)
+	{
+		const glm::vec2 xy = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * signNotZero(glm::vec2(n.x, n.y));
+		n.x = xy.x;
+		n.y = xy.y;
+	}
+	return glm::normalize(n);
+}
+
+// @ӂɌ܂鐳K (Duff et al. 2017)
+// GeometryPass.vertBuildOrthonormalBasisƓvZ邱
+inline void buildOrthonormalBasis(const glm::vec3& n, glm::vec3& b1, glm::vec3& b2)
+{
+	const float sign = n.z >= 0.0f ? 1.0f : -1.0f;
+	const float a = -1.0f / (sign + n.z);
+	const float b = n.x * n.y * a;
+	b1 = glm::vec3(1.0f + sign * n.x * n.x * a, sign * b, -sign * n.x);
+	b2 = glm::vec3(b, sign + n.y * n.y * a, -n.y);
+}
+
+// @EڐE]ڐ̕32bitɋl߂
+// ڐ̓fR[h̖@ɑ΂pxŎ̂ŁAVF[_[Ɠŕł
+inline uint32_t packTangentFrame(const glm::vec3& normal, const glm::vec3& tangent, float bitangentSign)
+{
+	const glm::vec2 octahedral = encodeOctahedral(normal);
+	const uint32_t packedNormal = glm::packSnorm3x10_1x2(glm::vec4(octahedral, 0.0f, 0.0f));
+	const glm::vec4 decoded = glm::unpackSnorm3x10_1x2(packedNormal);
+	const glm::vec3 decodedNormal = decodeOctahedral(glm::vec2(decoded.x, decoded.y));
+
+	glm::vec3 b1, b2;
+	buildOrthonormalBasis(decodedNormal, b1, b2);
+	float angle = std::atan2(glm::dot(tangent, b2), glm::dot(tangent, b1));
+	if (!std::isfinite(angle))
+	{
+		angle = 0.0f;
+	}
+	const float pi = 3.14159265358979f;
+	return glm::packSnorm3x10_1x2(glm::vec4(decoded.x, decoded.y, angle / pi, bitangentSign < 0.0f ? -1.0f : 1.0f));
+}
+
+inline void unpackTangentFrame(uint32_t packed, glm::vec3& normal, glm::vec3& tangent, float& bitangentSign)
+{
+	const glm::vec4 frame = glm::unpackSnorm3x10_1x2(packed);
+	normal = decodeOctahedral(glm::vec2(frame.x, frame.y));
+	glm::vec3 b1, b2;
+	buildOrthonormalBasis(normal, b1, b2);
+	const float angle = frame.z * 3.14159265358979f;
+	tangent = std::cos(angle) * b1 + std::sin(angle) * b2;
+	bitangentSign = frame.w < 0.0f ? -1.0f : 1.0f;
+}
+
+inline PackedVertexAttributes packVertexAttributes(const glm::vec2& uv, const glm::vec3& normal, const glm::vec3& tangent, float bitangentSign)
+{
+	return { glm::packHalf2x16(uv), packTangentFrame(normal, tangent, bitangentSign) };
+}
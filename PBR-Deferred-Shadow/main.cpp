@@ -1,8 +1,11 @@
 #define GLEW_STATIC
+#include <algorithm>
 #include <array>
-#include <fstream>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
-#include <sstream>
+#include <random>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -11,386 +14,235 @@
 #include <glm.hpp>
 #include <ext.hpp>
 
+#include "ClusteredLights.h"
+#include "GLResources.h"
+#include "GLStateCache.h"
+#include "GpuTimer.h"
+#include "LightCulling.h"
+#include "LightVolumes.h"
+#include "MaterialFeatures.h"
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "ProgramCache.h"
+#include "RenderGraph.h"
+#include "StreamRingBuffer.h"
+#include "TextureStreamer.h"
+#include "UniformBlocks.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
-
-GLuint createProgram(std::string vertexShaderFile, std::string fragmentShaderFile)
+#define STB_DXT_IMPLEMENTATION
+#include <stb_dxt.h>
+#define STB_INCLUDE_IMPLEMENTATION
+#define STB_INCLUDE_LINE_GLSL
+#pragma warning(push)
+#pragma warning(disable: 4996) // stb_includestrcpyfopeng
+#include <stb_include.h>
+#pragma warning(pop)
+
+// _VF[_ƃtOgVF[_ȂvÕRpC𔭍s
+ProgramHandle submitProgram(ProgramCache& programCache, const std::string& vertexShaderFile, const std::string& fragmentShaderFile, const ShaderDefines& defines = {})
 {
-	// _VF[_̓ǂݍ
-	std::ifstream vertexIfs(vertexShaderFile, std::ios::binary);
-	if (vertexIfs.fail())
-	{
-		std::cerr << "Error: Can't open source file: " << vertexShaderFile << std::endl;
-		return 0;
-	}
-	auto vertexShaderSource = std::string(std::istreambuf_iterator<char>(vertexIfs), std::istreambuf_iterator<char>());
-	if (vertexIfs.fail())
-	{
-		std::cerr << "Error: could not read source file: " << vertexShaderFile << std::endl;
-		return 0;
-	}
-	GLchar const* vertexShaderSourcePointer = vertexShaderSource.c_str();
-
-	// tOgVF[_̓ǂݍ
-	std::ifstream fragmentIfs(fragmentShaderFile, std::ios::binary);
-	if (fragmentIfs.fail())
-	{
-		std::cerr << "Error: Can't open source file: " << fragmentShaderFile << std::endl;
-		return 0;
-	}
-	auto fragmentShaderSource = std::string(std::istreambuf_iterator<char>(fragmentIfs), std::istreambuf_iterator<char>());
-	if (fragmentIfs.fail())
-	{
-		std::cerr << "Error: could not read source file: " << fragmentShaderFile << std::endl;
-		return 0;
-	}
-	GLchar const* fragmentShaderSourcePointer = fragmentShaderSource.c_str();
-
-
-	// vOIuWFNg쐬
-	const GLuint program = glCreateProgram();
-
-	GLint status = GL_FALSE;
-	GLsizei infoLogLength;
-
-	// _VF[_̃RpC
-	const GLuint vertexShaderObj = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShaderObj, 1, &vertexShaderSourcePointer, nullptr);
-	glCompileShader(vertexShaderObj);
-	glAttachShader(program, vertexShaderObj);
-
-	// _VF[_̃`FbN
-	glGetShaderiv(vertexShaderObj, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE)
-		std::cerr << "Compile Error in Vertex Shader." << std::endl;
-	glGetShaderiv(vertexShaderObj, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (infoLogLength > 1) {
-		std::vector<GLchar> vertexShaderErrorMessage(infoLogLength);
-		glGetShaderInfoLog(vertexShaderObj, infoLogLength, nullptr,
-			vertexShaderErrorMessage.data());
-		std::cerr << vertexShaderErrorMessage.data() << std::endl;
-	}
-
-	glDeleteShader(vertexShaderObj);
-
-	// tOgVF[_̃RpC
-	const GLuint fragmentShaderObj = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShaderObj, 1, &fragmentShaderSourcePointer, nullptr);
-	glCompileShader(fragmentShaderObj);
-	glAttachShader(program, fragmentShaderObj);
-
-	// tOgVF[_̃`FbN
-	glGetShaderiv(fragmentShaderObj, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE)
-		std::cerr << "Compile Error in Fragment Shader." << std::endl;
-	glGetShaderiv(fragmentShaderObj, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (infoLogLength > 1) {
-		std::vector<GLchar> fragmentShaderErrorMessage(infoLogLength);
-		glGetShaderInfoLog(fragmentShaderObj, infoLogLength, nullptr,
-			fragmentShaderErrorMessage.data());
-		std::cerr << fragmentShaderErrorMessage.data() << std::endl;
-	}
-
-	glDeleteShader(fragmentShaderObj);
-
-	// vÕN
-	glLinkProgram(program);
-
-	// Ñ`FbN
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
-	if (status == GL_FALSE)
-		std::cerr << "Link Error." << std::endl;
-	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (infoLogLength > 1) {
-		std::vector<GLchar> programLinkErrorMessage(infoLogLength);
-		glGetProgramInfoLog(program, infoLogLength, nullptr,
-			programLinkErrorMessage.data());
-		std::cerr << programLinkErrorMessage.data() << std::endl;
-	}
-
-	return program;
+	return programCache.submit({ { GL_VERTEX_SHADER, vertexShaderFile }, { GL_FRAGMENT_SHADER, fragmentShaderFile } }, defines);
 }
 
-GLuint createProgramWithGeometryShader(std::string vertexShaderFile, std::string geometryShaderFile, std::string fragmentShaderFile)
+ProgramHandle submitProgramWithGeometryShader(ProgramCache& programCache, const std::string& vertexShaderFile, const std::string& geometryShaderFile, const std::string& fragmentShaderFile)
 {
-	// _VF[_̓ǂݍ
-	std::ifstream vertexIfs(vertexShaderFile, std::ios::binary);
-	if (vertexIfs.fail())
-	{
-		std::cerr << "Error: Can't open source file: " << vertexShaderFile << std::endl;
-		return 0;
-	}
-	auto vertexShaderSource = std::string(std::istreambuf_iterator<char>(vertexIfs), std::istreambuf_iterator<char>());
-	if (vertexIfs.fail())
-	{
-		std::cerr << "Error: could not read source file: " << vertexShaderFile << std::endl;
-		return 0;
-	}
-	GLchar const* vertexShaderSourcePointer = vertexShaderSource.c_str();
-
-	// WIgVF[_̓ǂݍ
-	std::ifstream geometryIfs(geometryShaderFile, std::ios::binary);
-	if (geometryIfs.fail())
-	{
-		std::cerr << "Error: Can't open source file: " << geometryShaderFile << std::endl;
-		return 0;
-	}
-	auto geometryShaderSource = std::string(std::istreambuf_iterator<char>(geometryIfs), std::istreambuf_iterator<char>());
-	if (geometryIfs.fail())
-	{
-		std::cerr << "Error: could not read source file: " << vertexShaderFile << std::endl;
-		return 0;
-	}
-	GLchar const* geometryShaderSourcePointer = geometryShaderSource.c_str();
-
-	// tOgVF[_̓ǂݍ
-	std::ifstream fragmentIfs(fragmentShaderFile, std::ios::binary);
-	if (fragmentIfs.fail())
-	{
-		std::cerr << "Error: Can't open source file: " << fragmentShaderFile << std::endl;
-		return 0;
-	}
-	auto fragmentShaderSource = std::string(std::istreambuf_iterator<char>(fragmentIfs), std::istreambuf_iterator<char>());
-	if (fragmentIfs.fail())
-	{
-		std::cerr << "Error: could not read source file: " << fragmentShaderFile << std::endl;
-		return 0;
-	}
-	GLchar const* fragmentShaderSourcePointer = fragmentShaderSource.c_str();
-
-
-	// vOIuWFNg쐬
-	const GLuint program = glCreateProgram();
-
-	GLint status = GL_FALSE;
-	GLsizei infoLogLength;
-
-	// _VF[_̃RpC
-	const GLuint vertexShaderObj = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertexShaderObj, 1, &vertexShaderSourcePointer, nullptr);
-	glCompileShader(vertexShaderObj);
-	glAttachShader(program, vertexShaderObj);
-
-	// _VF[_̃`FbN
-	glGetShaderiv(vertexShaderObj, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE)
-		std::cerr << "Compile Error in Vertex Shader." << std::endl;
-	glGetShaderiv(vertexShaderObj, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (infoLogLength > 1) {
-		std::vector<GLchar> vertexShaderErrorMessage(infoLogLength);
-		glGetShaderInfoLog(vertexShaderObj, infoLogLength, nullptr,
-			vertexShaderErrorMessage.data());
-		std::cerr << vertexShaderErrorMessage.data() << std::endl;
-	}
-
-	glDeleteShader(vertexShaderObj);
-
-	// WIgVF[_̃RpC
-	const GLuint geometryShaderObj = glCreateShader(GL_GEOMETRY_SHADER);
-	glShaderSource(geometryShaderObj, 1, &geometryShaderSourcePointer, nullptr);
-	glCompileShader(geometryShaderObj);
-	glAttachShader(program, geometryShaderObj);
-
-	// WIgVF[_̃`FbN
-	glGetShaderiv(geometryShaderObj, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE)
-		std::cerr << "Compile Error in Geometry Shader." << std::endl;
-	glGetShaderiv(geometryShaderObj, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (infoLogLength > 1) {
-		std::vector<GLchar> geometryShaderErrorMessage(infoLogLength);
-		glGetShaderInfoLog(geometryShaderObj, infoLogLength, nullptr,
-			geometryShaderErrorMessage.data());
-		std::cerr << geometryShaderErrorMessage.data() << std::endl;
-	}
+	return programCache.submit({ { GL_VERTEX_SHADER, vertexShaderFile }, { GL_GEOMETRY_SHADER, geometryShaderFile }, { GL_FRAGMENT_SHADER, fragmentShaderFile } });
+}
 
-	glDeleteShader(geometryShaderObj);
-
-	// tOgVF[_̃RpC
-	const GLuint fragmentShaderObj = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragmentShaderObj, 1, &fragmentShaderSourcePointer, nullptr);
-	glCompileShader(fragmentShaderObj);
-	glAttachShader(program, fragmentShaderObj);
-
-	// tOgVF[_̃`FbN
-	glGetShaderiv(fragmentShaderObj, GL_COMPILE_STATUS, &status);
-	if (status == GL_FALSE)
-		std::cerr << "Compile Error in Fragment Shader." << std::endl;
-	glGetShaderiv(fragmentShaderObj, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (infoLogLength > 1) {
-		std::vector<GLchar> fragmentShaderErrorMessage(infoLogLength);
-		glGetShaderInfoLog(fragmentShaderObj, infoLogLength, nullptr,
-			fragmentShaderErrorMessage.data());
-		std::cerr << fragmentShaderErrorMessage.data() << std::endl;
-	}
+// DisneyMaterial.glsluniformɃ}eÃp[^ݒ肷 (uniform-1Ȃ̂Ŗ)
+void setDisneyMaterialUniforms(GLuint program, const DisneyMaterial& material)
+{
+	glProgramUniform1f(program, glGetUniformLocation(program, "subsurface"), material.subsurface);
+	glProgramUniform1f(program, glGetUniformLocation(program, "specular"), material.specular);
+	glProgramUniform1f(program, glGetUniformLocation(program, "specularTint"), material.specularTint);
+	glProgramUniform1f(program, glGetUniformLocation(program, "anisotropic"), material.anisotropic);
+	glProgramUniform1f(program, glGetUniformLocation(program, "sheen"), material.sheen);
+	glProgramUniform1f(program, glGetUniformLocation(program, "sheenTint"), material.sheenTint);
+	glProgramUniform1f(program, glGetUniformLocation(program, "clearcoat"), material.clearcoat);
+	glProgramUniform1f(program, glGetUniformLocation(program, "clearcoatGloss"), material.clearcoatGloss);
+}
 
-	glDeleteShader(fragmentShaderObj);
-
-	// vÕN
-	glLinkProgram(program);
-
-	// Ñ`FbN
-	glGetProgramiv(program, GL_LINK_STATUS, &status);
-	if (status == GL_FALSE)
-		std::cerr << "Link Error." << std::endl;
-	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLogLength);
-	if (infoLogLength > 1) {
-		std::vector<GLchar> programLinkErrorMessage(infoLogLength);
-		glGetProgramInfoLog(program, infoLogLength, nullptr,
-			programLinkErrorMessage.data());
-		std::cerr << programLinkErrorMessage.data() << std::endl;
-	}
+// WIgpX̕`悲Ƃ̃f[^
+DrawData geometryDrawData(const glm::mat4& ModelIT, const glm::mat4& ModelView, float emissiveIntensity)
+{
+	DrawData draw = {};
+	draw.ModelIT = ModelIT;
+	draw.ModelView = ModelView;
+	draw.params.x = emissiveIntensity;
+	return draw;
+}
 
-	return program;
+// ModelViewProjectiongpX (VhE}bv, Cg{[) ̕`悲Ƃ̃f[^
+DrawData transformDrawData(const glm::mat4& ModelViewProjection)
+{
+	DrawData draw = {};
+	draw.ModelViewProjection = ModelViewProjection;
+	return draw;
 }
 
-std::vector<std::string> splitString(const std::string& s, char delim)
+// _̃VhE}bv̓[hWɕϊĂWIgVF[_6ʂɓe
+DrawData modelDrawData(const glm::mat4& Model)
 {
-	std::vector<std::string> elems(0);
-	std::stringstream ss;
-	ss.str(s);
-	std::string item;
-	while (std::getline(ss, item, delim)) {
-		elems.push_back(item);
-	}
-	return elems;
+	DrawData draw = {};
+	draw.Model = Model;
+	return draw;
 }
 
-bool loadOBJ(std::string path, std::vector<glm::vec3>& outVertices, std::vector<glm::vec2>& outUVs, std::vector<glm::vec3>& outNormals, std::vector<glm::vec3>& outTangents)
+// drawIndexgl_BaseInstanceƂăVF[_ɓnADrawData̔ẑɎg
+void drawIndexed(GLsizei indexCount, GLenum indexType, GLuint drawIndex)
 {
-	std::vector<unsigned int> vertexIndices, uvIndices, normalIndices;
-	std::vector<glm::vec3> tmpVertices;
-	std::vector<glm::vec2> tmpUVs;
-	std::vector<glm::vec3> tmpNormals;
-
-	std::ifstream ifs(path);
-	std::string line;
-	if (ifs.fail())
-	{
-		std::cerr << "Can't open obj file: " << path << std::endl;
-		return false;
-	}
-	while (getline(ifs, line))
-	{
-		auto col = splitString(line, ' ');
+	glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, indexType, nullptr, 1, drawIndex);
+}
 
-		if (col[0] == "v")
-		{
-			tmpVertices.emplace_back(std::stof(col[1]), std::stof(col[2]), std::stof(col[3]));
-		}
-		else if (col[0] == "vt")
-		{
-			tmpUVs.emplace_back(std::stof(col[1]), std::stof(col[2]));
-		}
-		else if (col[0] == "vn")
-		{
-			tmpNormals.emplace_back(std::stof(col[1]), std::stof(col[2]), std::stof(col[3]));
-		}
-		else if (col[0] == "f")
-		{
-			auto v1 = splitString(col[1], '/');
-			auto v2 = splitString(col[2], '/');
-			auto v3 = splitString(col[3], '/');
-			vertexIndices.emplace_back(std::stoi(v1[0]));
-			vertexIndices.emplace_back(std::stoi(v2[0]));
-			vertexIndices.emplace_back(std::stoi(v3[0]));
-			uvIndices.emplace_back(std::stoi(v1[1]));
-			uvIndices.emplace_back(std::stoi(v2[1]));
-			uvIndices.emplace_back(std::stoi(v3[1]));
-			normalIndices.emplace_back(std::stoi(v1[2]));
-			normalIndices.emplace_back(std::stoi(v2[2]));
-			normalIndices.emplace_back(std::stoi(v3[2]));
-		}
-	}
+// 1̕`instanceCount` (VF[_gl_BaseInstance + gl_InstanceIDŔz)
+void drawIndexedInstanced(GLsizei indexCount, GLenum indexType, GLuint firstInstance, GLuint instanceCount)
+{
+	glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, indexType, nullptr, instanceCount, firstInstance);
+}
 
-	for (unsigned int i = 0; i < vertexIndices.size(); i++)
-	{
-		unsigned int vertexIndex = vertexIndices[i];
-		outVertices.emplace_back(tmpVertices[vertexIndex - 1]);
-	}
-	for (unsigned int i = 0; i < uvIndices.size(); i++)
-	{
-		unsigned int uvIndex = uvIndices[i];
-		outUVs.emplace_back(tmpUVs[uvIndex - 1]);
-	}
-	for (unsigned int i = 0; i < normalIndices.size(); i++)
+// _ƃX|bgCg̃CeBǑoH (TL[Ő؂ւ)
+enum LightingPath
+{
+	LightingPathStencil,   // CgƂɃ{[̃XeVẢfG-bufferǂŉZ
+	LightingPathInstanced, // SẴCg̃{[`Ƃ1̃CX^X`ŕ`A[xeXgŔ͈͓̉fI
+	LightingPathTiled,     // Rs[gVF[_16x16̃^CƂɃCgIсAef1񂾂VF[fBO
+	LightingPathClustered, // CPUŃNX^ƂɍCg̃XgA^C^ƓRs[gVF[_œǂ
+	LightingPathCount,
+};
+
+const char* lightingPathName(LightingPath path)
+{
+	switch (path)
 	{
-		unsigned int normalIndex = normalIndices[i];
-		outNormals.emplace_back(tmpNormals[normalIndex - 1]);
+	case LightingPathStencil:
+		return "stencil";
+	case LightingPathInstanced:
+		return "instanced";
+	case LightingPathTiled:
+		return "tiled";
+	default:
+		return "clustered";
 	}
+}
 
-	for (int i = 0; i < outVertices.size(); i += 3)
+// oH̔rpɉe̖_̏ɂ΂܂ (Ȃ疈񓯂zu)
+std::vector<PunctualLight> createFillLights(size_t count)
+{
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<PunctualLight> lights(count);
+	for (auto& light : lights)
 	{
-		auto& v0 = outVertices[i + 0];
-		auto& v1 = outVertices[i + 1];
-		auto& v2 = outVertices[i + 2];
-
-		auto& uv0 = outUVs[i + 0];
-		auto& uv1 = outUVs[i + 1];
-		auto& uv2 = outUVs[i + 2];
-
-		auto deltaPos1 = v1 - v0;
-		auto deltaPos2 = v2 - v0;
-
-		auto deltaUV1 = uv1 - uv0;
-		auto deltaUV2 = uv2 - uv0;
-
-		float r = 1.0f / (deltaUV1.x * deltaUV2.y - deltaUV1.y * deltaUV2.x);
-		auto tangent = (deltaPos1 * deltaUV2.y - deltaPos2 * deltaUV1.y) * r;
-
-		outTangents.emplace_back(tangent);
-		outTangents.emplace_back(tangent);
-		outTangents.emplace_back(tangent);
+		light = {};
+		light.position = glm::vec3(unit(random) * 20.0f - 10.0f, 0.5f + unit(random) * 2.0f, unit(random) * 20.0f - 10.0f);
+		light.range = 2.0f + unit(random) * 3.0f;
+		light.color = glm::vec3(unit(random), unit(random), unit(random));
+		light.intensity = 400.0f;
+		light.type = PunctualLightPoint;
+		light.shadowMap = PunctualLightShadowNone;
 	}
+	return lights;
+}
 
-	return true;
+// XeV̌oHœ_`Ƃuniform block
+PointLightUniforms toPointLightUniforms(const PunctualLight& light)
+{
+	PointLightUniforms uniforms = {};
+	uniforms.worldLightPosition = light.position;
+	uniforms.LightIntensity = light.intensity;
+	uniforms.LightColor = light.color;
+	uniforms.LightRange = light.range;
+	uniforms.shadowBias = light.shadowBias;
+	return uniforms;
 }
 
-GLuint loadTexture(const char* path, const bool sRGB = false)
+// bVVAOƃobt@
+struct Mesh
 {
-	stbi_set_flip_vertically_on_load(true);
-	int width, height, nrChannels;
-	unsigned char* data = stbi_load(path, &width, &height, &nrChannels, 0);
-	if (!data)
-	{
-		std::cerr << "Can't load image: " << path << std::endl;
-		return 0;
-	}
-	GLuint texture;
-	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-
-	if (sRGB)
+	GLuint vao;       // WIgpXp (ʒu + C^[[uꂽ)
+	GLuint shadowVao; // ẽpXp (ʒû)
+	GLuint positionVbo;
+	GLuint attributeVbo;
+	GLuint ibo;
+	GLsizei indexCount;
+	GLenum indexType;
+	glm::mat4 dequantize; // ʎqꂽʒu̍Wɖ߂sAfs̉E|
+};
+
+// ʒu͒_obt@̃oCfBO0AC^[[uꂽ̓oCfBO1ǂ
+void setPositionAttribute(GLuint vao, GLuint vbo, MeshPositionFormat format)
+{
+	glEnableVertexArrayAttrib(vao, 0);
+	glVertexArrayAttribBinding(vao, 0, 0);
+	if (format == MeshPositionUnorm16)
 	{
-		if (nrChannels == 4)
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8_ALPHA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		else
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_SRGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
+		glVertexArrayVertexBuffer(vao, 0, vbo, 0, sizeof(QuantizedPosition));
+		glVertexArrayAttribFormat(vao, 0, 3, GL_UNSIGNED_SHORT, GL_TRUE, 0);
 	}
 	else
 	{
-		if (nrChannels == 4)
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		else
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
+		glVertexArrayVertexBuffer(vao, 0, vbo, 0, sizeof(glm::vec3));
+		glVertexArrayAttribFormat(vao, 0, 3, GL_FLOAT, GL_FALSE, 0);
 	}
-	glGenerateMipmap(GL_TEXTURE_2D);
-	stbi_image_free(data);
+}
 
-	return texture;
+// bVLbṼ}bv̈悩璼VAO쐬
+Mesh createMesh(const MeshCache& cache)
+{
+	Mesh mesh;
+	const auto positionFormat = static_cast<MeshPositionFormat>(cache.header->positionFormat);
+
+	mesh.positionVbo = createBuffer(cache.streamSize(MeshStreamPositions), cache.stream(MeshStreamPositions));
+	mesh.attributeVbo = createBuffer(cache.streamSize(MeshStreamAttributes), cache.stream(MeshStreamAttributes));
+	mesh.ibo = createBuffer(cache.streamSize(MeshStreamIndices), cache.stream(MeshStreamIndices));
+
+	glCreateVertexArrays(1, &mesh.vao);
+	setPositionAttribute(mesh.vao, mesh.positionVbo, positionFormat);
+	glVertexArrayVertexBuffer(mesh.vao, 1, mesh.attributeVbo, 0, sizeof(PackedVertexAttributes));
+	glEnableVertexArrayAttrib(mesh.vao, 1);
+	glVertexArrayAttribFormat(mesh.vao, 1, 2, GL_HALF_FLOAT, GL_FALSE, offsetof(PackedVertexAttributes, uv));
+	glVertexArrayAttribBinding(mesh.vao, 1, 1);
+	glEnableVertexArrayAttrib(mesh.vao, 2);
+	glVertexArrayAttribFormat(mesh.vao, 2, 4, GL_INT_2_10_10_10_REV, GL_TRUE, offsetof(PackedVertexAttributes, tangentFrame));
+	glVertexArrayAttribBinding(mesh.vao, 2, 1);
+	glVertexArrayElementBuffer(mesh.vao, mesh.ibo);
+
+	glCreateVertexArrays(1, &mesh.shadowVao);
+	setPositionAttribute(mesh.shadowVao, mesh.positionVbo, positionFormat);
+	glVertexArrayElementBuffer(mesh.shadowVao, mesh.ibo);
+
+	mesh.indexCount = static_cast<GLsizei>(cache.header->indexCount);
+	mesh.indexType = cache.header->indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+	const auto quantization = cache.positionQuantization();
+	mesh.dequantize = glm::scale(glm::translate(glm::mat4(1), quantization.offset), quantization.scale);
+	return mesh;
 }
 
+void deleteMesh(const Mesh& mesh)
+{
+	glDeleteVertexArrays(1, &mesh.vao);
+	glDeleteVertexArrays(1, &mesh.shadowVao);
+	glDeleteBuffers(1, &mesh.positionVbo);
+	glDeleteBuffers(1, &mesh.attributeVbo);
+	glDeleteBuffers(1, &mesh.ibo);
+}
+
+// CfbNXƒ_̈kɂ郁̍팸ʂ\
+void printMeshStats(const char* name, const MeshCache& cache)
+{
+	const auto& header = *cache.header;
+	const size_t floatVertexSize = sizeof(glm::vec3) * 3 + sizeof(glm::vec2);
+	const size_t flatBytes = size_t(header.indexCount) * floatVertexSize;
+	const size_t positionBytes = cache.streamSize(MeshStreamPositions);
+	const size_t vertexBytes = positionBytes + cache.streamSize(MeshStreamAttributes);
+	const size_t indexedBytes = vertexBytes + cache.streamSize(MeshStreamIndices);
+	std::cout << name << ": " << header.vertexCount << " unique vertices / " << header.indexCount << " indices, "
+		<< flatBytes << " bytes -> " << indexedBytes << " bytes, "
+		<< (header.vertexCount > 0 ? vertexBytes / header.vertexCount : 0) << " bytes/vertex ("
+		<< (header.vertexCount > 0 ? positionBytes / header.vertexCount : 0) << " bytes/vertex in shadow passes)" << std::endl;
+}
 
 const float MIN_ISO = 100.0f;
 const float MAX_ISO = 6400.0f;
@@ -480,99 +332,81 @@ int main() {
 	glCullFace(GL_BACK);
 	glEnable(GL_CULL_FACE);
 
+	// VF[_̃RpCƃNɑSĔsĂ
+	// KHR_parallel_shader_compile΃bVƃeNX`ǂłԂɃhCoRpCi߂
+	// 2ڈȍ~̋NłProgramCachefBXÑoCiǂݍ
+	// CeBOpX̓V[̃}eAgBRDF̃[u܂ރp[~e[Vɂ
+	const DisneyMaterial sceneMaterial;
+	const ShaderDefines lightPassDefines = materialFeatureDefines(sceneMaterial.features());
+	std::cout << "BRDF permutation: " << materialFeatureName(sceneMaterial.features()) << " (BRDF_FEATURES=" << sceneMaterial.features() << ")" << std::endl;
+	ProgramCache programCache;
+	const ProgramHandle geometryPassProgram = submitProgram(programCache, "GeometryPass.vert", "GeometryPass.frag");
+	const ProgramHandle directionalShadowMapPassProgram = submitProgram(programCache, "DirectionalShadowMapPass.vert", "DirectionalShadowMapPass.frag");
+	const ProgramHandle emissiveAndDirectionalLightPassProgram = submitProgram(programCache, "EmissiveAndDirectionalLightPass.vert", "EmissiveAndDirectionalLightPass.frag", lightPassDefines);
+	const ProgramHandle pointLightShadowMapPassProgram = submitProgramWithGeometryShader(programCache, "PointLightShadowMapPass.vert", "PointLightShadowMapPass.geom", "PointLightShadowMapPass.frag");
+	const ProgramHandle punctualLightStencilPassProgram = submitProgram(programCache, "PunctualLightStencilPass.vert", "PunctualLightStencilPass.frag");
+	const ProgramHandle pointLightPassProgram = submitProgram(programCache, "PointLightPass.vert", "PointLightPass.frag", lightPassDefines);
+	ShaderDefines unshadowedPointLightPassDefines = lightPassDefines;
+	unshadowedPointLightPassDefines.emplace_back("POINT_LIGHT_SHADOW", "0");
+	const ProgramHandle unshadowedPointLightPassProgram = submitProgram(programCache, "PointLightPass.vert", "PointLightPass.frag", unshadowedPointLightPassDefines);
+	const ProgramHandle spotLightShadowMapPassProgram = submitProgram(programCache, "SpotLightShadowMapPass.vert", "SpotLightShadowMapPass.frag");
+	const ProgramHandle spotLightPassProgram = submitProgram(programCache, "SpotLightPass.vert", "SpotLightPass.frag", lightPassDefines);
+	const ProgramHandle lightVolumePassProgram = submitProgram(programCache, "LightVolumePass.vert", "LightVolumePass.frag", lightPassDefines);
+	ShaderDefines coneLightVolumePassDefines = lightPassDefines;
+	coneLightVolumePassDefines.emplace_back("LIGHT_VOLUME_CONE", "1");
+	const ProgramHandle coneLightVolumePassProgram = submitProgram(programCache, "LightVolumePass.vert", "LightVolumePass.frag", coneLightVolumePassDefines);
+	const ProgramHandle tiledLightingPassProgram = programCache.submit({ { GL_COMPUTE_SHADER, "TiledLightingPass.comp" } }, lightPassDefines);
+	ShaderDefines clusteredLightingPassDefines = lightPassDefines;
+	clusteredLightingPassDefines.emplace_back("CLUSTERED_LIGHTS", "1");
+	const ProgramHandle clusteredLightingPassProgram = programCache.submit({ { GL_COMPUTE_SHADER, "TiledLightingPass.comp" } }, clusteredLightingPassDefines);
+	const ProgramHandle logAverageProgram = submitProgram(programCache, "LogAveragePass.vert", "LogAveragePass.frag");
+	const ProgramHandle postprocessProgram = submitProgram(programCache, "Postprocess.vert", "Postprocess.frag");
+
 	// testMonkey.obj̃[h
-	std::vector<glm::vec3> vertices;
-	std::vector<glm::vec2> uvs;
-	std::vector<glm::vec3> normals;
-	std::vector<glm::vec3> tangents;
-	if (!loadOBJ("testMonkey.obj", vertices, uvs, normals, tangents))
+	auto meshLoadStart = std::chrono::steady_clock::now();
+	bool monkeyCacheHit = false;
+	MeshCache monkeyCache;
+	if (!loadOBJCached("testMonkey.obj", monkeyCache, &monkeyCacheHit))
 	{
 		std::cerr << "Can't load obj file: testMonkey.obj" << std::endl;
 		return 1;
 	}
+	printMeshStats("testMonkey.obj", monkeyCache);
 	// testmonkey.objVAO̍쐬
-	GLuint vao;
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-	GLuint verticesVBO;
-	glGenBuffers(1, &verticesVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, verticesVBO);
-	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), &vertices[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	GLuint uvsVBO;
-	glGenBuffers(1, &uvsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, uvsVBO);
-	glBufferData(GL_ARRAY_BUFFER, uvs.size() * sizeof(glm::vec2), &uvs[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	GLuint normalsVBO;
-	glGenBuffers(1, &normalsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, normalsVBO);
-	glBufferData(GL_ARRAY_BUFFER, normals.size() * sizeof(glm::vec3), &normals[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	GLuint tangentsVBO;
-	glGenBuffers(1, &tangentsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, tangentsVBO);
-	glBufferData(GL_ARRAY_BUFFER, tangents.size() * sizeof(glm::vec3), &tangents[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	glBindVertexArray(0);
+	const Mesh monkeyMesh = createMesh(monkeyCache);
+	auto meshLoadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - meshLoadStart).count();
 	// testMonkey.obj̃eNX`̓ǂݍ
-	const GLuint albedoMap = loadTexture("albedo.tga", true);
-	const GLuint aoMap = loadTexture("ao.tga", true);
-	const GLuint metallicMap = loadTexture("metallic.tga");
-	const GLuint roughnessMap = loadTexture("roughness.tga");
-	const GLuint normalMap = loadTexture("normal.tga");
-	const GLuint emissiveMap = loadTexture("emissive.tga", true);
+	// fR[h̓[J[XbhōsAǂݍ݂I܂ł̓tH[obN̐Fŕ`悷
+	ThreadPool threadPool;
+	TextureStreamer textureStreamer(threadPool);
+	const auto albedoFallback = glm::u8vec4(128, 128, 128, 255);
+	const auto ormFallback = glm::u8vec4(255, 128, 0, 255); // AO: 1, tlX: 0.5, ^bN: 0
+	const auto normalFallback = glm::u8vec4(128, 128, 255, 255);
+	const auto emissiveFallback = glm::u8vec4(0, 0, 0, 255);
+	const TextureHandle albedoMap = textureStreamer.load("albedo.tga", TextureBakeColor, true, albedoFallback);
+	const TextureHandle ormMap = textureStreamer.load({ "ao.tga", "roughness.tga", "metallic.tga" }, "ao.tga.orm.dds", TextureBakeORM, true, ormFallback);
+	const TextureHandle normalMap = textureStreamer.load("normal.tga", TextureBakeNormal, false, normalFallback);
+	const TextureHandle emissiveMap = textureStreamer.load("emissive.tga", TextureBakeColor, true, emissiveFallback);
 
 	// floor.obj̃[h
-	std::vector<glm::vec3> floorVertices;
-	std::vector<glm::vec2> floorUVs;
-	std::vector<glm::vec3> floorNormals;
-	std::vector<glm::vec3> floorTangents;
-	if (!loadOBJ("floor.obj", floorVertices, floorUVs, floorNormals, floorTangents))
+	meshLoadStart = std::chrono::steady_clock::now();
+	bool floorCacheHit = false;
+	MeshCache floorCache;
+	if (!loadOBJCached("floor.obj", floorCache, &floorCacheHit))
 	{
 		std::cerr << "Can't load obj file: floor.obj" << std::endl;
 		return 1;
 	}
+	printMeshStats("floor.obj", floorCache);
 	// floor.objVAO̍쐬
-	GLuint floorVao;
-	glGenVertexArrays(1, &floorVao);
-	glBindVertexArray(floorVao);
-	GLuint floorVerticesVBO;
-	glGenBuffers(1, &floorVerticesVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, floorVerticesVBO);
-	glBufferData(GL_ARRAY_BUFFER, floorVertices.size() * sizeof(glm::vec3), &floorVertices[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	GLuint floorUVsVBO;
-	glGenBuffers(1, &floorUVsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, floorUVsVBO);
-	glBufferData(GL_ARRAY_BUFFER, floorUVs.size() * sizeof(glm::vec2), &floorUVs[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	GLuint floorNormalsVBO;
-	glGenBuffers(1, &floorNormalsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, floorNormalsVBO);
-	glBufferData(GL_ARRAY_BUFFER, floorNormals.size() * sizeof(glm::vec3), &floorNormals[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	GLuint floorTangentsVBO;
-	glGenBuffers(1, &floorTangentsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, floorTangentsVBO);
-	glBufferData(GL_ARRAY_BUFFER, floorTangents.size() * sizeof(glm::vec3), &floorTangents[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(3);
-	glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	glBindVertexArray(0);
+	const Mesh floorMesh = createMesh(floorCache);
+	meshLoadTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - meshLoadStart).count();
+	std::cout << "Mesh load: " << meshLoadTime << " ms (" << (monkeyCacheHit && floorCacheHit ? "warm" : "cold") << " cache)" << std::endl;
 	// testMonkey.obj̃eNX`̓ǂݍ
-	const GLuint floorAlbedoMap = loadTexture("floorAlbedo.tga", true);
-	const GLuint floorAoMap = loadTexture("floorAo.tga", true);
-	const GLuint floorMetallicMap = loadTexture("floorMetallic.tga");
-	const GLuint floorRoughnessMap = loadTexture("floorRoughness.tga");
-	const GLuint floorNormalMap = loadTexture("floorNormal.tga");
-	const GLuint floorEmissiveMap = loadTexture("floorEmissive.tga", true);
+	const TextureHandle floorAlbedoMap = textureStreamer.load("floorAlbedo.tga", TextureBakeColor, true, albedoFallback);
+	const TextureHandle floorOrmMap = textureStreamer.load({ "floorAo.tga", "floorRoughness.tga", "floorMetallic.tga" }, "floorAo.tga.orm.dds", TextureBakeORM, true, ormFallback);
+	const TextureHandle floorNormalMap = textureStreamer.load("floorNormal.tga", TextureBakeNormal, false, normalFallback);
+	const TextureHandle floorEmissiveMap = textureStreamer.load("floorEmissive.tga", TextureBakeColor, true, emissiveFallback);
 
 	// fullscreen meshVAO쐬
 	const std::array<glm::vec2, 3> fullscreenMeshVertices = {
@@ -585,22 +419,18 @@ int main() {
 		glm::vec2(2.0, 0.0),
 		glm::vec2(0.0, 2.0)
 	};
+	const GLuint fullscreenMeshVerticesVBO = createBuffer(sizeof(fullscreenMeshVertices), &fullscreenMeshVertices[0]);
+	const GLuint fullscreenMeshUVsVBO = createBuffer(sizeof(fullscreenMeshUVs), &fullscreenMeshUVs[0]);
 	GLuint fullscreenMeshVAO;
-	glGenVertexArrays(1, &fullscreenMeshVAO);
-	glBindVertexArray(fullscreenMeshVAO);
-	GLuint fullscreenMeshVerticesVBO;
-	glGenBuffers(1, &fullscreenMeshVerticesVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, fullscreenMeshVerticesVBO);
-	glBufferData(GL_ARRAY_BUFFER, 3 * sizeof(glm::vec2), &fullscreenMeshVertices[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	GLuint fullscreenMeshUVsVBO;
-	glGenBuffers(1, &fullscreenMeshUVsVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, fullscreenMeshUVsVBO);
-	glBufferData(GL_ARRAY_BUFFER, 3 * sizeof(glm::vec2), &fullscreenMeshUVs[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	glBindVertexArray(0);
+	glCreateVertexArrays(1, &fullscreenMeshVAO);
+	glVertexArrayVertexBuffer(fullscreenMeshVAO, 0, fullscreenMeshVerticesVBO, 0, sizeof(glm::vec2));
+	glEnableVertexArrayAttrib(fullscreenMeshVAO, 0);
+	glVertexArrayAttribFormat(fullscreenMeshVAO, 0, 2, GL_FLOAT, GL_FALSE, 0);
+	glVertexArrayAttribBinding(fullscreenMeshVAO, 0, 0);
+	glVertexArrayVertexBuffer(fullscreenMeshVAO, 1, fullscreenMeshUVsVBO, 0, sizeof(glm::vec2));
+	glEnableVertexArrayAttrib(fullscreenMeshVAO, 1);
+	glVertexArrayAttribFormat(fullscreenMeshVAO, 1, 2, GL_FLOAT, GL_FALSE, 0);
+	glVertexArrayAttribBinding(fullscreenMeshVAO, 1, 1);
 
 	// aʒűVAO쐬
 	const int slices = 8, stacks = 8;
@@ -636,274 +466,119 @@ int main() {
 			sphereIndices.emplace_back(k1);
 		}
 	}
+	const GLuint sphereVerticesVBO = createBuffer(sphereVertices.size() * sizeof(glm::vec3), &sphereVertices[0]);
+	const GLuint sphereIndicesIBO = createBuffer(sphereIndices.size() * sizeof(GLuint), &sphereIndices[0]);
 	GLuint sphereVAO;
-	glGenVertexArrays(1, &sphereVAO);
-	glBindVertexArray(sphereVAO);
-	GLuint sphereVerticesVBO;
-	glGenBuffers(1, &sphereVerticesVBO);
-	glBindBuffer(GL_ARRAY_BUFFER, sphereVerticesVBO);
-	glBufferData(GL_ARRAY_BUFFER, sphereVertices.size() * sizeof(glm::vec3), &sphereVertices[0], GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, static_cast<void*>(0));
-	GLuint sphereIndicesIBO;
-	glGenBuffers(1, &sphereIndicesIBO);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereIndicesIBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sphereIndices.size() * sizeof(GLuint), &sphereIndices[0], GL_STATIC_DRAW);
-	glBindVertexArray(0);
+	glCreateVertexArrays(1, &sphereVAO);
+	glVertexArrayVertexBuffer(sphereVAO, 0, sphereVerticesVBO, 0, sizeof(glm::vec3));
+	glEnableVertexArrayAttrib(sphereVAO, 0);
+	glVertexArrayAttribFormat(sphereVAO, 0, 3, GL_FLOAT, GL_FALSE, 0);
+	glVertexArrayAttribBinding(sphereVAO, 0, 0);
+	glVertexArrayElementBuffer(sphereVAO, sphereIndicesIBO);
+
+	// X|bgCg̃{[̉~ (͈͂ƊO̊px̓CgƂ̕ϊō킹)
+	const VolumeMesh coneMesh = createConeMesh(16);
+	const GLuint coneVerticesVBO = createBuffer(coneMesh.vertices.size() * sizeof(glm::vec3), &coneMesh.vertices[0]);
+	const GLuint coneIndicesIBO = createBuffer(coneMesh.indices.size() * sizeof(uint32_t), &coneMesh.indices[0]);
+	GLuint coneVAO;
+	glCreateVertexArrays(1, &coneVAO);
+	glVertexArrayVertexBuffer(coneVAO, 0, coneVerticesVBO, 0, sizeof(glm::vec3));
+	glEnableVertexArrayAttrib(coneVAO, 0);
+	glVertexArrayAttribFormat(coneVAO, 0, 3, GL_FLOAT, GL_FALSE, 0);
+	glVertexArrayAttribBinding(coneVAO, 0, 0);
+	glVertexArrayElementBuffer(coneVAO, coneIndicesIBO);
+
+	// _[^[QbgƃVhE}bv̓t[[vŃ_[Otɐ錾
+	const GLsizei directionalShadowMapSize = 8192;
+	const GLsizei pointLightShadowMapSize = 512;
+	const GLsizei spotLightShadowMapSize = 512;
 
 	// shader program擾uniformϐ̏ꏊ擾
-	const GLuint geometryPassShaderProgram = createProgram("GeometryPass.vert", "GeometryPass.frag");
-	const GLuint geometryPassModelITLoc = glGetUniformLocation(geometryPassShaderProgram, "ModelIT");
-	const GLuint geometryPassModelViewLoc = glGetUniformLocation(geometryPassShaderProgram, "ModelView");
-	const GLuint geometryPassProjectionLoc = glGetUniformLocation(geometryPassShaderProgram, "Projection");
-	const GLuint geometryPassProjectionParamsLoc = glGetUniformLocation(geometryPassShaderProgram, "ProjectionParams");
-	const GLuint geometryPassAlbedoMapLoc = glGetUniformLocation(geometryPassShaderProgram, "albedoMap");
-	const GLuint geometryPassAoMapLoc = glGetUniformLocation(geometryPassShaderProgram, "aoMap");
-	const GLuint geometryPassMetallicMapLoc = glGetUniformLocation(geometryPassShaderProgram, "metallicMap");
-	const GLuint geometryPassRoughnessMapLoc = glGetUniformLocation(geometryPassShaderProgram, "roughnessMap");
-	const GLuint geometryPassNormalMapLoc = glGetUniformLocation(geometryPassShaderProgram, "normalMap");
-	const GLuint geometryPassEmissiveMapLoc = glGetUniformLocation(geometryPassShaderProgram, "emissiveMap");
-	const GLuint geometryPassEmissiveIntensityLoc = glGetUniformLocation(geometryPassShaderProgram, "emissiveIntensity");
-
-	const GLuint directionalShadowMapPassShaderProgram = createProgram("DirectionalShadowMapPass.vert", "DirectionalShadowMapPass.frag");
-	const GLuint directionalShadowMapPassModelViewProjectionLoc = glGetUniformLocation(directionalShadowMapPassShaderProgram, "ModelViewProjection");
-
-	const GLuint emissiveAndDirectionalLightPassShaderProgram = createProgram("EmissiveAndDirectionalLightPass.vert", "EmissiveAndDirectionalLightPass.frag");
-	const GLuint emissiveAndDirectionalLightPassGBuffer0Loc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "GBuffer0");
-	const GLuint emissiveAndDirectionalLightPassGBuffer1Loc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "GBuffer1");
-	const GLuint emissiveAndDirectionalLightPassGBuffer2Loc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "GBuffer2");
-	const GLuint emissiveAndDirectionalLightPassGBuffer3Loc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "GBuffer3");
-	const GLuint emissiveAndDirectionalLightPassLightDirectionLoc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "LightDirection");
-	const GLuint emissiveAndDirectionalLightPassLightIntensityLoc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "LightIntensity");
-	const GLuint emissiveAndDirectionalLightPassLightColorLoc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "LightColor");
-	const GLuint emissiveAndDirectionalLightPassWorldCameraPosLoc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "worldCameraPos");
-	const GLuint emissiveAndDirectionalLightPassViewProjectionILoc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "ViewProjectionI");
-	const GLuint emissiveAndDirectionalLightPassProjectionParamsLoc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "ProjectionParams");
-	const GLuint emissiveAndDirectionalLightPassShadowMapLoc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "ShadowMap");
-	const GLuint emissiveAndDirectionalLightPassLightViewProjectionLoc = glGetUniformLocation(emissiveAndDirectionalLightPassShaderProgram, "LightViewProjection");
-
-	const GLuint pointLightShadowMapPassShaderProgram = createProgramWithGeometryShader("PointLightShadowMapPass.vert", "PointLightShadowMapPass.geom", "PointLightShadowMapPass.frag");
-	const GLuint pointLightShadowMapPassModelLoc = glGetUniformLocation(pointLightShadowMapPassShaderProgram, "Model");
+	// RpC͋Nɔsς݂Ȃ̂ŁAł̓N̊҂
+	const GLuint geometryPassShaderProgram = programCache.get(geometryPassProgram);
+
+	const GLuint directionalShadowMapPassShaderProgram = programCache.get(directionalShadowMapPassProgram);
+
+	const GLuint emissiveAndDirectionalLightPassShaderProgram = programCache.get(emissiveAndDirectionalLightPassProgram);
+	setDisneyMaterialUniforms(emissiveAndDirectionalLightPassShaderProgram, sceneMaterial);
+
+	const GLuint pointLightShadowMapPassShaderProgram = programCache.get(pointLightShadowMapPassProgram);
 	const GLuint pointLightShadowMapPassShadowMatricesLoc = glGetUniformLocation(pointLightShadowMapPassShaderProgram, "shadowMatrices");
 	const GLuint pointLightShadowMapPassWorldLightPosLoc = glGetUniformLocation(pointLightShadowMapPassShaderProgram, "worldLightPos");
 	const GLuint pointLightShadowMapPassFarLoc = glGetUniformLocation(pointLightShadowMapPassShaderProgram, "far");
 
-	const GLuint punctualLightStencilPassShaderProgram = createProgram("PunctualLightStencilPass.vert", "PunctualLightStencilPass.frag");
-	const GLuint punctualLightStencilPassModelViewProjectionLoc = glGetUniformLocation(punctualLightStencilPassShaderProgram, "ModelViewProjection");
-
-	const GLuint pointLightPassShaderProgram = createProgram("PointLightPass.vert", "PointLightPass.frag");
-	const GLuint pointLightPassModelViewProjectionLoc = glGetUniformLocation(pointLightPassShaderProgram, "ModelViewProjection");
-	const GLuint pointLightPassGBuffer0Loc = glGetUniformLocation(pointLightPassShaderProgram, "GBuffer0");
-	const GLuint pointLightPassGBuffer1Loc = glGetUniformLocation(pointLightPassShaderProgram, "GBuffer1");
-	const GLuint pointLightPassGBuffer2Loc = glGetUniformLocation(pointLightPassShaderProgram, "GBuffer2");
-	const GLuint pointLightPassGBuffer3Loc = glGetUniformLocation(pointLightPassShaderProgram, "GBuffer3");
-	const GLuint pointLightPassWorldLightPosition = glGetUniformLocation(pointLightPassShaderProgram, "worldLightPosition");
-	const GLuint pointLightPassLightIntensityLoc = glGetUniformLocation(pointLightPassShaderProgram, "LightIntensity");
-	const GLuint pointLightPassLightColorLoc = glGetUniformLocation(pointLightPassShaderProgram, "LightColor");
-	const GLuint pointLightPassLightRangeLoc = glGetUniformLocation(pointLightPassShaderProgram, "LightRange");
-	const GLuint pointLightPassWorldCameraPosLoc = glGetUniformLocation(pointLightPassShaderProgram, "worldCameraPos");
-	const GLuint pointLightPassViewProjectionILoc = glGetUniformLocation(pointLightPassShaderProgram, "ViewProjectionI");
-	const GLuint pointLightPassProjectionParamsLoc = glGetUniformLocation(pointLightPassShaderProgram, "ProjectionParams");
-	const GLuint pointLightPassResolutionLoc = glGetUniformLocation(pointLightPassShaderProgram, "resolution");
-	const GLuint pointLightPassShadowMapLoc = glGetUniformLocation(pointLightPassShaderProgram, "ShadowMap");
-	const GLuint pointLightPassShadowBiasLoc = glGetUniformLocation(pointLightPassShaderProgram, "shadowBias");
-
-	const GLuint spotLightShadowMapPassShaderProgram = createProgram("SpotLightShadowMapPass.vert", "SpotLightShadowMapPass.frag");
-	const GLuint spotLightShadowMapPassModelViewProjectionLoc = glGetUniformLocation(spotLightShadowMapPassShaderProgram, "ModelViewProjection");
-
-	const GLuint spotLightPassShaderProgram = createProgram("SpotLightPass.vert", "SpotLightPass.frag");
-	const GLuint spotLightPassModelViewProjectionLoc = glGetUniformLocation(spotLightPassShaderProgram, "ModelViewProjection");
-	const GLuint spotLightPassGBuffer0Loc = glGetUniformLocation(spotLightPassShaderProgram, "GBuffer0");
-	const GLuint spotLightPassGBuffer1Loc = glGetUniformLocation(spotLightPassShaderProgram, "GBuffer1");
-	const GLuint spotLightPassGBuffer2Loc = glGetUniformLocation(spotLightPassShaderProgram, "GBuffer2");
-	const GLuint spotLightPassGBuffer3Loc = glGetUniformLocation(spotLightPassShaderProgram, "GBuffer3");
-	const GLuint spotLightPassWorldLightPosition = glGetUniformLocation(spotLightPassShaderProgram, "worldLightPosition");
-	const GLuint spotLightPassLightIntensityLoc = glGetUniformLocation(spotLightPassShaderProgram, "LightIntensity");
-	const GLuint spotLightPassLightColorLoc = glGetUniformLocation(spotLightPassShaderProgram, "LightColor");
-	const GLuint spotLightPassLightRangeLoc = glGetUniformLocation(spotLightPassShaderProgram, "LightRange");
-	const GLuint spotLightPassLightDirectionLoc = glGetUniformLocation(spotLightPassShaderProgram, "LightDirection");
-	const GLuint spotLightPassLightAngleLoc = glGetUniformLocation(spotLightPassShaderProgram, "LightAngle");
-	const GLuint spotLightPassLightBlendLoc = glGetUniformLocation(spotLightPassShaderProgram, "LightBlend");
-	const GLuint spotLightPassWorldCameraPosLoc = glGetUniformLocation(spotLightPassShaderProgram, "worldCameraPos");
-	const GLuint spotLightPassViewProjectionILoc = glGetUniformLocation(spotLightPassShaderProgram, "ViewProjectionI");
-	const GLuint spotLightPassProjectionParamsLoc = glGetUniformLocation(spotLightPassShaderProgram, "ProjectionParams");
-	const GLuint spotLightPassResolutionLoc = glGetUniformLocation(spotLightPassShaderProgram, "resolution");
-	const GLuint spotLightPassShadowMapLoc = glGetUniformLocation(spotLightPassShaderProgram, "ShadowMap");
-	const GLuint spotLightPassLightViewProjectionLoc = glGetUniformLocation(spotLightPassShaderProgram, "LightViewProjection");
-
-	const GLuint logAverageShaderProgram = createProgram("LogAveragePass.vert", "LogAveragePass.frag");
-	const GLuint logAveragePassInputTextureLoc = glGetUniformLocation(logAverageShaderProgram, "inputTexture");
-
-	const GLuint postprocessShaderProgram = createProgram("Postprocess.vert", "Postprocess.frag");
-	const GLuint postprocessInputTextureLoc = glGetUniformLocation(postprocessShaderProgram, "inputTexture");
+	const GLuint punctualLightStencilPassShaderProgram = programCache.get(punctualLightStencilPassProgram);
+
+	const GLuint pointLightPassShaderProgram = programCache.get(pointLightPassProgram);
+	setDisneyMaterialUniforms(pointLightPassShaderProgram, sceneMaterial);
+
+	const GLuint unshadowedPointLightPassShaderProgram = programCache.get(unshadowedPointLightPassProgram);
+	setDisneyMaterialUniforms(unshadowedPointLightPassShaderProgram, sceneMaterial);
+
+	const GLuint spotLightShadowMapPassShaderProgram = programCache.get(spotLightShadowMapPassProgram);
+
+	const GLuint spotLightPassShaderProgram = programCache.get(spotLightPassProgram);
+	setDisneyMaterialUniforms(spotLightPassShaderProgram, sceneMaterial);
+
+	const GLuint lightVolumePassShaderProgram = programCache.get(lightVolumePassProgram);
+	setDisneyMaterialUniforms(lightVolumePassShaderProgram, sceneMaterial);
+
+	const GLuint coneLightVolumePassShaderProgram = programCache.get(coneLightVolumePassProgram);
+	setDisneyMaterialUniforms(coneLightVolumePassShaderProgram, sceneMaterial);
+
+	const GLuint tiledLightingPassShaderProgram = programCache.get(tiledLightingPassProgram);
+	setDisneyMaterialUniforms(tiledLightingPassShaderProgram, sceneMaterial);
+
+	const GLuint clusteredLightingPassShaderProgram = programCache.get(clusteredLightingPassProgram);
+	setDisneyMaterialUniforms(clusteredLightingPassShaderProgram, sceneMaterial);
+
+	const GLuint logAverageShaderProgram = programCache.get(logAverageProgram);
+
+	const GLuint postprocessShaderProgram = programCache.get(postprocessProgram);
 	const GLuint postprocessApertureLoc = glGetUniformLocation(postprocessShaderProgram, "aperture");
 	const GLuint postprocessShutterSpeedLoc = glGetUniformLocation(postprocessShaderProgram, "shutterSpeed");
 	const GLuint postprocessISOLoc = glGetUniformLocation(postprocessShaderProgram, "iso");
-
-	// FBO쐬
-	GLuint GBuffer0ColorBuffer;
-	glGenTextures(1, &GBuffer0ColorBuffer);
-	glBindTexture(GL_TEXTURE_2D, GBuffer0ColorBuffer);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	GLuint GBuffer1ColorBuffer;
-	glGenTextures(1, &GBuffer1ColorBuffer);
-	glBindTexture(GL_TEXTURE_2D, GBuffer1ColorBuffer);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	GLuint GBuffer2ColorBuffer;
-	glGenTextures(1, &GBuffer2ColorBuffer);
-	glBindTexture(GL_TEXTURE_2D, GBuffer2ColorBuffer);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	GLuint GBuffer3ColorBuffer;
-	glGenTextures(1, &GBuffer3ColorBuffer);
-	glBindTexture(GL_TEXTURE_2D, GBuffer3ColorBuffer);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	GLuint GBufferDepthBuffer;
-	glGenRenderbuffers(1, &GBufferDepthBuffer);
-	glBindRenderbuffer(GL_RENDERBUFFER, GBufferDepthBuffer);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-	glBindRenderbuffer(GL_RENDERBUFFER, 0);
-	GLuint GBufferFBO;
-	glGenFramebuffers(1, &GBufferFBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, GBufferFBO);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, GBuffer0ColorBuffer, 0);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, GBuffer1ColorBuffer, 0);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, GBuffer2ColorBuffer, 0);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT3, GL_TEXTURE_2D, GBuffer3ColorBuffer, 0);
-	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, GBufferDepthBuffer);
-	if (GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);  Status != GL_FRAMEBUFFER_COMPLETE) {
-		std::cerr << "Framebuffer Error: " << Status << std::endl;
-		return false;
-	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	GLuint HDRColorBuffer;
-	glGenTextures(1, &HDRColorBuffer);
-	glBindTexture(GL_TEXTURE_2D, HDRColorBuffer);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	GLuint HDRDepthBuffer;
-	glGenRenderbuffers(1, &HDRDepthBuffer);
-	glBindRenderbuffer(GL_RENDERBUFFER, HDRDepthBuffer);
-	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
-	glBindRenderbuffer(GL_RENDERBUFFER, 0);
-	GLuint HDRFBO;
-	glGenFramebuffers(1, &HDRFBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, HDRFBO);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, HDRColorBuffer, 0);
-	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, HDRDepthBuffer);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	GLuint LogAverageBuffer;
-	glGenTextures(1, &LogAverageBuffer);
-	glBindTexture(GL_TEXTURE_2D, LogAverageBuffer);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	GLuint LogAverageFBO;
-	glGenFramebuffers(1, &LogAverageFBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, LogAverageFBO);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, LogAverageBuffer, 0);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-
-	// Directional Light Shadow Map
-	const GLuint directionalShadowMapSize = 8192;
-	GLuint DirectionalShadowMap;
-	glGenTextures(1, &DirectionalShadowMap);
-	glBindTexture(GL_TEXTURE_2D, DirectionalShadowMap);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, directionalShadowMapSize, directionalShadowMapSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	GLuint DirectionalShadowMapFBO;
-	glGenFramebuffers(1, &DirectionalShadowMapFBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, DirectionalShadowMapFBO);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, DirectionalShadowMap, 0);
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	// Point Light Shadow Map
-	const GLuint pointLightShadowMapSize = 512;
-	GLuint PointLightShadowMap;
-	glGenTextures(1, &PointLightShadowMap);
-	glBindTexture(GL_TEXTURE_CUBE_MAP, PointLightShadowMap);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-	for (int i = 0; i < 6; i++)
-	{
-		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_DEPTH_COMPONENT, pointLightShadowMapSize, pointLightShadowMapSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-	}
-	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-	GLuint PointLightShadowMapFBO;
-	glGenFramebuffers(1, &PointLightShadowMapFBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, PointLightShadowMapFBO);
-	glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, PointLightShadowMap, 0);
-	glDrawBuffer(GL_NONE);
-	glReadBuffer(GL_NONE);
-	if (GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER); Status != GL_FRAMEBUFFER_COMPLETE) {
-		std::cerr << "Framebuffer Error: " << Status << std::endl;
-		return false;
-	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	// Spot Light Shadow Map
-	const GLuint spotLightShadowMapSize = 512;
-	GLuint SpotLightShadowMap;
-	glGenTextures(1, &SpotLightShadowMap);
-	glBindTexture(GL_TEXTURE_2D, SpotLightShadowMap);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, spotLightShadowMapSize, spotLightShadowMapSize, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	glBindTexture(GL_TEXTURE_2D, 0);
-	GLuint SpotLightShadowMapFBO;
-	glGenFramebuffers(1, &SpotLightShadowMapFBO);
-	glBindFramebuffer(GL_FRAMEBUFFER, SpotLightShadowMapFBO);
-	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, SpotLightShadowMap, 0);
-	if (GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER); Status != GL_FRAMEBUFFER_COMPLETE) {
-		std::cerr << "Framebuffer Error: " << Status << std::endl;
-		return false;
-	}
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
+	programCache.report();
+
+
+	// JƃCg̒萔ƕ`悲Ƃ̃f[^͉i}bvOobt@ɒڏ
+	GLint uniformBufferAlignment = 256;
+	GLint storageBufferAlignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformBufferAlignment);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageBufferAlignment);
+	const GLuint maxDrawsPerFrame = 4096;
+	// rp̓_́AXeV̌oHłuniform block (ő256oCgE) ƕ`f[^1A^C^̌oHłPunctualLight1g
+	const GLuint maxFillLights = 4096;
+	// NX^̌oHł͂ɃNX^(offset, count)ƃCgԍ̔z𖈃t[
+	ClusteredLights clusteredLights(16, 12, 24);
+	std::vector<glm::vec4> clusterSpheres;
+	const GLsizeiptr maxClusterLightIndices = 1024 * 1024;
+	const GLsizeiptr clusterGridSize = sizeof(ClusterGridHeader) + clusteredLights.clusters().size() * sizeof(ClusterRange);
+	StreamRingBuffer streamBuffer(64 * 1024 + (maxDrawsPerFrame + maxFillLights) * sizeof(DrawData) + maxFillLights * 256 + (maxFillLights + 2) * sizeof(PunctualLight)
+		+ clusterGridSize + maxClusterLightIndices * sizeof(uint32_t));
+
+	// t[[ṽXe[gύX͑SĂʂAl̍ĐݒȂ
+	GLStateCache glState;
+
+	// `pXƈꎞIȃ_[^[Qbg͖t[錾 (͍̂\ς܂Ŏg)
+	RenderGraph renderGraph;
+
+	GpuTimer geometryPassTimer("Geometry Pass");
+	GpuTimer punctualLightTimer("Punctual Lights");
+
+	LightingPath lightingPath = LightingPathTiled;
+	std::vector<PunctualLight> fillLights;
+	bool toggleKeyDown = false;
+	bool benchmarkKeyDown = false;
+
+	// BL[Ŕrp̓_14096܂4{₵ASĂ̌oHGPUԂv
+	constexpr std::array<size_t, 7> benchmarkLightCounts = { 1, 4, 16, 64, 256, 1024, 4096 };
+	const int benchmarkWarmupFrames = 10; // Ȍ̃NǦʂǂݏI܂ł͎̂Ă
+	const int benchmarkFrames = 60;
+	int benchmarkStep = -1; // ̃CfbNX * LightingPathCount + oH (-1ȂvĂȂ)
+	int benchmarkFrame = 0;
+	LightingPath lightingPathBeforeBenchmark = lightingPath;
+	std::array<std::array<double, LightingPathCount>, benchmarkLightCounts.size()> benchmarkResults{};
 
 	glfwSetTime(0.0);
 
@@ -915,6 +590,32 @@ int main() {
 		deltaTime = static_cast<float>(glfwGetTime()) - prevTime;
 		prevTime = static_cast<float>(glfwGetTime());
 
+		// TL[ŌoH؂ւABL[Ōvn߂
+		const bool toggleKey = glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS;
+		if (toggleKey && !toggleKeyDown && benchmarkStep < 0)
+		{
+			lightingPath = static_cast<LightingPath>((lightingPath + 1) % LightingPathCount);
+			std::cout << "Lighting path: " << lightingPathName(lightingPath) << std::endl;
+		}
+		toggleKeyDown = toggleKey;
+		const bool benchmarkKey = glfwGetKey(window, GLFW_KEY_B) == GLFW_PRESS;
+		if (benchmarkKey && !benchmarkKeyDown && benchmarkStep < 0)
+		{
+			lightingPathBeforeBenchmark = lightingPath;
+			benchmarkStep = 0;
+			benchmarkFrame = 0;
+		}
+		benchmarkKeyDown = benchmarkKey;
+		if (benchmarkStep >= 0 && benchmarkFrame == 0)
+		{
+			lightingPath = static_cast<LightingPath>(benchmarkStep % LightingPathCount);
+			fillLights = createFillLights(benchmarkLightCounts[benchmarkStep / LightingPathCount]);
+		}
+
+		// fR[hIeNX`̃Abv[h
+		// DSAŃAbv[ĥŃeNX`jbg̃oCh͕ςȂ
+		textureStreamer.update();
+
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -936,223 +637,232 @@ int main() {
 		auto DirectionalLightIntensity = 30.0f;
 		auto DirectionalLightColor = glm::vec3(1.0, 1.0, 1.0);
 
+		auto DirectionalLightPosition = glm::vec3(0, 0, 0);
+		auto DirectionalLightView = glm::lookAt(DirectionalLightPosition, DirectionalLightPosition + DirectionalLightDirection, glm::vec3(0, 1, 0));
+		auto DirectionalLightProjection = glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, -10.0f, 20.0f);
+		auto DirectionalLightViewProjection = DirectionalLightProjection * DirectionalLightView;
 
-		// Geometry Pass
-		glEnable(GL_STENCIL_TEST);
-
-		glStencilFunc(GL_ALWAYS, 128, 128);
-		glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-		glStencilMask(255);
-		glDepthMask(GL_TRUE);
-		glEnable(GL_DEPTH_TEST);
-		glDisable(GL_BLEND);
-
-		glUseProgram(geometryPassShaderProgram);
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, GBufferFBO);
-
-		const GLenum bufs[] = {
-			GL_COLOR_ATTACHMENT0,
-			GL_COLOR_ATTACHMENT1,
-			GL_COLOR_ATTACHMENT2,
-			GL_COLOR_ATTACHMENT3
-		};
-		glDrawBuffers(4, bufs);
-
-		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-		glClearDepth(1.0);
-		glClearStencil(0.0);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-
-		// testMonkey.obj̕`
+		auto pointLightPosition = glm::vec3(-5.0f, 8.0f, 0.0f);
+		auto pointLightIntensity = 24000.0f;
+		auto pointLightColor = glm::vec3(0.5, 1.0, 1.0);
+		auto pointLightRange = 20.0f;
+		auto pointLightShadowBias = 0.001f;
+
+		auto spotLightPosition = glm::vec3(4.0f, 8.0f, 4.0f);
+		auto spotLightIntensity = 16000.0f;
+		auto spotLightColor = glm::vec3(1.0, 0.5, 0.5);
+		auto spotLightRange = 30.0f;
+		auto spotLightDirection = glm::vec3(-1.0, -1.0, -1.0);
+		auto spotLightAngle = glm::radians(45.0f);
+		auto spotLightBlend = 0.15f;
+
+		auto SpotLightView = glm::lookAt(spotLightPosition, spotLightPosition + spotLightDirection, glm::vec3(0, 1, 0));
+		auto SpotLightProjection = glm::perspective(spotLightAngle, 1.0f, 0.1f, spotLightRange);
+		auto SpotLightViewProjection = SpotLightProjection * SpotLightView;
+
+		// JƊeCguniform block
+		streamBuffer.beginFrame();
+
+		FrameUniforms frameUniforms = {};
+		frameUniforms.View = View;
+		frameUniforms.Projection = Projection;
+		frameUniforms.ViewProjection = ViewProjection;
+		frameUniforms.ViewProjectionI = ViewProjectionI;
+		frameUniforms.worldCameraPos = cameraPos;
+		frameUniforms.ProjectionParams = ProjectionParams;
+		frameUniforms.resolution = resolution;
+		const StreamRange frameBlock = streamBuffer.push(frameUniforms, uniformBufferAlignment);
+
+		DirectionalLightUniforms directionalLightUniforms = {};
+		directionalLightUniforms.LightViewProjection = DirectionalLightViewProjection;
+		directionalLightUniforms.LightDirection = DirectionalLightDirection;
+		directionalLightUniforms.LightIntensity = DirectionalLightIntensity;
+		directionalLightUniforms.LightColor = DirectionalLightColor;
+		const StreamRange directionalLightBlock = streamBuffer.push(directionalLightUniforms, uniformBufferAlignment);
+
+		PointLightUniforms pointLightUniforms = {};
+		pointLightUniforms.worldLightPosition = pointLightPosition;
+		pointLightUniforms.LightIntensity = pointLightIntensity;
+		pointLightUniforms.LightColor = pointLightColor;
+		pointLightUniforms.LightRange = pointLightRange;
+		pointLightUniforms.shadowBias = pointLightShadowBias;
+		const StreamRange pointLightBlock = streamBuffer.push(pointLightUniforms, uniformBufferAlignment);
+
+		SpotLightUniforms spotLightUniforms = {};
+		spotLightUniforms.LightViewProjection = SpotLightViewProjection;
+		spotLightUniforms.worldLightPosition = spotLightPosition;
+		spotLightUniforms.LightIntensity = spotLightIntensity;
+		spotLightUniforms.LightColor = spotLightColor;
+		spotLightUniforms.LightRange = spotLightRange;
+		spotLightUniforms.LightDirection = spotLightDirection;
+		spotLightUniforms.LightAngle = spotLightAngle;
+		spotLightUniforms.LightBlend = spotLightBlend;
+		const StreamRange spotLightBlock = streamBuffer.push(spotLightUniforms, uniformBufferAlignment);
+
+		// ^C^̌oHł̓V[̃CgƔrp̓_1̃Xg[Wobt@œn
+		PunctualLight pointLight = {};
+		pointLight.position = pointLightPosition;
+		pointLight.range = pointLightRange;
+		pointLight.color = pointLightColor;
+		pointLight.intensity = pointLightIntensity;
+		pointLight.type = PunctualLightPoint;
+		pointLight.shadowMap = PunctualLightShadowCube;
+		pointLight.shadowBias = pointLightShadowBias;
+
+		PunctualLight spotLight = {};
+		spotLight.position = spotLightPosition;
+		spotLight.range = spotLightRange;
+		spotLight.color = spotLightColor;
+		spotLight.intensity = spotLightIntensity;
+		spotLight.direction = glm::normalize(spotLightDirection);
+		spotLight.cosOuterAngle = std::cos(spotLightAngle / 2.0f);
+		spotLight.cosInnerAngle = std::cos(spotLightAngle / 2.0f * (1.0f - spotLightBlend));
+		spotLight.type = PunctualLightSpot;
+		spotLight.shadowMap = PunctualLightShadowSpot;
+
+		streamBuffer.bind(GL_UNIFORM_BUFFER, UniformBindingFrame, frameBlock);
+
+		// `悲Ƃ̃f[^ (CfbNXgl_BaseInstanceŃVF[_ɓn)
+		StreamArray<DrawData> draws(streamBuffer, maxDrawsPerFrame + maxFillLights, storageBufferAlignment);
+		streamBuffer.bind(GL_SHADER_STORAGE_BUFFER, StorageBindingDraw, draws.range);
+
+
+		// fs (epXŎg)
 		auto Model = glm::rotate(glm::mat4(1), static_cast<float>(glfwGetTime()), glm::vec3(0, 1, 0));
 		Model = glm::translate(Model, glm::vec3(0, 3, 0));
 		auto ModelIT = glm::inverseTranspose(Model);
-		auto ModelView = View * Model;
-
-		auto emissiveIntensity = 2000.0f;
-
-		glUniformMatrix4fv(geometryPassModelITLoc, 1, GL_FALSE, &ModelIT[0][0]);
-		glUniformMatrix4fv(geometryPassModelViewLoc, 1, GL_FALSE, &ModelView[0][0]);
-		glUniformMatrix4fv(geometryPassProjectionLoc, 1, GL_FALSE, &Projection[0][0]);
-		glUniform2fv(geometryPassProjectionParamsLoc, 1, &ProjectionParams[0]);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, albedoMap);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, aoMap);
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, metallicMap);
-		glActiveTexture(GL_TEXTURE3);
-		glBindTexture(GL_TEXTURE_2D, roughnessMap);
-		glActiveTexture(GL_TEXTURE4);
-		glBindTexture(GL_TEXTURE_2D, normalMap);
-		glActiveTexture(GL_TEXTURE5);
-		glBindTexture(GL_TEXTURE_2D, emissiveMap);
-
-		glUniform1fv(geometryPassEmissiveIntensityLoc, 1, &emissiveIntensity);
-
-		glUniform1i(geometryPassAlbedoMapLoc, 0);
-		glUniform1i(geometryPassAoMapLoc, 1);
-		glUniform1i(geometryPassMetallicMapLoc, 2);
-		glUniform1i(geometryPassRoughnessMapLoc, 3);
-		glUniform1i(geometryPassNormalMapLoc, 4);
-		glUniform1i(geometryPassEmissiveMapLoc, 5);
-
-		glBindVertexArray(vao);
-		glDrawArrays(GL_TRIANGLES, 0, vertices.size());
+		auto ModelView = View * Model * monkeyMesh.dequantize;
 
 		auto Model1 = glm::translate(Model, glm::vec3(0, 1, 0));
 		auto Model1IT = glm::inverseTranspose(Model1);
-		auto ModelView1 = View * Model1;
-		glUniformMatrix4fv(geometryPassModelITLoc, 1, GL_FALSE, &Model1IT[0][0]);
-		glUniformMatrix4fv(geometryPassModelViewLoc, 1, GL_FALSE, &ModelView1[0][0]);
-		glBindVertexArray(vao);
-		glDrawArrays(GL_TRIANGLES, 0, vertices.size());
+		auto ModelView1 = View * Model1 * monkeyMesh.dequantize;
 
-		// floor.obj̕`
 		auto ModelFloor = glm::mat4(1);
 		auto ModelFloorIT = glm::inverseTranspose(ModelFloor);
-		auto ModelViewFloor = View * ModelFloor;
+		auto ModelViewFloor = View * ModelFloor * floorMesh.dequantize;
 
+		auto emissiveIntensity = 2000.0f;
 		auto emissiveFloorIntensity = 0.0f;
 
-		glUniformMatrix4fv(geometryPassModelITLoc, 1, GL_FALSE, &ModelFloorIT[0][0]);
-		glUniformMatrix4fv(geometryPassModelViewLoc, 1, GL_FALSE, &ModelViewFloor[0][0]);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, floorAlbedoMap);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, floorAoMap);
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, floorMetallicMap);
-		glActiveTexture(GL_TEXTURE3);
-		glBindTexture(GL_TEXTURE_2D, floorRoughnessMap);
-		glActiveTexture(GL_TEXTURE4);
-		glBindTexture(GL_TEXTURE_2D, floorNormalMap);
-		glActiveTexture(GL_TEXTURE5);
-		glBindTexture(GL_TEXTURE_2D, floorEmissiveMap);
-
-		glUniform1fv(geometryPassEmissiveIntensityLoc, 1, &emissiveFloorIntensity);
-
-		glBindVertexArray(floorVao);
-		glDrawArrays(GL_TRIANGLES, 0, floorVertices.size());
+		// _[Ot
+		// pXǂݏeNX`錾AsƎ̂̋Lcompile()Ō߂
+		renderGraph.reset();
+		const auto GBuffer0ColorBuffer = renderGraph.createTexture("GBuffer0", renderTargetDesc(GL_RGBA8, width, height, GL_LINEAR));
+		const auto GBuffer1ColorBuffer = renderGraph.createTexture("GBuffer1", renderTargetDesc(GL_RGBA8, width, height, GL_NEAREST));
+		const auto GBuffer2ColorBuffer = renderGraph.createTexture("GBuffer2", renderTargetDesc(GL_RGBA8, width, height, GL_NEAREST));
+		const auto GBuffer3ColorBuffer = renderGraph.createTexture("GBuffer3", renderTargetDesc(GL_RGBA16F, width, height, GL_NEAREST));
+		const auto GBufferDepthBuffer = renderGraph.createTexture("GBufferDepth", renderTargetDesc(GL_DEPTH24_STENCIL8, width, height, GL_NEAREST));
+		// ^C^̌oHimageLoad/imageStoreŉẐRGBAɂ (3`l̃C[W`͖)
+		const auto HDRColorBuffer = renderGraph.createTexture("HDRColor", renderTargetDesc(GL_RGBA16F, width, height, GL_NEAREST));
+		const auto HDRDepthBuffer = renderGraph.createTexture("HDRDepth", renderTargetDesc(GL_DEPTH24_STENCIL8, width, height, GL_NEAREST));
+		// ΐPx1`lBt[glGenerateTextureMipmap1x1܂ŏk̂ŁASẴ~bvxmۂ
+		const auto LogAverageBuffer = renderGraph.createTexture("LogAverage", renderTargetDesc(GL_R32F, width, height, GL_LINEAR, mipLevelCount(width, height)));
+		const auto DirectionalShadowMap = renderGraph.createTexture("DirectionalShadowMap", shadowMapDesc(GL_TEXTURE_2D, directionalShadowMapSize));
+		const auto PointLightShadowMap = renderGraph.createTexture("PointLightShadowMap", shadowMapDesc(GL_TEXTURE_CUBE_MAP, pointLightShadowMapSize));
+		const auto SpotLightShadowMap = renderGraph.createTexture("SpotLightShadowMap", shadowMapDesc(GL_TEXTURE_2D, spotLightShadowMapSize));
+
+		// LogAveragepXŌ߁APostprocesspXŎg
+		float aperture, shutterSpeed, iso;
 
+		// Geometry Pass
+		renderGraph.addPass("Geometry", [&](const RenderGraphPass& pass)
+		{
+			geometryPassTimer.begin();
+			glState.enable(GL_STENCIL_TEST);
+
+			glState.stencilFunc(GL_ALWAYS, 128, 128);
+			glState.stencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+			glState.stencilMask(255);
+			glState.depthMask(GL_TRUE);
+			glState.enable(GL_DEPTH_TEST);
+			glState.disable(GL_BLEND);
+
+			glState.useProgram(geometryPassShaderProgram);
+			glState.bindFramebuffer(GL_DRAW_FRAMEBUFFER, pass.framebuffer);
+			glState.viewport(0, 0, width, height);
+
+			glState.clearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glState.clearDepth(1.0);
+			glState.clearStencil(0);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+			// wi̐[x1ɂĂA^C^̌oHwỉf΂悤ɂ
+			const GLfloat backgroundGBuffer3[] = { 0.0f, 0.0f, 0.0f, 1.0f };
+			glClearBufferfv(GL_COLOR, 3, backgroundGBuffer3);
+
+			// testMonkey.obj̕`
+			glState.bindTextureUnit(TextureUnitAlbedo, textureStreamer.texture(albedoMap));
+			glState.bindTextureUnit(TextureUnitOrm, textureStreamer.texture(ormMap));
+			glState.bindTextureUnit(TextureUnitNormal, textureStreamer.texture(normalMap));
+			glState.bindTextureUnit(TextureUnitEmissive, textureStreamer.texture(emissiveMap));
+
+			glState.bindVertexArray(monkeyMesh.vao);
+			drawIndexed(monkeyMesh.indexCount, monkeyMesh.indexType, draws.push(geometryDrawData(ModelIT, ModelView, emissiveIntensity)));
+
+			drawIndexed(monkeyMesh.indexCount, monkeyMesh.indexType, draws.push(geometryDrawData(Model1IT, ModelView1, emissiveIntensity)));
+
+			// floor.obj̕`
+			glState.bindTextureUnit(TextureUnitAlbedo, textureStreamer.texture(floorAlbedoMap));
+			glState.bindTextureUnit(TextureUnitOrm, textureStreamer.texture(floorOrmMap));
+			glState.bindTextureUnit(TextureUnitNormal, textureStreamer.texture(floorNormalMap));
+			glState.bindTextureUnit(TextureUnitEmissive, textureStreamer.texture(floorEmissiveMap));
+
+			glState.bindVertexArray(floorMesh.vao);
+			drawIndexed(floorMesh.indexCount, floorMesh.indexType, draws.push(geometryDrawData(ModelFloorIT, ModelViewFloor, emissiveFloorIntensity)));
+			geometryPassTimer.end();
+		})
+			.write(GBuffer0ColorBuffer, RenderGraphUsageColorAttachment)
+			.write(GBuffer1ColorBuffer, RenderGraphUsageColorAttachment)
+			.write(GBuffer2ColorBuffer, RenderGraphUsageColorAttachment)
+			.write(GBuffer3ColorBuffer, RenderGraphUsageColorAttachment)
+			.write(GBufferDepthBuffer, RenderGraphUsageDepthAttachment);
 
 		// Directional Light Shadow Pass
-		glUseProgram(directionalShadowMapPassShaderProgram);
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, DirectionalShadowMapFBO);
-
-		auto DirectionalLightOffsetFactor = 2.0f;
-		auto DirectionalLightOffsetUnits = 5.0f;
-
-		glPolygonOffset(DirectionalLightOffsetFactor, DirectionalLightOffsetUnits);
-		glEnable(GL_POLYGON_OFFSET_FILL);
-
-		glStencilFunc(GL_ALWAYS, 0, 0);
-		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-
-		glClear(GL_DEPTH_BUFFER_BIT);
-
-		glViewport(0, 0, directionalShadowMapSize, directionalShadowMapSize);
-
-		auto DirectionalLightPosition = glm::vec3(0, 0, 0);
-		auto DirectionalLightView = glm::lookAt(DirectionalLightPosition, DirectionalLightPosition + DirectionalLightDirection, glm::vec3(0, 1, 0));
-		auto DirectionalLightProjection = glm::ortho(-20.0f, 20.0f, -20.0f, 20.0f, -10.0f, 20.0f);
-		auto DirectionalLightViewProjection = DirectionalLightProjection * DirectionalLightView;
-
-		auto DirectionalLightModelViewProjection = DirectionalLightViewProjection * Model;
-		glUniformMatrix4fv(directionalShadowMapPassModelViewProjectionLoc, 1, GL_FALSE, &DirectionalLightModelViewProjection[0][0]);
-		glBindVertexArray(vao);
-		glDrawArrays(GL_TRIANGLES, 0, vertices.size());
-
-		auto DirectionalLightModel1ViewProjection = DirectionalLightViewProjection * Model1;
-		glUniformMatrix4fv(directionalShadowMapPassModelViewProjectionLoc, 1, GL_FALSE, &DirectionalLightModel1ViewProjection[0][0]);
-		glDrawArrays(GL_TRIANGLES, 0, vertices.size());
-
-		auto DirectionalLightModelFloorViewProjection = DirectionalLightViewProjection * ModelFloor;
-		glUniformMatrix4fv(directionalShadowMapPassModelViewProjectionLoc, 1, GL_FALSE, &DirectionalLightModelFloorViewProjection[0][0]);
-		glBindVertexArray(floorVao);
-		glDrawArrays(GL_TRIANGLES, 0, floorVertices.size());
-
-		glDisable(GL_POLYGON_OFFSET_FILL);
-
-
-		// Emissive and DirectionalLight Pass
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, GBufferDepthBuffer);
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, HDRDepthBuffer);
-		glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
-
-		glStencilFunc(GL_EQUAL, 128, 128);
-		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-		glStencilMask(0);
-
-		glDepthMask(GL_FALSE);
-		glDisable(GL_DEPTH_TEST);
-
-		glEnable(GL_BLEND);
-		glBlendEquation(GL_FUNC_ADD);
-		glBlendFunc(GL_ONE, GL_ONE);
-
-		glViewport(0, 0, width, height);
+		renderGraph.addPass("DirectionalLightShadow", [&](const RenderGraphPass& pass)
+		{
+			glState.useProgram(directionalShadowMapPassShaderProgram);
+			glState.bindFramebuffer(GL_DRAW_FRAMEBUFFER, pass.framebuffer);
 
-		glUseProgram(emissiveAndDirectionalLightPassShaderProgram);
-		glUniform3fv(emissiveAndDirectionalLightPassLightDirectionLoc, 1, &DirectionalLightDirection[0]);
-		glUniform1fv(emissiveAndDirectionalLightPassLightIntensityLoc, 1, &DirectionalLightIntensity);
-		glUniform3fv(emissiveAndDirectionalLightPassLightColorLoc, 1, &DirectionalLightColor[0]);
-		glUniform3fv(emissiveAndDirectionalLightPassWorldCameraPosLoc, 1, &cameraPos[0]);
-		glUniformMatrix4fv(emissiveAndDirectionalLightPassViewProjectionILoc, 1, GL_FALSE, &ViewProjectionI[0][0]);
-		glUniform2fv(emissiveAndDirectionalLightPassProjectionParamsLoc, 1, &ProjectionParams[0]);
+			auto DirectionalLightOffsetFactor = 2.0f;
+			auto DirectionalLightOffsetUnits = 5.0f;
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, GBuffer0ColorBuffer);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, GBuffer1ColorBuffer);
-		glActiveTexture(GL_TEXTURE2);
-		glBindTexture(GL_TEXTURE_2D, GBuffer2ColorBuffer);
-		glActiveTexture(GL_TEXTURE3);
-		glBindTexture(GL_TEXTURE_2D, GBuffer3ColorBuffer);
+			glState.polygonOffset(DirectionalLightOffsetFactor, DirectionalLightOffsetUnits);
+			glState.enable(GL_POLYGON_OFFSET_FILL);
 
-		glUniform1i(emissiveAndDirectionalLightPassGBuffer0Loc, 0);
-		glUniform1i(emissiveAndDirectionalLightPassGBuffer1Loc, 1);
-		glUniform1i(emissiveAndDirectionalLightPassGBuffer2Loc, 2);
-		glUniform1i(emissiveAndDirectionalLightPassGBuffer3Loc, 3);
+			glState.stencilFunc(GL_ALWAYS, 0, 0);
+			glState.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
-		glActiveTexture(GL_TEXTURE4);
-		glBindTexture(GL_TEXTURE_2D, DirectionalShadowMap);
+			glClear(GL_DEPTH_BUFFER_BIT);
 
-		glUniform1i(emissiveAndDirectionalLightPassShadowMapLoc, 4);
+			glState.viewport(0, 0, directionalShadowMapSize, directionalShadowMapSize);
 
-		glUniformMatrix4fv(emissiveAndDirectionalLightPassLightViewProjectionLoc, 1, GL_FALSE, &DirectionalLightViewProjection[0][0]);
+			auto DirectionalLightModelViewProjection = DirectionalLightViewProjection * Model * monkeyMesh.dequantize;
+			glState.bindVertexArray(monkeyMesh.shadowVao);
+			drawIndexed(monkeyMesh.indexCount, monkeyMesh.indexType, draws.push(transformDrawData(DirectionalLightModelViewProjection)));
 
-		glDrawBuffer(GL_COLOR_ATTACHMENT0);
-		glBindFramebuffer(GL_FRAMEBUFFER, HDRFBO);
-		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
+			auto DirectionalLightModel1ViewProjection = DirectionalLightViewProjection * Model1 * monkeyMesh.dequantize;
+			drawIndexed(monkeyMesh.indexCount, monkeyMesh.indexType, draws.push(transformDrawData(DirectionalLightModel1ViewProjection)));
 
-		glBindVertexArray(fullscreenMeshVAO);
-		glDrawArrays(GL_TRIANGLES, 0, 3);
+			auto DirectionalLightModelFloorViewProjection = DirectionalLightViewProjection * ModelFloor * floorMesh.dequantize;
+			glState.bindVertexArray(floorMesh.shadowVao);
+			drawIndexed(floorMesh.indexCount, floorMesh.indexType, draws.push(transformDrawData(DirectionalLightModelFloorViewProjection)));
 
+			glState.disable(GL_POLYGON_OFFSET_FILL);
+		})
+			.write(DirectionalShadowMap, RenderGraphUsageDepthAttachment);
 
-		// Point Light Pass
+		// Point Light Shadow Pass
+		renderGraph.addPass("PointLightShadow", [&](const RenderGraphPass& pass)
 		{
-			auto pointLightPosition = glm::vec3(-5.0f, 8.0f, 0.0f);
-			auto pointLightIntensity = 24000.0f;
-			auto pointLightColor = glm::vec3(0.5, 1.0, 1.0);
-			auto pointLightRange = 20.0f;
-			auto pointLightShadowBias = 0.001f;
-
+			glState.useProgram(pointLightShadowMapPassShaderProgram);
+			glState.bindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
 
-			// Point Light Shadow Pass
-			glUseProgram(pointLightShadowMapPassShaderProgram);
-			glBindFramebuffer(GL_FRAMEBUFFER, PointLightShadowMapFBO);
+			glState.stencilFunc(GL_ALWAYS, 0, 0);
+			glState.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
-			glStencilFunc(GL_ALWAYS, 0, 0);
-			glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+			glState.viewport(0, 0, pointLightShadowMapSize, pointLightShadowMapSize);
 
-			glViewport(0, 0, pointLightShadowMapSize, pointLightShadowMapSize);
-
-			glDepthMask(GL_TRUE);
-			glEnable(GL_DEPTH_TEST);
+			glState.depthMask(GL_TRUE);
+			glState.enable(GL_DEPTH_TEST);
 
 			glClear(GL_DEPTH_BUFFER_BIT);
 			auto PointLightShadowProjection = glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, pointLightRange);
@@ -1169,328 +879,569 @@ int main() {
 			glUniform1fv(pointLightShadowMapPassFarLoc, 1, &pointLightRange);
 			glUniform3fv(pointLightShadowMapPassWorldLightPosLoc, 1, &pointLightPosition[0]);
 
-			glUniformMatrix4fv(pointLightShadowMapPassModelLoc, 1, GL_FALSE, &Model[0][0]);
-			glBindVertexArray(vao);
-			glDrawArrays(GL_TRIANGLES, 0, vertices.size());
-
-			glUniformMatrix4fv(pointLightShadowMapPassModelLoc, 1, GL_FALSE, &Model1[0][0]);
-			glDrawArrays(GL_TRIANGLES, 0, vertices.size());
-
-			glUniformMatrix4fv(pointLightShadowMapPassModelLoc, 1, GL_FALSE, &ModelFloor[0][0]);
-			glBindVertexArray(floorVao);
-			glDrawArrays(GL_TRIANGLES, 0, floorVertices.size());
-
-			glViewport(0, 0, width, height);
-
-
-			// Punctual Light Stencil Pass
-			auto PointLightModel = glm::translate(glm::mat4(1.0), pointLightPosition);
-			PointLightModel = glm::scale(PointLightModel, glm::vec3(pointLightRange + 0.1));
-			auto PointLightModelViewProjection = Projection * View * PointLightModel;
-
-			glUseProgram(punctualLightStencilPassShaderProgram);
-			glBindFramebuffer(GL_FRAMEBUFFER, HDRFBO);
-
-			glUniformMatrix4fv(punctualLightStencilPassModelViewProjectionLoc, 1, GL_FALSE, &PointLightModelViewProjection[0][0]);
-
-			glEnable(GL_DEPTH_TEST);
-
-			glDisable(GL_CULL_FACE);
-
-			glStencilMask(255);
-			glClear(GL_STENCIL_BUFFER_BIT);
-
-			glStencilFunc(GL_ALWAYS, 0, 0);
-			glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
-			glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
-
-			glDrawBuffer(GL_NONE);
-			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-
-			glBindVertexArray(sphereVAO);
-			glDrawElements(GL_TRIANGLES, sphereIndices.size(), GL_UNSIGNED_INT, 0);
-
-
-			// Point Light Lighting Pass
-			glUseProgram(pointLightPassShaderProgram);
-
-			glUniform3fv(pointLightPassWorldCameraPosLoc, 1, &cameraPos[0]);
-			glUniformMatrix4fv(pointLightPassViewProjectionILoc, 1, GL_FALSE, &ViewProjectionI[0][0]);
-			glUniform2fv(pointLightPassProjectionParamsLoc, 1, &ProjectionParams[0]);
-			glUniform2fv(pointLightPassResolutionLoc, 1, &resolution[0]);
+			auto PointLightShadowModel = Model * monkeyMesh.dequantize;
+			glState.bindVertexArray(monkeyMesh.shadowVao);
+			drawIndexed(monkeyMesh.indexCount, monkeyMesh.indexType, draws.push(modelDrawData(PointLightShadowModel)));
 
-			glUniform3fv(pointLightPassWorldLightPosition, 1, &pointLightPosition[0]);
-			glUniform1fv(pointLightPassLightIntensityLoc, 1, &pointLightIntensity);
-			glUniform3fv(pointLightPassLightColorLoc, 1, &pointLightColor[0]);
-			glUniform1fv(pointLightPassLightRangeLoc, 1, &pointLightRange);
+			auto PointLightShadowModel1 = Model1 * monkeyMesh.dequantize;
+			drawIndexed(monkeyMesh.indexCount, monkeyMesh.indexType, draws.push(modelDrawData(PointLightShadowModel1)));
 
-			glUniformMatrix4fv(pointLightPassModelViewProjectionLoc, 1, GL_FALSE, &PointLightModelViewProjection[0][0]);
+			auto PointLightShadowModelFloor = ModelFloor * floorMesh.dequantize;
+			glState.bindVertexArray(floorMesh.shadowVao);
+			drawIndexed(floorMesh.indexCount, floorMesh.indexType, draws.push(modelDrawData(PointLightShadowModelFloor)));
 
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, GBuffer0ColorBuffer);
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, GBuffer1ColorBuffer);
-			glActiveTexture(GL_TEXTURE2);
-			glBindTexture(GL_TEXTURE_2D, GBuffer2ColorBuffer);
-			glActiveTexture(GL_TEXTURE3);
-			glBindTexture(GL_TEXTURE_2D, GBuffer3ColorBuffer);
+			glState.viewport(0, 0, width, height);
+		})
+			.write(PointLightShadowMap, RenderGraphUsageDepthAttachment);
 
-			glUniform1i(pointLightPassGBuffer0Loc, 0);
-			glUniform1i(pointLightPassGBuffer1Loc, 1);
-			glUniform1i(pointLightPassGBuffer2Loc, 2);
-			glUniform1i(pointLightPassGBuffer3Loc, 3);
-
-			glActiveTexture(GL_TEXTURE4);
-			glBindTexture(GL_TEXTURE_CUBE_MAP, PointLightShadowMap);
-
-			glUniform1i(pointLightPassShadowMapLoc, 4);
-
-			glUniform1fv(pointLightPassShadowBiasLoc, 1, &pointLightShadowBias);
-
-			glDisable(GL_DEPTH_TEST);
-
-			glStencilFunc(GL_NOTEQUAL, 0, 255);
-			glStencilMask(0);
-			glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-
-			glEnable(GL_CULL_FACE);
-			glCullFace(GL_FRONT);
-
-			glDrawBuffer(GL_COLOR_ATTACHMENT0);
-			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-
-			glBindVertexArray(sphereVAO);
-			glDrawElements(GL_TRIANGLES, sphereIndices.size(), GL_UNSIGNED_INT, 0);
-
-			glCullFace(GL_BACK);
-		}
-
-
-		// Spot Light Pass
+		// Spot Light Shadow Pass
+		renderGraph.addPass("SpotLightShadow", [&](const RenderGraphPass& pass)
 		{
-			auto spotLightPosition = glm::vec3(4.0f, 8.0f, 4.0f);
-			auto spotLightIntensity = 16000.0f;
-			auto spotLightColor = glm::vec3(1.0, 0.5, 0.5);
-			auto spotLightRange = 30.0f;
-			auto spotLightDirection = glm::vec3(-1.0, -1.0, -1.0);
-			auto spotLightAngle = glm::radians(45.0f);
-			auto spotLightBlend = 0.15f;
-
-
-			// Spot Light Shadow Pass
-			glUseProgram(spotLightShadowMapPassShaderProgram);
-			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, SpotLightShadowMapFBO);
+			glState.useProgram(spotLightShadowMapPassShaderProgram);
+			glState.bindFramebuffer(GL_DRAW_FRAMEBUFFER, pass.framebuffer);
 
 			auto LightOffsetFactor = 8.0f;
 			auto LightOffsetUnits = 1.0f;
 
-			glPolygonOffset(LightOffsetFactor, LightOffsetUnits);
-			glEnable(GL_POLYGON_OFFSET_FILL);
+			glState.polygonOffset(LightOffsetFactor, LightOffsetUnits);
+			glState.enable(GL_POLYGON_OFFSET_FILL);
 
-			glStencilFunc(GL_ALWAYS, 0, 0);
-			glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+			glState.stencilFunc(GL_ALWAYS, 0, 0);
+			glState.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
-			glDepthMask(GL_TRUE);
-			glEnable(GL_DEPTH_TEST);
+			glState.depthMask(GL_TRUE);
+			glState.enable(GL_DEPTH_TEST);
 
 			glClear(GL_DEPTH_BUFFER_BIT);
 
-			glViewport(0, 0, spotLightShadowMapSize, spotLightShadowMapSize);
-
-			auto LightView = glm::lookAt(spotLightPosition, spotLightPosition + spotLightDirection, glm::vec3(0, 1, 0));
-			auto LightProjection = glm::perspective(spotLightAngle, 1.0f, 0.1f, spotLightRange);
-			auto LightViewProjection = LightProjection * LightView;
-
-			auto LightModelViewProjection = LightViewProjection * Model;
-			glUniformMatrix4fv(spotLightShadowMapPassModelViewProjectionLoc, 1, GL_FALSE, &LightModelViewProjection[0][0]);
-			glBindVertexArray(vao);
-			glDrawArrays(GL_TRIANGLES, 0, vertices.size());
-
-			auto LightModel1ViewProjection = LightViewProjection * Model1;
-			glUniformMatrix4fv(spotLightShadowMapPassModelViewProjectionLoc, 1, GL_FALSE, &LightModel1ViewProjection[0][0]);
-			glDrawArrays(GL_TRIANGLES, 0, vertices.size());
-
-			auto LightModelFloorViewProjection = LightViewProjection * ModelFloor;
-			glUniformMatrix4fv(spotLightShadowMapPassModelViewProjectionLoc, 1, GL_FALSE, &LightModelFloorViewProjection[0][0]);
-			glBindVertexArray(floorVao);
-			glDrawArrays(GL_TRIANGLES, 0, floorVertices.size());
-
-			glDisable(GL_POLYGON_OFFSET_FILL);
-
-
-			// Punctual Light Stencil Pass
-			auto SpotLightModel = glm::translate(glm::mat4(1.0), spotLightPosition);
-			SpotLightModel = glm::scale(SpotLightModel, glm::vec3(spotLightRange + 0.1));
-			auto SpotLightModelViewProjection = Projection * View * SpotLightModel;
-
-			glUseProgram(punctualLightStencilPassShaderProgram);
-			glBindFramebuffer(GL_FRAMEBUFFER, HDRFBO);
-
-			glUniformMatrix4fv(punctualLightStencilPassModelViewProjectionLoc, 1, GL_FALSE, &SpotLightModelViewProjection[0][0]);
-
-			glEnable(GL_DEPTH_TEST);
-
-			glDisable(GL_CULL_FACE);
-
-			glStencilMask(255);
-			glClear(GL_STENCIL_BUFFER_BIT);
-
-			glStencilFunc(GL_ALWAYS, 0, 0);
-			glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
-			glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
-
-			glDrawBuffer(GL_NONE);
-			glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
-
-			glViewport(0, 0, width, height);
-
-			glBindVertexArray(sphereVAO);
-			glDrawElements(GL_TRIANGLES, sphereIndices.size(), GL_UNSIGNED_INT, 0);
+			glState.viewport(0, 0, spotLightShadowMapSize, spotLightShadowMapSize);
 
+			auto LightModelViewProjection = SpotLightViewProjection * Model * monkeyMesh.dequantize;
+			glState.bindVertexArray(monkeyMesh.shadowVao);
+			drawIndexed(monkeyMesh.indexCount, monkeyMesh.indexType, draws.push(transformDrawData(LightModelViewProjection)));
 
-			// Spot Light Lighting Pass
-			glUseProgram(spotLightPassShaderProgram);
+			auto LightModel1ViewProjection = SpotLightViewProjection * Model1 * monkeyMesh.dequantize;
+			drawIndexed(monkeyMesh.indexCount, monkeyMesh.indexType, draws.push(transformDrawData(LightModel1ViewProjection)));
 
-			glUniform3fv(spotLightPassWorldCameraPosLoc, 1, &cameraPos[0]);
-			glUniformMatrix4fv(spotLightPassViewProjectionILoc, 1, GL_FALSE, &ViewProjectionI[0][0]);
-			glUniform2fv(spotLightPassProjectionParamsLoc, 1, &ProjectionParams[0]);
-			glUniform2fv(spotLightPassResolutionLoc, 1, &resolution[0]);
+			auto LightModelFloorViewProjection = SpotLightViewProjection * ModelFloor * floorMesh.dequantize;
+			glState.bindVertexArray(floorMesh.shadowVao);
+			drawIndexed(floorMesh.indexCount, floorMesh.indexType, draws.push(transformDrawData(LightModelFloorViewProjection)));
 
-			glUniform3fv(spotLightPassWorldLightPosition, 1, &spotLightPosition[0]);
-			glUniform1fv(spotLightPassLightIntensityLoc, 1, &spotLightIntensity);
-			glUniform3fv(spotLightPassLightColorLoc, 1, &spotLightColor[0]);
-			glUniform1fv(spotLightPassLightRangeLoc, 1, &spotLightRange);
-			glUniform3fv(spotLightPassLightDirectionLoc, 1, &spotLightDirection[0]);
-			glUniform1fv(spotLightPassLightAngleLoc, 1, &spotLightAngle);
-			glUniform1fv(spotLightPassLightBlendLoc, 1, &spotLightBlend);
+			glState.disable(GL_POLYGON_OFFSET_FILL);
+		})
+			.write(SpotLightShadowMap, RenderGraphUsageDepthAttachment);
 
-			glUniformMatrix4fv(spotLightPassModelViewProjectionLoc, 1, GL_FALSE, &SpotLightModelViewProjection[0][0]);
-
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, GBuffer0ColorBuffer);
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, GBuffer1ColorBuffer);
-			glActiveTexture(GL_TEXTURE2);
-			glBindTexture(GL_TEXTURE_2D, GBuffer2ColorBuffer);
-			glActiveTexture(GL_TEXTURE3);
-			glBindTexture(GL_TEXTURE_2D, GBuffer3ColorBuffer);
-
-			glUniform1i(spotLightPassGBuffer0Loc, 0);
-			glUniform1i(spotLightPassGBuffer1Loc, 1);
-			glUniform1i(spotLightPassGBuffer2Loc, 2);
-			glUniform1i(spotLightPassGBuffer3Loc, 3);
-
-			glActiveTexture(GL_TEXTURE4);
-			glBindTexture(GL_TEXTURE_2D, SpotLightShadowMap);
-
-			glUniform1i(spotLightPassShadowMapLoc, 4);
-
-			glUniformMatrix4fv(spotLightPassLightViewProjectionLoc, 1, GL_FALSE, &LightViewProjection[0][0]);
-
-			glDisable(GL_DEPTH_TEST);
-
-			glStencilFunc(GL_NOTEQUAL, 0, 255);
-			glStencilMask(0);
-			glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
-
-			glEnable(GL_CULL_FACE);
-			glCullFace(GL_FRONT);
-
-			glDrawBuffer(GL_COLOR_ATTACHMENT0);
-			glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-
-			glBindVertexArray(sphereVAO);
-			glDrawElements(GL_TRIANGLES, sphereIndices.size(), GL_UNSIGNED_INT, 0);
-
-			glCullFace(GL_BACK);
+		// Emissive and DirectionalLight Pass
+		renderGraph.addPass("EmissiveAndDirectionalLight", [&](const RenderGraphPass& pass)
+		{
+			glBlitNamedFramebuffer(renderGraph.framebuffer({}, GBufferDepthBuffer), pass.framebuffer, 0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+
+			glState.stencilFunc(GL_EQUAL, 128, 128);
+			glState.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+			glState.stencilMask(0);
+
+			glState.depthMask(GL_FALSE);
+			glState.disable(GL_DEPTH_TEST);
+
+			glState.enable(GL_BLEND);
+			glState.blendEquation(GL_FUNC_ADD);
+			glState.blendFunc(GL_ONE, GL_ONE);
+
+			glState.viewport(0, 0, width, height);
+
+			glState.useProgram(emissiveAndDirectionalLightPassShaderProgram);
+			streamBuffer.bind(GL_UNIFORM_BUFFER, UniformBindingLight, directionalLightBlock);
+
+			glState.bindTextureUnit(TextureUnitGBuffer0, renderGraph.texture(GBuffer0ColorBuffer));
+			glState.bindTextureUnit(TextureUnitGBuffer1, renderGraph.texture(GBuffer1ColorBuffer));
+			glState.bindTextureUnit(TextureUnitGBuffer2, renderGraph.texture(GBuffer2ColorBuffer));
+			glState.bindTextureUnit(TextureUnitGBuffer3, renderGraph.texture(GBuffer3ColorBuffer));
+			glState.bindTextureUnit(TextureUnitShadowMap, renderGraph.texture(DirectionalShadowMap));
+
+			glState.bindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+			glState.drawBuffer(GL_COLOR_ATTACHMENT0);
+			glState.clearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+
+			glState.bindVertexArray(fullscreenMeshVAO);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		})
+			.read(GBuffer0ColorBuffer, RenderGraphUsageSampled)
+			.read(GBuffer1ColorBuffer, RenderGraphUsageSampled)
+			.read(GBuffer2ColorBuffer, RenderGraphUsageSampled)
+			.read(GBuffer3ColorBuffer, RenderGraphUsageSampled)
+			.read(DirectionalShadowMap, RenderGraphUsageSampled)
+			.read(GBufferDepthBuffer, RenderGraphUsageTransfer)
+			.write(HDRColorBuffer, RenderGraphUsageColorAttachment)
+			.write(HDRDepthBuffer, RenderGraphUsageDepthAttachment);
+
+		// _ƃX|bgCg (VhE}bv͏Őɕ`̂ŁAǂ̌oHłCeBÕpXĎs)
+		if (lightingPath == LightingPathStencil)
+		{
+			// Point Light Pass (stencil and lighting)
+			renderGraph.addPass("PointLight", [&](const RenderGraphPass& pass)
+			{
+				punctualLightTimer.begin();
+				glState.bindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+
+				glState.bindTextureUnit(TextureUnitGBuffer0, renderGraph.texture(GBuffer0ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer1, renderGraph.texture(GBuffer1ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer2, renderGraph.texture(GBuffer2ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer3, renderGraph.texture(GBuffer3ColorBuffer));
+				glState.bindTextureUnit(TextureUnitShadowMap, renderGraph.texture(PointLightShadowMap));
+
+				// Cg̃{[ŃXeVAXeV0łȂfCeBO
+				const auto drawPointLight = [&](GLuint lightingProgram, const StreamRange& lightBlock, const glm::vec3& position, float range)
+				{
+					auto PointLightModel = glm::translate(glm::mat4(1.0), position);
+					PointLightModel = glm::scale(PointLightModel, glm::vec3(range + 0.1));
+					auto PointLightModelViewProjection = Projection * View * PointLightModel;
+
+					glState.useProgram(punctualLightStencilPassShaderProgram);
+
+					// XeVƃCeBOœ`f[^g
+					const GLuint pointLightVolumeDraw = draws.push(transformDrawData(PointLightModelViewProjection));
+
+					glState.enable(GL_DEPTH_TEST);
+
+					glState.disable(GL_CULL_FACE);
+
+					glState.stencilMask(255);
+					glClear(GL_STENCIL_BUFFER_BIT);
+
+					glState.stencilFunc(GL_ALWAYS, 0, 0);
+					glState.stencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+					glState.stencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+
+					glState.drawBuffer(GL_NONE);
+					glState.colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+					glState.bindVertexArray(sphereVAO);
+					drawIndexed(static_cast<GLsizei>(sphereIndices.size()), GL_UNSIGNED_INT, pointLightVolumeDraw);
+
+
+					// Point Light Lighting Pass
+					glState.useProgram(lightingProgram);
+					streamBuffer.bind(GL_UNIFORM_BUFFER, UniformBindingLight, lightBlock);
+
+					glState.disable(GL_DEPTH_TEST);
+
+					glState.stencilFunc(GL_NOTEQUAL, 0, 255);
+					glState.stencilMask(0);
+					glState.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
+					glState.enable(GL_CULL_FACE);
+					glState.cullFace(GL_FRONT);
+
+					glState.drawBuffer(GL_COLOR_ATTACHMENT0);
+					glState.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+					glState.bindVertexArray(sphereVAO);
+					drawIndexed(static_cast<GLsizei>(sphereIndices.size()), GL_UNSIGNED_INT, pointLightVolumeDraw);
+
+					glState.cullFace(GL_BACK);
+				};
+
+				drawPointLight(pointLightPassShaderProgram, pointLightBlock, pointLightPosition, pointLightRange);
+				for (const auto& light : fillLights)
+				{
+					drawPointLight(unshadowedPointLightPassShaderProgram, streamBuffer.push(toPointLightUniforms(light), uniformBufferAlignment), light.position, light.range);
+				}
+			})
+				.read(GBuffer0ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer1ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer2ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer3ColorBuffer, RenderGraphUsageSampled)
+				.read(PointLightShadowMap, RenderGraphUsageSampled)
+				.write(HDRColorBuffer, RenderGraphUsageColorAttachment)
+				.write(HDRDepthBuffer, RenderGraphUsageDepthAttachment);
+
+			// Spot Light Pass (stencil and lighting)
+			renderGraph.addPass("SpotLight", [&](const RenderGraphPass& pass)
+			{
+				// ~̃{[g (L~͋)Aʏ̋`̊O̓VU[Ŏ̂Ă
+				const bool cone = useConeVolume(spotLight.cosOuterAngle);
+				glm::mat4 SpotLightModel;
+				if (cone)
+				{
+					SpotLightModel = coneVolumeModel(spotLightPosition, spotLight.direction, spotLightRange + 0.1f, spotLight.cosOuterAngle);
+				}
+				else
+				{
+					SpotLightModel = glm::translate(glm::mat4(1.0), spotLightPosition);
+					SpotLightModel = glm::scale(SpotLightModel, glm::vec3(spotLightRange + 0.1));
+				}
+				auto SpotLightModelViewProjection = Projection * View * SpotLightModel;
+				const GLuint volumeVAO = cone ? coneVAO : sphereVAO;
+				const GLsizei volumeIndexCount = static_cast<GLsizei>(cone ? coneMesh.indices.size() : sphereIndices.size());
+
+				ScreenRect scissor = {};
+				const bool scissored = screenBounds(cone ? coneMesh.vertices : sphereVertices, SpotLightModelViewProjection, width, height, scissor);
+				if (scissored && (scissor.width == 0 || scissor.height == 0))
+				{
+					// ʂ̊O
+					punctualLightTimer.end();
+					return;
+				}
+
+				glState.useProgram(punctualLightStencilPassShaderProgram);
+				glState.bindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+
+				// XeṼNACeBO`̒ōs
+				if (scissored)
+				{
+					glState.enable(GL_SCISSOR_TEST);
+					glState.scissor(scissor.x, scissor.y, scissor.width, scissor.height);
+				}
+
+				// XeVƃCeBOœ`f[^g
+				const GLuint spotLightVolumeDraw = draws.push(transformDrawData(SpotLightModelViewProjection));
+
+				glState.enable(GL_DEPTH_TEST);
+
+				glState.disable(GL_CULL_FACE);
+
+				glState.stencilMask(255);
+				glClear(GL_STENCIL_BUFFER_BIT);
+
+				glState.stencilFunc(GL_ALWAYS, 0, 0);
+				glState.stencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+				glState.stencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+
+				glState.drawBuffer(GL_NONE);
+				glState.colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+				glState.viewport(0, 0, width, height);
+
+				glState.bindVertexArray(volumeVAO);
+				drawIndexed(volumeIndexCount, GL_UNSIGNED_INT, spotLightVolumeDraw);
+
+
+				// Spot Light Lighting Pass
+				glState.useProgram(spotLightPassShaderProgram);
+				streamBuffer.bind(GL_UNIFORM_BUFFER, UniformBindingLight, spotLightBlock);
+
+				glState.bindTextureUnit(TextureUnitGBuffer0, renderGraph.texture(GBuffer0ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer1, renderGraph.texture(GBuffer1ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer2, renderGraph.texture(GBuffer2ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer3, renderGraph.texture(GBuffer3ColorBuffer));
+				glState.bindTextureUnit(TextureUnitShadowMap, renderGraph.texture(SpotLightShadowMap));
+
+				glState.disable(GL_DEPTH_TEST);
+
+				glState.stencilFunc(GL_NOTEQUAL, 0, 255);
+				glState.stencilMask(0);
+				glState.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+
+				glState.enable(GL_CULL_FACE);
+				glState.cullFace(GL_FRONT);
+
+				glState.drawBuffer(GL_COLOR_ATTACHMENT0);
+				glState.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+				glState.bindVertexArray(volumeVAO);
+				drawIndexed(volumeIndexCount, GL_UNSIGNED_INT, spotLightVolumeDraw);
+
+				glState.cullFace(GL_BACK);
+				glState.disable(GL_SCISSOR_TEST);
+				punctualLightTimer.end();
+			})
+				.read(GBuffer0ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer1ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer2ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer3ColorBuffer, RenderGraphUsageSampled)
+				.read(SpotLightShadowMap, RenderGraphUsageSampled)
+				.write(HDRColorBuffer, RenderGraphUsageColorAttachment)
+				.write(HDRDepthBuffer, RenderGraphUsageDepthAttachment);
+		}
+		else if (lightingPath == LightingPathInstanced)
+		{
+			// Light Volume Pass (_ƃX|bgCg̃{[`Ƃ1̃CX^X`ŕ`)
+			renderGraph.addPass("LightVolumes", [&](const RenderGraphPass& pass)
+			{
+				punctualLightTimer.begin();
+
+				// Cg̃p[^̓CX^XƂɃXg[Wobt@ǂ
+				// ŕ`Cg (_ƍLX|bgCg) ɁA~ŕ`X|bgCgɕׂ
+				StreamArray<PunctualLight> lights(streamBuffer, maxFillLights + 2, storageBufferAlignment);
+				lights.push(pointLight);
+				for (const auto& light : fillLights)
+				{
+					lights.push(light);
+				}
+				const bool spotLightCone = useConeVolume(spotLight.cosOuterAngle);
+				if (!spotLightCone)
+				{
+					lights.push(spotLight);
+				}
+				const GLuint sphereLightCount = lights.count;
+				if (spotLightCone)
+				{
+					lights.push(spotLight);
+				}
+				const GLuint coneLightCount = lights.count - sphereLightCount;
+				streamBuffer.bind(GL_SHADER_STORAGE_BUFFER, StorageBindingLights, lights.range);
+
+				PunctualLightingUniforms punctualLightingUniforms = {};
+				punctualLightingUniforms.SpotLightViewProjection = SpotLightViewProjection;
+				punctualLightingUniforms.lightCount = lights.count;
+				streamBuffer.bind(GL_UNIFORM_BUFFER, UniformBindingLight, streamBuffer.push(punctualLightingUniforms, uniformBufferAlignment));
+
+				glState.useProgram(lightVolumePassShaderProgram);
+				glState.bindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+
+				glState.bindTextureUnit(TextureUnitGBuffer0, renderGraph.texture(GBuffer0ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer1, renderGraph.texture(GBuffer1ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer2, renderGraph.texture(GBuffer2ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer3, renderGraph.texture(GBuffer3ColorBuffer));
+				glState.bindTextureUnit(TextureUnitShadowMap, renderGraph.texture(PointLightShadowMap));
+				glState.bindTextureUnit(TextureUnitSpotShadowMap, renderGraph.texture(SpotLightShadowMap));
+
+				// XeV͍炸A{[̗ʂOɂf[xeXgőI (J{[̒ɂĂʂ͌)
+				// {[Ỏf̓VF[_ŃCg͈̔͂̊OƂĎ̂āAwi̓WIgpX̃XeṼrbgŏ
+				glState.stencilFunc(GL_EQUAL, 128, 128);
+				glState.stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+				glState.stencilMask(0);
+
+				glState.enable(GL_DEPTH_TEST);
+				glState.depthFunc(GL_GEQUAL);
+				glState.depthMask(GL_FALSE);
+				// Nbvʂzʂ̂ĂȂ
+				glState.enable(GL_DEPTH_CLAMP);
+
+				glState.enable(GL_CULL_FACE);
+				glState.cullFace(GL_FRONT);
+
+				glState.drawBuffer(GL_COLOR_ATTACHMENT0);
+				glState.colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+				glState.viewport(0, 0, width, height);
+
+				// VU[͕`悲ƂȂ̂ŁACX^XƂ̋`͎gȂ
+				glState.bindVertexArray(sphereVAO);
+				drawIndexedInstanced(static_cast<GLsizei>(sphereIndices.size()), GL_UNSIGNED_INT, 0, sphereLightCount);
+				if (coneLightCount > 0)
+				{
+					glState.useProgram(coneLightVolumePassShaderProgram);
+					glState.bindVertexArray(coneVAO);
+					drawIndexedInstanced(static_cast<GLsizei>(coneMesh.indices.size()), GL_UNSIGNED_INT, sphereLightCount, coneLightCount);
+				}
+
+				glState.cullFace(GL_BACK);
+				glState.disable(GL_DEPTH_CLAMP);
+				glState.depthFunc(GL_LESS);
+				punctualLightTimer.end();
+			})
+				.read(GBuffer0ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer1ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer2ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer3ColorBuffer, RenderGraphUsageSampled)
+				.read(PointLightShadowMap, RenderGraphUsageSampled)
+				.read(SpotLightShadowMap, RenderGraphUsageSampled)
+				.write(HDRColorBuffer, RenderGraphUsageColorAttachment)
+				.write(HDRDepthBuffer, RenderGraphUsageDepthAttachment);
+		}
+		else
+		{
+			// Tiled / Clustered Lighting Pass (SẴCg1̃fBXpb`HDRColorɉZ)
+			const bool clustered = lightingPath == LightingPathClustered;
+			renderGraph.addPass(clustered ? "ClusteredLighting" : "TiledLighting", [&, clustered](const RenderGraphPass&)
+			{
+				punctualLightTimer.begin();
+
+				StreamArray<PunctualLight> lights(streamBuffer, maxFillLights + 2, storageBufferAlignment);
+				clusterSpheres.clear();
+				const auto pushLight = [&](const PunctualLight& light)
+				{
+					lights.push(light);
+					if (clustered)
+					{
+						// r[Ԃ̋EŃNX^Ɋ蓖Ă
+						const glm::vec4 sphere = lightBoundingSphere(light);
+						clusterSpheres.push_back(glm::vec4(glm::vec3(View * glm::vec4(glm::vec3(sphere), 1.0f)), sphere.w));
+					}
+				};
+				pushLight(pointLight);
+				pushLight(spotLight);
+				for (const auto& light : fillLights)
+				{
+					pushLight(light);
+				}
+				streamBuffer.bind(GL_SHADER_STORAGE_BUFFER, StorageBindingLights, lights.range);
+
+				if (clustered)
+				{
+					clusteredLights.setProjection(Projection, near, far, static_cast<float>(width), static_cast<float>(height));
+					clusteredLights.assign(clusterSpheres, &threadPool);
+
+					const auto& clusters = clusteredLights.clusters();
+					const auto& indices = clusteredLights.indices();
+					StreamRange gridRange = {};
+					StreamRange indexRange = {};
+					void* grid = streamBuffer.allocate(clusterGridSize, storageBufferAlignment, gridRange);
+					// ͈̔͂̓oChłȂ̂ōŒ1vf
+					void* lightIndices = streamBuffer.allocate(std::max<size_t>(indices.size(), 1) * sizeof(uint32_t), storageBufferAlignment, indexRange);
+					if (grid == nullptr || lightIndices == nullptr)
+					{
+						// ꂽt[̓NX^̌oH̃Cg`Ȃ
+						punctualLightTimer.end();
+						return;
+					}
+					std::memcpy(grid, &clusteredLights.header(), sizeof(ClusterGridHeader));
+					std::memcpy(static_cast<uint8_t*>(grid) + sizeof(ClusterGridHeader), clusters.data(), clusters.size() * sizeof(ClusterRange));
+					std::memcpy(lightIndices, indices.data(), indices.size() * sizeof(uint32_t));
+					streamBuffer.bind(GL_SHADER_STORAGE_BUFFER, StorageBindingClusterGrid, gridRange);
+					streamBuffer.bind(GL_SHADER_STORAGE_BUFFER, StorageBindingClusterLightIndices, indexRange);
+				}
+
+				PunctualLightingUniforms punctualLightingUniforms = {};
+				punctualLightingUniforms.SpotLightViewProjection = SpotLightViewProjection;
+				punctualLightingUniforms.lightCount = lights.count;
+				streamBuffer.bind(GL_UNIFORM_BUFFER, UniformBindingLight, streamBuffer.push(punctualLightingUniforms, uniformBufferAlignment));
+
+				glState.useProgram(clustered ? clusteredLightingPassShaderProgram : tiledLightingPassShaderProgram);
+
+				glState.bindTextureUnit(TextureUnitGBuffer0, renderGraph.texture(GBuffer0ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer1, renderGraph.texture(GBuffer1ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer2, renderGraph.texture(GBuffer2ColorBuffer));
+				glState.bindTextureUnit(TextureUnitGBuffer3, renderGraph.texture(GBuffer3ColorBuffer));
+				glState.bindTextureUnit(TextureUnitShadowMap, renderGraph.texture(PointLightShadowMap));
+				glState.bindTextureUnit(TextureUnitSpotShadowMap, renderGraph.texture(SpotLightShadowMap));
+				glBindImageTexture(ImageUnitHDRColor, renderGraph.texture(HDRColorBuffer), 0, GL_FALSE, 0, GL_READ_WRITE, GL_RGBA16F);
+
+				// 16x16̃^CƂ1̃[NO[v
+				glDispatchCompute((width + 15) / 16, (height + 15) / 16, 1);
+				punctualLightTimer.end();
+			})
+				.read(GBuffer0ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer1ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer2ColorBuffer, RenderGraphUsageSampled)
+				.read(GBuffer3ColorBuffer, RenderGraphUsageSampled)
+				.read(PointLightShadowMap, RenderGraphUsageSampled)
+				.read(SpotLightShadowMap, RenderGraphUsageSampled)
+				.read(HDRColorBuffer, RenderGraphUsageImage)
+				.write(HDRColorBuffer, RenderGraphUsageImage);
 		}
 
+		// Calc Log Average (IoCPUɓǂݖ߂)
+		renderGraph.addPass("LogAverage", [&](const RenderGraphPass& pass)
+		{
+			glState.disable(GL_STENCIL_TEST);
+			glState.useProgram(logAverageShaderProgram);
 
-		// Calc Log Average
-		glDisable(GL_STENCIL_TEST);
-		glUseProgram(logAverageShaderProgram);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, HDRColorBuffer);
-
-		glUniform1i(logAveragePassInputTextureLoc, 0);
+			glState.bindTextureUnit(TextureUnitInput, renderGraph.texture(HDRColorBuffer));
 
-		glBindFramebuffer(GL_FRAMEBUFFER, LogAverageFBO);
-		glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
+			glState.bindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+			glState.clearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
 
-		glBindVertexArray(fullscreenMeshVAO);
-		glDrawArrays(GL_TRIANGLES, 0, 3);
+			glState.bindVertexArray(fullscreenMeshVAO);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
 
-		glBindTexture(GL_TEXTURE_2D, LogAverageBuffer);
-		glGenerateMipmap(GL_TEXTURE_2D);
+			glGenerateTextureMipmap(renderGraph.texture(LogAverageBuffer));
 
-		const int level = static_cast<int>(std::log2(std::max(width, height)));
-		float pixel[3];
-		glGetTexImage(GL_TEXTURE_2D, level, GL_RGB, GL_FLOAT, &pixel);
-		float Lnew = std::expf(pixel[0]);
-		Lavg = Lavg + (Lnew - Lavg) * (1 - std::expf(-1 * deltaTime * 1.0));
+			const int level = static_cast<int>(std::log2(std::max(width, height)));
+			float pixel = 0.0f;
+			glGetTextureImage(renderGraph.texture(LogAverageBuffer), level, GL_RED, GL_FLOAT, sizeof(pixel), &pixel);
+			float Lnew = std::expf(pixel);
+			Lavg = Lavg + (Lnew - Lavg) * (1 - std::expf(-1 * deltaTime * 1.0));
 
-		const auto targetEV = ComputeTargetEV(Lavg);
-		const auto EVcomp = -2.0f;
+			const auto targetEV = ComputeTargetEV(Lavg);
+			const auto EVcomp = -2.0f;
 
-		float aperture, shutterSpeed, iso;
-		ApplyProgramAuto(50, targetEV - EVcomp, aperture, shutterSpeed, iso);
+			ApplyProgramAuto(50, targetEV - EVcomp, aperture, shutterSpeed, iso);
+		})
+			.read(HDRColorBuffer, RenderGraphUsageSampled)
+			.write(LogAverageBuffer, RenderGraphUsageColorAttachment)
+			.write(LogAverageBuffer, RenderGraphUsageTransfer)
+			.setSideEffects();
 
-		glBindTexture(GL_TEXTURE_2D, 0);
+		// Postprocess (ftHg̃t[obt@ɏ)
+		renderGraph.addPass("Postprocess", [&](const RenderGraphPass&)
+		{
+			glState.disable(GL_STENCIL_TEST);
 
+			glState.useProgram(postprocessShaderProgram);
+			glUniform1fv(postprocessApertureLoc, 1, &aperture);
+			glUniform1fv(postprocessShutterSpeedLoc, 1, &shutterSpeed);
+			glUniform1fv(postprocessISOLoc, 1, &iso);
 
-		// Postprocess
-		glDisable(GL_STENCIL_TEST);
+			glState.bindTextureUnit(TextureUnitInput, renderGraph.texture(HDRColorBuffer));
 
-		glUseProgram(postprocessShaderProgram);
-		glUniform1fv(postprocessApertureLoc, 1, &aperture);
-		glUniform1fv(postprocessShutterSpeedLoc, 1, &shutterSpeed);
-		glUniform1fv(postprocessISOLoc, 1, &iso);
+			glState.bindFramebuffer(GL_FRAMEBUFFER, 0);
+			glState.bindVertexArray(fullscreenMeshVAO);
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		})
+			.read(HDRColorBuffer, RenderGraphUsageSampled)
+			.setSideEffects();
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, HDRColorBuffer);
+		renderGraph.compile();
+		if (renderGraph.allocationsRecreated())
+		{
+			// 폜ꂽeNX`FBO̖Og񂳂̂ŁAoCh̋L^̂Ă
+			glState.invalidate();
+		}
+		renderGraph.execute();
 
-		glUniform1i(postprocessInputTextureLoc, 0);
 
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		glBindVertexArray(fullscreenMeshVAO);
-		glDrawArrays(GL_TRIANGLES, 0, 3);
+		streamBuffer.endFrame();
+		glState.endFrame();
 
+		if (benchmarkStep >= 0)
+		{
+			benchmarkFrame++;
+			if (benchmarkFrame == benchmarkWarmupFrames)
+			{
+				punctualLightTimer.reset();
+			}
+			else if (benchmarkFrame == benchmarkWarmupFrames + benchmarkFrames)
+			{
+				benchmarkResults[benchmarkStep / LightingPathCount][benchmarkStep % LightingPathCount] = punctualLightTimer.average();
+				benchmarkFrame = 0;
+				benchmarkStep++;
+				if (benchmarkStep == static_cast<int>(benchmarkLightCounts.size() * LightingPathCount))
+				{
+					std::cout << "Punctual lights (GPU ms, average of " << benchmarkFrames << " frames, plus 2 shadowed scene lights)" << std::endl;
+					std::cout << "lights";
+					for (int path = 0; path < LightingPathCount; path++)
+					{
+						std::cout << ", " << lightingPathName(static_cast<LightingPath>(path));
+					}
+					std::cout << std::endl;
+					for (size_t i = 0; i < benchmarkLightCounts.size(); i++)
+					{
+						std::cout << benchmarkLightCounts[i];
+						for (const double result : benchmarkResults[i])
+						{
+							std::cout << ", " << result;
+						}
+						std::cout << std::endl;
+					}
+					benchmarkStep = -1;
+					lightingPath = lightingPathBeforeBenchmark;
+					fillLights.clear();
+				}
+			}
+		}
 
 		glfwSwapBuffers(window);
 
 		glfwPollEvents();
 	}
 
-	glDeleteVertexArrays(1, &vao);
-	glDeleteBuffers(1, &verticesVBO);
-	glDeleteBuffers(1, &uvsVBO);
-	glDeleteBuffers(1, &normalsVBO);
+	streamBuffer.report();
+
+	deleteMesh(monkeyMesh);
+	deleteMesh(floorMesh);
 	glDeleteVertexArrays(1, &fullscreenMeshVAO);
 	glDeleteBuffers(1, &fullscreenMeshVerticesVBO);
 	glDeleteBuffers(1, &fullscreenMeshUVsVBO);
+	glDeleteVertexArrays(1, &sphereVAO);
+	glDeleteBuffers(1, &sphereVerticesVBO);
+	glDeleteBuffers(1, &sphereIndicesIBO);
+	glDeleteVertexArrays(1, &coneVAO);
+	glDeleteBuffers(1, &coneVerticesVBO);
+	glDeleteBuffers(1, &coneIndicesIBO);
 	glDeleteProgram(geometryPassShaderProgram);
 	glDeleteProgram(emissiveAndDirectionalLightPassShaderProgram);
 	glDeleteProgram(postprocessShaderProgram);
-	glDeleteTextures(1, &albedoMap);
-	glDeleteTextures(1, &metallicMap);
-	glDeleteTextures(1, &roughnessMap);
-	glDeleteTextures(1, &normalMap);
-	glDeleteTextures(1, &emissiveMap);
-	glDeleteTextures(1, &GBuffer0ColorBuffer);
-	glDeleteFramebuffers(1, &GBufferFBO);
-	glDeleteTextures(1, &GBuffer1ColorBuffer);
-	glDeleteTextures(1, &GBuffer2ColorBuffer);
-	glDeleteTextures(1, &GBuffer3ColorBuffer);
-	glDeleteTextures(1, &HDRColorBuffer);
-	glDeleteFramebuffers(1, &HDRFBO);
-	glDeleteTextures(1, &LogAverageBuffer);
-	glDeleteFramebuffers(1, &LogAverageFBO);
-	glDeleteTextures(1, &DirectionalShadowMap);
-	glDeleteFramebuffers(1, &DirectionalShadowMapFBO);
-	glDeleteTextures(1, &PointLightShadowMap);
-	glDeleteFramebuffers(1, &PointLightShadowMapFBO);
-	glDeleteTextures(1, &SpotLightShadowMap);
-	glDeleteFramebuffers(1, &SpotLightShadowMapFBO);
 }
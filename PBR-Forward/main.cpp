@@ -1,4 +1,7 @@
 #define GLEW_STATIC
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -9,40 +12,32 @@
 #include <glm.hpp>
 #include <ext.hpp>
 
+#include "ClusteredLights.h"
+#include "LightCulling.h"
+#include "ShaderPreprocessor.h"
+#include "UniformBlocks.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
-
-GLuint createProgram(std::string vertexShaderFile, std::string fragmentShaderFile)
+#define STB_INCLUDE_IMPLEMENTATION
+#define STB_INCLUDE_LINE_GLSL
+#pragma warning(push)
+#pragma warning(disable: 4996) // stb_includestrcpyfopeng
+#include <stb_include.h>
+#pragma warning(pop)
+
+GLuint createProgram(std::string vertexShaderFile, std::string fragmentShaderFile, const ShaderDefines& defines = {})
 {
-	// _VF[_̓ǂݍ
-	std::ifstream vertexIfs(vertexShaderFile, std::ios::binary);
-	if (vertexIfs.fail())
-	{
-		std::cerr << "Error: Can't open source file: " << vertexShaderFile << std::endl;
-		return 0;
-	}
-	auto vertexShaderSource = std::string(std::istreambuf_iterator<char>(vertexIfs), std::istreambuf_iterator<char>());
-	if (vertexIfs.fail())
+	// VF[_̓ǂݍ (#include../Shaders̃t@CœWJ)
+	ShaderPreprocessor preprocessor;
+	const std::string* vertexShaderSource = preprocessor.preprocess(vertexShaderFile, defines);
+	const std::string* fragmentShaderSource = preprocessor.preprocess(fragmentShaderFile, defines);
+	if (vertexShaderSource == nullptr || fragmentShaderSource == nullptr)
 	{
-		std::cerr << "Error: could not read source file: " << vertexShaderFile << std::endl;
 		return 0;
 	}
-	GLchar const* vertexShaderSourcePointer = vertexShaderSource.c_str();
-
-	// tOgVF[_̓ǂݍ
-	std::ifstream fragmentIfs(fragmentShaderFile, std::ios::binary);
-	if (fragmentIfs.fail())
-	{
-		std::cerr << "Error: Can't open source file: " << fragmentShaderFile << std::endl;
-		return 0;
-	}
-	auto fragmentShaderSource = std::string(std::istreambuf_iterator<char>(fragmentIfs), std::istreambuf_iterator<char>());
-	if (fragmentIfs.fail())
-	{
-		std::cerr << "Error: could not read source file: " << fragmentShaderFile << std::endl;
-		return 0;
-	}
-	GLchar const* fragmentShaderSourcePointer = fragmentShaderSource.c_str();
+	GLchar const* vertexShaderSourcePointer = vertexShaderSource->c_str();
+	GLchar const* fragmentShaderSourcePointer = fragmentShaderSource->c_str();
 
 
 	// vOIuWFNg쐬
@@ -109,6 +104,64 @@ GLuint createProgram(std::string vertexShaderFile, std::string fragmentShaderFil
 	return program;
 }
 
+// efǂ̃Xg烉Cgǂނ (TL[Ő؂ւ)
+enum ForwardLightList
+{
+	ForwardLightListObject,    // `悲ƂCPUŃJOCg (LightCulling.h)
+	ForwardLightListClustered, // f̃NX^̃Cg (ClusteredLights.hAx̌oH̃NX^ƓXg)
+	ForwardLightListCount,
+};
+
+const char* forwardLightListName(ForwardLightList list)
+{
+	switch (list)
+	{
+	case ForwardLightListObject:
+		return "per-draw";
+	case ForwardLightListClustered:
+		return "clustered";
+	default:
+		return "";
+	}
+}
+
+// VF[_̃p[~e[Vuniformϐ̏ꏊ
+struct ForwardProgram
+{
+	GLuint program;
+	GLint ModelLoc;
+	GLint ModelITLoc;
+	GLint ModelViewLoc;
+	GLint ProjectionLoc;
+	GLint worldCameraPosLoc;
+	GLint albedoMapLoc;
+	GLint metallicMapLoc;
+	GLint roughnessMapLoc;
+	GLint normalMapLoc;
+	GLint emissiveMapLoc;
+	GLint objectLightOffsetLoc;
+	GLint objectLightCountLoc;
+};
+
+ForwardProgram createForwardProgram(const ShaderDefines& defines)
+{
+	ForwardProgram program = {};
+	program.program = createProgram("shader.vert", "shader.frag", defines);
+	program.ModelLoc = glGetUniformLocation(program.program, "Model");
+	program.ModelITLoc = glGetUniformLocation(program.program, "ModelIT");
+	program.ModelViewLoc = glGetUniformLocation(program.program, "ModelView");
+	program.ProjectionLoc = glGetUniformLocation(program.program, "Projection");
+	program.worldCameraPosLoc = glGetUniformLocation(program.program, "worldCameraPos");
+	program.albedoMapLoc = glGetUniformLocation(program.program, "albedoMap");
+	program.metallicMapLoc = glGetUniformLocation(program.program, "metallicMap");
+	program.roughnessMapLoc = glGetUniformLocation(program.program, "roughnessMap");
+	program.normalMapLoc = glGetUniformLocation(program.program, "normalMap");
+	program.emissiveMapLoc = glGetUniformLocation(program.program, "emissiveMap");
+	program.objectLightOffsetLoc = glGetUniformLocation(program.program, "objectLightOffset");
+	program.objectLightCountLoc = glGetUniformLocation(program.program, "objectLightCount");
+	return program;
+}
+
 std::vector<std::string> splitString(const std::string& s, char delim)
 {
 	std::vector<std::string> elems(0);
@@ -304,7 +357,9 @@ int main() {
 	glCullFace(GL_BACK);
 	glEnable(GL_CULL_FACE);
 
-	const GLuint program = createProgram("shader.vert", "shader.frag");
+	std::array<ForwardProgram, ForwardLightListCount> programs;
+	programs[ForwardLightListObject] = createForwardProgram({});
+	programs[ForwardLightListClustered] = createForwardProgram({ { "CLUSTERED_LIGHTS", "1" } });
 
 	std::vector<glm::vec3> vertices;
 	std::vector<glm::vec2> uvs;
@@ -315,6 +370,7 @@ int main() {
 		std::cerr << "Can't load obj file: testMonkey.obj" << std::endl;
 		return 1;
 	}
+	const glm::vec4 monkeyBounds = boundingSphere(vertices);
 
 	// VAO̍쐬ƃoCh
 	GLuint vao;
@@ -357,47 +413,145 @@ int main() {
 	GLuint normalMap = loadTexture("normal.tga");
 	GLuint emissiveMap = loadTexture("emissive.tga", true);
 
-	// uniformϐ̏ꏊ擾
-	const GLuint ModelLoc = glGetUniformLocation(program, "Model");
-	const GLuint ModelITLoc = glGetUniformLocation(program, "ModelIT");
-	const GLuint ModelViewLoc = glGetUniformLocation(program, "ModelView");
-	const GLuint ProjectionLoc = glGetUniformLocation(program, "Projection");
-
-	const GLuint worldCameraPosLoc = glGetUniformLocation(program, "worldCameraPos");
-
-	const GLuint albedoMapLoc = glGetUniformLocation(program, "albedoMap");
-	const GLuint metallicMapLoc = glGetUniformLocation(program, "metallicMap");
-	const GLuint roughnessMapLoc = glGetUniformLocation(program, "roughnessMap");
-	const GLuint normalMapLoc = glGetUniformLocation(program, "normalMap");
-	const GLuint emissiveMapLoc = glGetUniformLocation(program, "emissiveMap");
+	// Cg (Ɣ͈͎͂sɌ߂SSBOœn)
+	std::vector<PunctualLight> lights;
+	PunctualLight light = {};
+	light.type = PunctualLightPoint;
+	light.shadowMap = PunctualLightShadowNone;
+	light.range = 20.0f;
+	light.position = glm::vec3(0.0f, 0.0f, 3.0f);
+	light.intensity = 50000.0f; // lm
+	light.color = glm::vec3(1.0f, 1.0f, 0.8f);
+	lights.push_back(light);
+	light.position = glm::vec3(2.0f, 0.0f, 2.0f);
+	light.intensity = 30000.0f; // lm
+	light.color = glm::vec3(0.8f, 1.0f, 1.0f);
+	lights.push_back(light);
+
+	GLuint lightsSSBO;
+	glGenBuffers(1, &lightsSSBO);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, lightsSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(lights.size(), 1) * sizeof(PunctualLight), lights.data(), GL_STATIC_DRAW);
+
+	// SĂ̕`ɂāAEƔ͈͂dȂ郉Cg̔ԍ1̔zɋl߁At[1񑗂
+	// e`͔z͈̒̎̔ (lightOffset, lightCount) ǂ
+	struct ForwardDraw
+	{
+		glm::mat4 Model;
+		uint32_t lightOffset;
+		uint32_t lightCount;
+	};
+	std::vector<ForwardDraw> draws;
+	std::vector<uint32_t> objectLightIndices;
+	size_t objectLightCapacity = 64;
+	GLuint objectLightsSSBO;
+	glGenBuffers(1, &objectLightsSSBO);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectLightsSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, objectLightCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+
+	// NX^Ƃ̃Cg̃Xg (x̌oHƓr[Ԃ̋ECPUŊ蓖Ă)
+	ThreadPool threadPool;
+	ClusteredLights clusteredLights(16, 12, 24);
+	std::vector<glm::vec4> clusterSpheres;
+	const GLsizeiptr clusterGridSize = sizeof(ClusterGridHeader) + clusteredLights.clusters().size() * sizeof(ClusterRange);
+	GLuint clusterGridSSBO;
+	glGenBuffers(1, &clusterGridSSBO);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterGridSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, clusterGridSize, nullptr, GL_DYNAMIC_DRAW);
+	size_t clusterLightCapacity = 1024;
+	GLuint clusterLightsSSBO;
+	glGenBuffers(1, &clusterLightsSSBO);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterLightsSSBO);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, clusterLightCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+
+	ForwardLightList lightList = ForwardLightListObject;
+	bool toggleKeyDown = false;
 
 	glfwSetTime(0.0);
 
 	while (glfwWindowShouldClose(window) == GL_FALSE) {
+		// TL[ŃCg̃Xg؂ւ
+		const bool toggleKey = glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS;
+		if (toggleKey && !toggleKeyDown)
+		{
+			lightList = static_cast<ForwardLightList>((lightList + 1) % ForwardLightListCount);
+			std::cout << "Light list: " << forwardLightListName(lightList) << std::endl;
+		}
+		toggleKeyDown = toggleKey;
+
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		glUseProgram(program);
+		const ForwardProgram& program = programs[lightList];
+		glUseProgram(program.program);
 
 		auto cameraPos = glm::vec3(0, 0, 5);
 
-		glm::mat4 Model = glm::rotate(glm::mat4(1), static_cast<float>(glfwGetTime()), glm::vec3(0, 1, 0));
-		glm::mat4 ModelIT = glm::inverseTranspose(Model);
+		const float near = 1.0f;
+		const float far = 10.0f;
 		glm::mat4 View = glm::lookAt(cameraPos, glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
-		glm::mat4 ModelView = View * Model;
-		glm::mat4 Projection = glm::perspective(glm::radians(45.0f), 640.f / 480.f, 1.f, 10.f);
+		glm::mat4 Projection = glm::perspective(glm::radians(45.0f), 640.f / 480.f, near, far);
+
+		glUniformMatrix4fv(program.ProjectionLoc, 1, GL_FALSE, &Projection[0][0]);
 
-		glUniformMatrix4fv(ModelLoc, 1, GL_FALSE, &Model[0][0]);
-		glUniformMatrix4fv(ModelITLoc, 1, GL_FALSE, &ModelIT[0][0]);
-		glUniformMatrix4fv(ModelViewLoc, 1, GL_FALSE, &ModelView[0][0]);
-		glUniformMatrix4fv(ProjectionLoc, 1, GL_FALSE, &Projection[0][0]);
+		glUniform3fv(program.worldCameraPosLoc, 1, &cameraPos[0]);
 
-		glUniform3fv(worldCameraPosLoc, 1, &cameraPos[0]);
+		draws.clear();
+		draws.push_back({ glm::rotate(glm::mat4(1), static_cast<float>(glfwGetTime()), glm::vec3(0, 1, 0)), 0, 0 });
 
-		glUniform1i(albedoMapLoc, 0);
-		glUniform1i(metallicMapLoc, 1);
-		glUniform1i(roughnessMapLoc, 2);
-		glUniform1i(normalMapLoc, 3);
-		glUniform1i(emissiveMapLoc, 4);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, StorageBindingLights, lightsSSBO);
+		if (lightList == ForwardLightListClustered)
+		{
+			// r[Ԃ̋EŃNX^Ɋ蓖āAObhƔԍ̔z𑗂
+			int width, height;
+			glfwGetFramebufferSize(window, &width, &height);
+			clusterSpheres.clear();
+			for (const auto& light : lights)
+			{
+				const glm::vec4 sphere = lightBoundingSphere(light);
+				clusterSpheres.push_back(glm::vec4(glm::vec3(View * glm::vec4(glm::vec3(sphere), 1.0f)), sphere.w));
+			}
+			clusteredLights.setProjection(Projection, near, far, static_cast<float>(width), static_cast<float>(height));
+			clusteredLights.assign(clusterSpheres, &threadPool);
+
+			const auto& clusters = clusteredLights.clusters();
+			const auto& indices = clusteredLights.indices();
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterGridSSBO);
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(ClusterGridHeader), &clusteredLights.header());
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(ClusterGridHeader), clusters.size() * sizeof(ClusterRange), clusters.data());
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, clusterLightsSSBO);
+			if (indices.size() > clusterLightCapacity)
+			{
+				clusterLightCapacity = std::max(indices.size(), clusterLightCapacity * 2);
+				glBufferData(GL_SHADER_STORAGE_BUFFER, clusterLightCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+			}
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, indices.size() * sizeof(uint32_t), indices.data());
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, StorageBindingClusterGrid, clusterGridSSBO);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, StorageBindingClusterLightIndices, clusterLightsSSBO);
+		}
+		else
+		{
+			// Cg̃JO (SĂ̕`̕l߂Ă1ő)
+			objectLightIndices.clear();
+			for (auto& draw : draws)
+			{
+				draw.lightOffset = static_cast<uint32_t>(objectLightIndices.size());
+				draw.lightCount = cullLights(lights, transformBoundingSphere(draw.Model, monkeyBounds), objectLightIndices);
+			}
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, objectLightsSSBO);
+			if (objectLightIndices.size() > objectLightCapacity)
+			{
+				objectLightCapacity = std::max(objectLightIndices.size(), objectLightCapacity * 2);
+				glBufferData(GL_SHADER_STORAGE_BUFFER, objectLightCapacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+			}
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, objectLightIndices.size() * sizeof(uint32_t), objectLightIndices.data());
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, StorageBindingObjectLights, objectLightsSSBO);
+		}
+
+		glUniform1i(program.albedoMapLoc, 0);
+		glUniform1i(program.metallicMapLoc, 1);
+		glUniform1i(program.roughnessMapLoc, 2);
+		glUniform1i(program.normalMapLoc, 3);
+		glUniform1i(program.emissiveMapLoc, 4);
 
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, albedoMap);
@@ -411,7 +565,18 @@ int main() {
 		glBindTexture(GL_TEXTURE_2D, emissiveMap);
 
 		glBindVertexArray(vao);
-		glDrawArrays(GL_TRIANGLES, 0, vertices.size());
+		for (const auto& draw : draws)
+		{
+			const glm::mat4 ModelIT = glm::inverseTranspose(draw.Model);
+			const glm::mat4 ModelView = View * draw.Model;
+			glUniformMatrix4fv(program.ModelLoc, 1, GL_FALSE, &draw.Model[0][0]);
+			glUniformMatrix4fv(program.ModelITLoc, 1, GL_FALSE, &ModelIT[0][0]);
+			glUniformMatrix4fv(program.ModelViewLoc, 1, GL_FALSE, &ModelView[0][0]);
+			// NX^̃p[~e[Vɂ͖uniformȂ̂ŁAꏊ-1Ŗ
+			glUniform1ui(program.objectLightOffsetLoc, draw.lightOffset);
+			glUniform1ui(program.objectLightCountLoc, draw.lightCount);
+			glDrawArrays(GL_TRIANGLES, 0, vertices.size());
+		}
 
 		glfwSwapBuffers(window);
 
@@ -422,7 +587,14 @@ int main() {
 	glDeleteBuffers(1, &verticesVBO);
 	glDeleteBuffers(1, &uvsVBO);
 	glDeleteBuffers(1, &normalsVBO);
-	glDeleteProgram(program);
+	glDeleteBuffers(1, &lightsSSBO);
+	glDeleteBuffers(1, &objectLightsSSBO);
+	glDeleteBuffers(1, &clusterGridSSBO);
+	glDeleteBuffers(1, &clusterLightsSSBO);
+	for (const auto& program : programs)
+	{
+		glDeleteProgram(program.program);
+	}
 	glDeleteTextures(1, &albedoMap);
 	glDeleteTextures(1, &metallicMap);
 	glDeleteTextures(1, &roughnessMap);
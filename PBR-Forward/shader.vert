@@ -14,6 +14,7 @@ out vec3 vWorldNormal;
 out vec3 vWorldTangent;
 out vec4 vWorldPos;
 out vec2 vUv;
+out float vViewDistance; // positive view-space depth, for the cluster lookup
 
 void main()
 {
@@ -21,6 +22,7 @@ void main()
   vWorldTangent = mat3(ModelIT) * tangent;
   vWorldPos = Model * position;
   vUv = uv;
+  vViewDistance = -(ModelView * position).z;
 
   gl_Position = Projection * ModelView * position;
 }
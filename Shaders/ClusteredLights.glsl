@@ -0,0 +1,30 @@
+#ifndef CLUSTERED_LIGHTS_GLSL
+#define CLUSTERED_LIGHTS_GLSL
+
+// ##################
+// Per-cluster light lists built on the CPU by ClusteredLights.h
+// Clusters are screen tiles split into exponential depth slices between near and far
+// Bound to StorageBindingClusterGrid and StorageBindingClusterLightIndices
+// ##################
+layout (std430, binding = 2) readonly buffer ClusterGrid
+{
+  uvec4 clusterCount;  // xyz: number of clusters
+  vec4 clusterParams;  // x: countX / width, y: countY / height, z: countZ / log(far / near), w: near
+  uvec2 clusterLights[]; // x: offset into clusterLightIndices, y: count
+};
+
+layout (std430, binding = 3) readonly buffer ClusterLightIndices
+{
+  uint clusterLightIndices[];
+};
+
+// viewDistance: positive view-space depth of the shaded point
+uint ClusterIndex(vec2 fragCoord, float viewDistance)
+{
+  uvec2 tile = min(uvec2(fragCoord * clusterParams.xy), clusterCount.xy - 1u);
+  float slice = log(max(viewDistance, clusterParams.w) / clusterParams.w) * clusterParams.z;
+  uint z = min(uint(slice), clusterCount.z - 1u);
+  return (z * clusterCount.y + tile.y) * clusterCount.x + tile.x;
+}
+
+#endif
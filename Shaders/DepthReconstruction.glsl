@@ -0,0 +1,26 @@
+#ifndef DEPTH_RECONSTRUCTION_GLSL
+#define DEPTH_RECONSTRUCTION_GLSL
+
+#include "FrameUniforms.glsl"
+
+// ##################
+// world pos from depth texture
+// ##################
+float DecodeDepth(float d)
+{
+  return -d * (ProjectionParams.y - ProjectionParams.x) - ProjectionParams.x;
+}
+
+vec3 worldPosFromDepth(float d, vec2 uv)
+{
+  float depth = DecodeDepth(d);
+  float m22 = -(ProjectionParams.y + ProjectionParams.x) / (ProjectionParams.y - ProjectionParams.x);
+  float m23 = -2.0 * ProjectionParams.y * ProjectionParams.x / (ProjectionParams.y - ProjectionParams.x);
+  float z = depth * m22 + m23;
+  float w = -depth;
+  vec4 projectedPos = vec4(uv.x * 2.0 - 1.0, uv.y * 2.0 - 1.0, z / w, 1.0);
+  vec4 worldPos = ViewProjectionI * projectedPos;
+  return worldPos.xyz / worldPos.w;
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef DISNEY_BRDF_GLSL
+#define DISNEY_BRDF_GLSL
+
+#include "Math.glsl"
+
+// Material feature bits, must match MaterialFeatures.h
+#define BRDF_FEATURE_SUBSURFACE 1
+#define BRDF_FEATURE_SHEEN 2
+#define BRDF_FEATURE_CLEARCOAT 4
+#define BRDF_FEATURE_ANISOTROPIC 8
+#define BRDF_FEATURE_SPECULAR_TINT 16
+
+// Permutations define BRDF_FEATURES to strip the lobes the material does not use.
+// Without it every lobe is evaluated.
+#ifndef BRDF_FEATURES
+#define BRDF_FEATURES 31
+#endif
+
+// ##################
+// Disney BRDF
+// ##################
+float SchlickFresnel(float cosTheta)
+{
+  return pow(clamp((1 - cosTheta), 0, 1), 5.0);
+}
+
+float D_GTR1(float NdotH, float a)
+{
+  float a2 = a * a;
+  float tmp = 1 + (a2 - 1) * NdotH * NdotH;
+  return (a2 - 1) / (PI * log(a2) * tmp);
+}
+
+float D_GTR2(float NdotH, float a)
+{
+  float a2 = a * a;
+  float tmp = 1 + (a2 - 1) * NdotH * NdotH;
+  return a2 / (PI * tmp * tmp);
+}
+
+float D_GTR2aniso(float NdotH, float HdotX, float HdotY, float ax, float ay)
+{
+  float tmp = (HdotX * HdotX) / (ax * ax) + (HdotY * HdotY) / (ay * ay) + NdotH * NdotH;
+  return 1 / (PI * ax * ay * tmp * tmp);
+}
+
+float G_GGX(float NdotV, float a)
+{
+  float a2 = a * a;
+  float down = NdotV + sqrt(a2 + NdotV * NdotV - a2 * NdotV * NdotV);
+  return 1 / down;
+}
+
+float G_GGXaniso(float NdotV, float VdotX, float VdotY, float ax, float ay)
+{
+  float tmp = VdotX * VdotX * ax * ax + VdotY * VdotY * ay * ay + NdotV * NdotV;
+  float down = NdotV + sqrt(tmp);
+  return 1 / down;
+}
+
+vec3 DisneyBRDF(vec3 L, vec3 V, vec3 N, vec3 H, vec3 X, vec3 Y, vec3 baseColor, float subsurface, float metallic, float specular, float specularTint, float roughness, float anisotropic, float sheen, float sheenTint, float clearcoat, float clearcoatGloss)
+{
+  float NdotL = dot(N, L);
+  float NdotV = dot(N, V);
+  if (NdotL < 0 || NdotV < 0) return vec3(0);
+
+  float NdotH = dot(N, H);
+  float LdotH = dot(L, H);
+
+#if (BRDF_FEATURES & (BRDF_FEATURE_SHEEN | BRDF_FEATURE_SPECULAR_TINT))
+  float luminance = 0.3 * baseColor.r + 0.6 * baseColor.g + 0.1 * baseColor.b;
+  vec3 C_tint = luminance > 0 ? baseColor / luminance : vec3(1);
+#endif
+#if (BRDF_FEATURES & BRDF_FEATURE_SPECULAR_TINT)
+  vec3 C_spec = mix(specular * 0.08 * mix(vec3(1), C_tint, specularTint), baseColor, metallic);
+#else
+  vec3 C_spec = mix(vec3(specular * 0.08), baseColor, metallic);
+#endif
+
+  // diffuse
+  float F_i = SchlickFresnel(NdotL);
+  float F_o = SchlickFresnel(NdotV);
+  float F_d90 = 0.5 + 2 * LdotH * LdotH * roughness;
+  float F_d = mix(1.0, F_d90, F_i) * mix(1.0, F_d90, F_o);
+
+#if (BRDF_FEATURES & BRDF_FEATURE_SUBSURFACE)
+  float F_ss90 = LdotH * LdotH * roughness;
+  float F_ss = mix(1.0, F_ss90, F_i) * mix(1.0, F_ss90, F_o);
+  float ss = 1.25 * (F_ss * (1 / (NdotL + NdotV) - 0.5) + 0.5);
+  float diffuse = mix(F_d, ss, subsurface);
+#else
+  float diffuse = F_d;
+#endif
+
+  float FH = SchlickFresnel(LdotH);
+
+#if (BRDF_FEATURES & BRDF_FEATURE_SHEEN)
+  vec3 C_sheen = mix(vec3(1), C_tint, sheenTint);
+  vec3 F_sheen = FH * sheen * C_sheen;
+  vec3 BRDFdiffuse = ((1 / PI) * diffuse * baseColor + F_sheen) * (1 - metallic);
+#else
+  vec3 BRDFdiffuse = (1 / PI) * diffuse * baseColor * (1 - metallic);
+#endif
+
+  // specular
+#if (BRDF_FEATURES & BRDF_FEATURE_ANISOTROPIC)
+  float aspect = sqrt(1 - anisotropic * 0.9);
+  float roughness2 = roughness * roughness;
+  float a_x = max(0.001, roughness2 / aspect);
+  float a_y = max(0.001, roughness2 * aspect);
+  float D_s = D_GTR2aniso(NdotH, dot(H, X), dot(H, Y), a_x, a_y);
+  float G_s = G_GGXaniso(NdotL, dot(L, X), dot(L, Y), a_x, a_y) * G_GGXaniso(NdotV, dot(V, X), dot(V, Y), a_x, a_y);
+#else
+  // X and Y are orthonormal to N, so the anisotropic terms reduce to these when a_x == a_y
+  float a = max(0.001, roughness * roughness);
+  float D_s = D_GTR2(NdotH, a);
+  float G_s = G_GGX(NdotL, a) * G_GGX(NdotV, a);
+#endif
+  vec3 F_s = mix(C_spec, vec3(1), FH);
+
+  vec3 BRDFspecular = G_s * F_s * D_s;
+
+#if (BRDF_FEATURES & BRDF_FEATURE_CLEARCOAT)
+  // clearcoat
+  float D_r = D_GTR1(NdotH, mix(0.1, 0.001, clearcoatGloss));
+  float F_r = mix(0.04, 1.0, FH);
+  float G_r = G_GGX(NdotL, 0.25) * G_GGX(NdotV, 0.25);
+
+  vec3 BRDFclearcoat = vec3(0.25 * clearcoat * G_r * F_r * D_r);
+
+  return BRDFdiffuse + BRDFspecular + BRDFclearcoat;
+#else
+  return BRDFdiffuse + BRDFspecular;
+#endif
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef DISNEY_MATERIAL_GLSL
+#define DISNEY_MATERIAL_GLSL
+
+// ##################
+// Disney BRDF parameters not stored in the G-buffer
+// Shared by every pixel; the lobes they enable are selected with BRDF_FEATURES
+// ##################
+uniform float subsurface = 0.0;
+uniform float specular = 0.5;
+uniform float specularTint = 0.0;
+uniform float anisotropic = 0.0;
+uniform float sheen = 0.0;
+uniform float sheenTint = 0.5;
+uniform float clearcoat = 0.0;
+uniform float clearcoatGloss = 1.0;
+
+#endif
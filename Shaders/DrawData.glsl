@@ -0,0 +1,24 @@
+#ifndef DRAW_DATA_GLSL
+#define DRAW_DATA_GLSL
+
+// ##################
+// Per-draw data streamed through a persistently mapped ring buffer
+// Each draw passes its index as the base instance, so read it with draws[gl_BaseInstance]
+// in the vertex shader and forward what later stages need as flat varyings
+// Layout must match DrawData in UniformBlocks.h
+// ##################
+struct DrawData
+{
+  mat4 Model;
+  mat4 ModelIT;
+  mat4 ModelView;
+  mat4 ModelViewProjection;
+  vec4 params; // x: emissive intensity
+};
+
+layout (std430, binding = 0) readonly buffer DrawDataBuffer
+{
+  DrawData draws[];
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef EXPOSURE_GLSL
+#define EXPOSURE_GLSL
+
+// ###############
+// Physically Based Camera Exposure
+// ###############
+float SaturationBasedExposure(float aperture, float shutterSpeed, float iso)
+{
+    float l_max = (7800.0f / 65.0f) * (aperture * aperture) / (iso * shutterSpeed);
+    return 1.0f / l_max;
+}
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef FRAME_UNIFORMS_GLSL
+#define FRAME_UNIFORMS_GLSL
+
+// ##################
+// Per-frame camera constants, uploaded once per frame
+// Layout must match FrameUniforms in UniformBlocks.h
+// ##################
+layout (std140, binding = 0) uniform FrameUniforms
+{
+  mat4 View;
+  mat4 Projection;
+  mat4 ViewProjection;
+  mat4 ViewProjectionI;
+  vec3 worldCameraPos;
+  vec2 ProjectionParams; // x: near, y: far
+  vec2 resolution;
+};
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef GBUFFER_GLSL
+#define GBUFFER_GLSL
+
+// ##################
+// G-buffer samplers, bound to units 0-3 (TextureUnitGBuffer0.. in UniformBlocks.h)
+// ##################
+layout (binding = 0) uniform sampler2D GBuffer0; // rgb: albedo, a: ambient occlusion
+layout (binding = 1) uniform sampler2D GBuffer1; // rgb: world normal, a: metallic
+layout (binding = 2) uniform sampler2D GBuffer2; // rgb: world tangent, a: roughness
+layout (binding = 3) uniform sampler2D GBuffer3; // rgb: emissive, a: depth
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef LIGHT_ATTENUATION_GLSL
+#define LIGHT_ATTENUATION_GLSL
+
+// ##################
+// attenuation
+// ##################
+float DistanceAttenuation(float distance, float range)
+{
+  float EPSILON = 0.01;
+  float att = 1.0 / (distance * distance + EPSILON);
+  float smoothatt = 1 - pow(distance / range, 4.0);
+  smoothatt = max(smoothatt, 0.0);
+  smoothatt =  smoothatt * smoothatt;
+  return att * smoothatt;
+}
+
+// cosOuter / cosInner: cosines of the half angles where the cone ends and starts to fade
+float SpotAngleAttenuation(vec3 L, vec3 direction, float cosOuter, float cosInner)
+{
+  float cos_s = dot(-L, direction);
+  float t = (cos_s - cosOuter) / (cosInner - cosOuter);
+  t = clamp(t, 0, 1);
+  return t * t;
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef PUNCTUAL_LIGHT_SHADING_GLSL
+#define PUNCTUAL_LIGHT_SHADING_GLSL
+
+// ##################
+// Shading of the PunctualLight records in PunctualLightBuffer, shared by the passes
+// that read every light from the storage buffer (TiledLightingPass.comp, LightVolumePass.frag)
+// ##################
+#include "PunctualLights.glsl"
+#include "DisneyBRDF.glsl"
+#include "DisneyMaterial.glsl"
+
+// Layout must match PunctualLightingUniforms in UniformBlocks.h
+layout (std140, binding = 1) uniform PunctualLightingUniforms
+{
+  mat4 SpotLightViewProjection; // the light with PUNCTUAL_LIGHT_SHADOW_SPOT
+  uint lightCount;
+};
+
+// TextureUnitShadowMap and TextureUnitSpotShadowMap
+layout (binding = 4) uniform samplerCubeShadow PointLightShadowMap;
+layout (binding = 5) uniform sampler2DShadow SpotLightShadowMap;
+
+
+// ##################
+// shadow
+// ##################
+float PointLightShadowAttenuation(PunctualLight light, vec3 worldPos)
+{
+  vec3 lightToFragVec = worldPos - light.position;
+  float depth = length(lightToFragVec) / light.range;
+  return texture(PointLightShadowMap, vec4(lightToFragVec, depth - light.shadowBias)).x;
+}
+
+// 3x3 PCF, same as SpotLightPass.frag
+float SpotLightShadowAttenuation(vec3 worldPos)
+{
+  vec4 lightPos = SpotLightViewProjection * vec4(worldPos, 1.0);
+  vec2 uv = lightPos.xy / lightPos.w * vec2(0.5) + vec2(0.5);
+  float depthFromWorldPos = (lightPos.z / lightPos.w) * 0.5 + 0.5;
+
+  ivec2 shadowMapSize = textureSize(SpotLightShadowMap, 0);
+  vec2 offset = 1.0 / shadowMapSize.xy;
+
+  float shadow = 0.0;
+  for (int i = -1; i <= 1; i++)
+  {
+    for (int j = -1; j <= 1; j++)
+    {
+      vec3 UVC = vec3(uv + offset * vec2(i, j), depthFromWorldPos + 0.00001);
+      shadow += texture(SpotLightShadowMap, UVC).x;
+    }
+  }
+  return shadow / 9.0;
+}
+
+float ShadowAttenuation(PunctualLight light, vec3 worldPos)
+{
+  if (light.shadowMap == PUNCTUAL_LIGHT_SHADOW_CUBE)
+  {
+    return PointLightShadowAttenuation(light, worldPos);
+  }
+  if (light.shadowMap == PUNCTUAL_LIGHT_SHADOW_SPOT)
+  {
+    return SpotLightShadowAttenuation(worldPos);
+  }
+  return 1.0;
+}
+
+
+// ##################
+// shading
+// ##################
+// Same irradiance as PointLightPass.frag and SpotLightPass.frag
+vec3 LightRadiance(PunctualLight light, vec3 worldPos, vec3 V, vec3 N, vec3 tangent, vec3 bitangent, vec3 albedo, float metallic, float roughness)
+{
+  vec3 L;
+  vec3 irradiance;
+  if (!PunctualLightIrradiance(light, worldPos, N, L, irradiance))
+  {
+    return vec3(0);
+  }
+  irradiance *= ShadowAttenuation(light, worldPos);
+
+  vec3 H = normalize(L + V);
+  return DisneyBRDF(L, V, N, H, tangent, bitangent, albedo, subsurface, metallic, specular, specularTint, roughness, anisotropic, sheen, sheenTint, clearcoat, clearcoatGloss) * irradiance;
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef PUNCTUAL_LIGHTS_GLSL
+#define PUNCTUAL_LIGHTS_GLSL
+
+// ##################
+// Point and spot lights read from a storage buffer, bound to StorageBindingLights
+// Layout must match PunctualLight in UniformBlocks.h
+// ##################
+#include "Math.glsl"
+#include "LightAttenuation.glsl"
+
+#define PUNCTUAL_LIGHT_POINT 0
+#define PUNCTUAL_LIGHT_SPOT 1
+
+#define PUNCTUAL_LIGHT_SHADOW_NONE 0
+#define PUNCTUAL_LIGHT_SHADOW_CUBE 1 // point light cube shadow map
+#define PUNCTUAL_LIGHT_SHADOW_SPOT 2 // spot light 2D shadow map
+
+struct PunctualLight
+{
+  vec3 position;
+  float range;
+  vec3 color;
+  float intensity; // lm
+  vec3 direction;  // normalized, spot only
+  float cosOuterAngle;
+  float cosInnerAngle;
+  uint type;
+  uint shadowMap;
+  float shadowBias;
+};
+
+layout (std430, binding = 1) readonly buffer PunctualLightBuffer
+{
+  PunctualLight lights[];
+};
+
+// Unshadowed irradiance from the light at worldPos on a surface facing N, shared by the
+// forward and deferred paths (shadows are applied by PunctualLightShading.glsl)
+// Returns false when the point is outside the light's range or cone or faces away from it
+bool PunctualLightIrradiance(PunctualLight light, vec3 worldPos, vec3 N, out vec3 L, out vec3 irradiance)
+{
+  vec3 toLight = light.position - worldPos;
+  float distance = length(toLight);
+  L = toLight / distance;
+  irradiance = vec3(0);
+  if (distance >= light.range)
+  {
+    return false;
+  }
+
+  float attenuation = max(0, dot(L, N)) * DistanceAttenuation(distance, light.range);
+  if (light.type == PUNCTUAL_LIGHT_SPOT)
+  {
+    attenuation *= 1.0 / PI * SpotAngleAttenuation(L, light.direction, light.cosOuterAngle, light.cosInnerAngle);
+  }
+  else
+  {
+    attenuation *= 1.0 / (4.0 * PI);
+  }
+  if (attenuation <= 0.0)
+  {
+    return false;
+  }
+  irradiance = light.intensity * light.color * attenuation;
+  return true;
+}
+
+#endif
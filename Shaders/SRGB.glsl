@@ -0,0 +1,28 @@
+#ifndef SRGB_GLSL
+#define SRGB_GLSL
+
+// #####################
+// gamma correction
+// #####################
+const float  SCALE_0= 1.0/12.92;
+const float  SCALE_1= 1.0/1.055;
+const float  OFFSET_1= 0.055 * SCALE_1;
+
+float LinearToSRGB_F( float color )
+{
+    color= clamp( color, 0.0, 1.0 );
+    if( color < 0.0031308 ){
+        return  color * 12.92;
+    }
+    return  1.055 * pow( color, 0.41666 ) - 0.055;
+}
+
+vec3 LinearToSRGB( vec3 color )
+{
+    return  vec3(
+        LinearToSRGB_F( color.x ),
+        LinearToSRGB_F( color.y ),
+        LinearToSRGB_F( color.z ) );
+}
+
+#endif